@@ -0,0 +1,80 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "GameplayScene/ContactDispatcher.h"
+
+ContactDispatcher* ContactDispatcher::_self;
+
+ContactDispatcher*
+ContactDispatcher::getInstance()
+{
+    if (!_self) {
+        _self = new (std::nothrow) ContactDispatcher();
+    }
+    return _self;
+}
+
+void
+ContactDispatcher::put(ContactTable<ContactHandler>& table, int categoryA, int categoryB,
+                       const ContactHandler& handler)
+{
+    if (!table.put(categoryA, categoryB, handler)) {
+        log("[ContactDispatcher] category 0x%x, 0x%x is not a single bit", categoryA, categoryB);
+    }
+}
+
+void
+ContactDispatcher::onBegin(int categoryA, int categoryB, const ContactHandler& handler)
+{
+    put(beginTable, categoryA, categoryB, handler);
+}
+
+void
+ContactDispatcher::onSeparate(int categoryA, int categoryB, const ContactHandler& handler)
+{
+    put(separateTable, categoryA, categoryB, handler);
+}
+
+bool
+ContactDispatcher::dispatch(const ContactTable<ContactHandler>& table, PhysicsContact& contact)
+{
+    auto shapeA = contact.getShapeA();
+    auto shapeB = contact.getShapeB();
+    bool swapped = false;
+    const ContactHandler* handler =
+        table.find(shapeA->getCategoryBitmask(), shapeB->getCategoryBitmask(), swapped);
+    if (nullptr == handler || !*handler) {
+        return true;
+    }
+
+    auto nodeA = shapeA->getBody()->getNode();
+    auto nodeB = shapeB->getBody()->getNode();
+    if (nullptr == nodeA || nullptr == nodeB) {
+        return true;
+    }
+
+    if (swapped) {
+        return (*handler)(ContactPair{ contact, shapeB, shapeA, nodeB, nodeA });
+    }
+    return (*handler)(ContactPair{ contact, shapeA, shapeB, nodeA, nodeB });
+}
+
+bool
+ContactDispatcher::contactBegin(PhysicsContact& contact)
+{
+    return dispatch(beginTable, contact);
+}
+
+void
+ContactDispatcher::contactSeparate(PhysicsContact& contact)
+{
+    dispatch(separateTable, contact);
+}
+
+void
+ContactDispatcher::reset()
+{
+    beginTable.clear();
+    separateTable.clear();
+}
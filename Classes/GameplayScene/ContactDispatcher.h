@@ -0,0 +1,65 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef CONTACT_DISPATCHER_H
+#define CONTACT_DISPATCHER_H
+
+#include "GameplayScene/ContactTable.h"
+#include "cocos2d.h"
+
+#include <functional>
+
+USING_NS_CC;
+
+/* 一次接触的双方，已按登记时的种别顺序排好，nodeA 的种别即登记的 categoryA */
+struct ContactPair
+{
+    const PhysicsContact& contact;
+    PhysicsShape* shapeA;
+    PhysicsShape* shapeB;
+    Node* nodeA;
+    Node* nodeB;
+};
+
+/* 返回值与 EventListenerPhysicsContact::onContactBegin 相同，false 时本次接触不产生碰撞 */
+typedef std::function<bool(const ContactPair&)> ContactHandler;
+
+/* 物理接触的分派表：单例
+ *
+ *  + 以双方形状的种别掩码（见 common.h）在 ContactTable 中查表，每次接触只查一次表、
+ *    调用一次处理函数，不再逐个比较节点的 tag
+ *  + 处理函数按（categoryA, categoryB）登记，对调的一格同时指向它，调用时双方已按登记顺序排好
+ *  + 敌人、电梯、事件点等各自登记自己关心的接触，GameplayScene 只负责把监听器接到这里
+ *  + 种别掩码不是单独一位（如未设置时的 0xFFFFFFFF）或未登记的接触按默认处理，返回 true
+ *  + 切换场景时由 reset 清空，处理函数可捕获场景中的对象
+ */
+class ContactDispatcher
+{
+public:
+    static ContactDispatcher* getInstance();
+
+    /* 登记接触开始、分离时的处理函数，同一对种别重复登记时覆盖 */
+    void onBegin(int categoryA, int categoryB, const ContactHandler& handler);
+    void onSeparate(int categoryA, int categoryB, const ContactHandler& handler);
+
+    /* 接到 EventListenerPhysicsContact 上 */
+    bool contactBegin(PhysicsContact& contact);
+    void contactSeparate(PhysicsContact& contact);
+
+    void reset();
+
+private:
+    ContactDispatcher() {}
+    static ContactDispatcher* _self;
+
+    static void put(ContactTable<ContactHandler>& table, int categoryA, int categoryB,
+                    const ContactHandler& handler);
+    static bool dispatch(const ContactTable<ContactHandler>& table, PhysicsContact& contact);
+
+private:
+    ContactTable<ContactHandler> beginTable;
+    ContactTable<ContactHandler> separateTable;
+};
+
+#endif // CONTACT_DISPATCHER_H
@@ -0,0 +1,87 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef CONTACT_TABLE_H
+#define CONTACT_TABLE_H
+
+// 种别掩码的位数，common.h 中的掩码都是其中的一位
+#define CONTACT_CATEGORY_COUNT 8
+
+/* 按一对种别掩码查找处理函数的表，ContactDispatcher 的开始、分离各用一张
+ *
+ *  + 以双方种别掩码的位序号为下标，查一次即得，不再逐个比较
+ *  + 按（categoryA, categoryB）登记，对调的一格同时指向它并标记 swapped，
+ *    调用者据此把双方排成登记时的顺序
+ *  + 种别掩码不是单独一位（如未设置时的 0xFFFFFFFF）时不登记、查不到
+ *  + 不依赖 cocos2d
+ */
+
+template <class Handler>
+class ContactTable
+{
+public:
+    ContactTable() { clear(); }
+
+    /* 单独一位的种别掩码的下标，其余返回 -1 */
+    static int categoryIndex(int category)
+    {
+        if (category <= 0 || category >= (1 << CONTACT_CATEGORY_COUNT) ||
+            (category & (category - 1)) != 0) {
+            return -1;
+        }
+        int index = 0;
+        while (category >>= 1) {
+            index++;
+        }
+        return index;
+    }
+
+    /* 同一对种别重复登记时覆盖；种别不是单独一位时返回 false */
+    bool put(int categoryA, int categoryB, const Handler& handler)
+    {
+        int a = categoryIndex(categoryA);
+        int b = categoryIndex(categoryB);
+        if (a < 0 || b < 0) {
+            return false;
+        }
+        table[a][b] = Entry{ handler, true, false };
+        if (a != b) {
+            table[b][a] = Entry{ handler, true, true };
+        }
+        return true;
+    }
+
+    /* 没有登记时返回 nullptr；swapped 为 true 时登记的顺序与参数相反 */
+    const Handler* find(int categoryA, int categoryB, bool& swapped) const
+    {
+        int a = categoryIndex(categoryA);
+        int b = categoryIndex(categoryB);
+        if (a < 0 || b < 0 || !table[a][b].used) {
+            return nullptr;
+        }
+        swapped = table[a][b].swapped;
+        return &table[a][b].handler;
+    }
+
+    void clear()
+    {
+        for (int a = 0; a < CONTACT_CATEGORY_COUNT; a++) {
+            for (int b = 0; b < CONTACT_CATEGORY_COUNT; b++) {
+                table[a][b] = Entry{ Handler(), false, false };
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Handler handler;
+        bool used;
+        bool swapped; //登记时的顺序与下标相反，调用前对调双方
+    };
+
+    Entry table[CONTACT_CATEGORY_COUNT][CONTACT_CATEGORY_COUNT];
+};
+
+#endif // CONTACT_TABLE_H
@@ -9,6 +9,7 @@
 #include "GameplayScene/CtrlPanel/HPManaBar.h"
 #include "GameplayScene/CtrlPanel/ItemButton.h"
 #include "GameplayScene/CtrlPanel/SpellCardButton.h"
+#include "GameplayScene/Emitters/BulletLayer.h"
 
 #include <functional>
 
@@ -75,7 +76,11 @@ CtrlPanelLayer::init()
     });
     this->addChild(dashButton);
 
-    /*  4. Touch, Keyboard, CustomEvent Listener */
+    /*  4. 擦弹计数 */
+
+    initGrazeCounter();
+
+    /*  5. Touch, Keyboard, CustomEvent Listener */
 
     initTouchListener();
     initKeyboardListener();
@@ -189,6 +194,26 @@ CtrlPanelLayer::initCharacterPanelUIAndListener()
     }
 }
 
+void
+CtrlPanelLayer::initGrazeCounter()
+{
+    _grazeCount = 0;
+    _grazeLabel = Label::create("Graze 0", "fonts/NotoSansCJKsc-Black.otf", 20);
+    _grazeLabel->setAnchorPoint(Vec2::ANCHOR_MIDDLE_LEFT);
+    _grazeLabel->setPosition(Vec2(_visibleSize.width * 0.150, _visibleSize.height * 0.860));
+    this->addChild(_grazeLabel);
+
+    // BulletLayer 每帧整批抛出各角色的擦弹数，随标签一起移除
+    auto listener = EventListenerCustom::create("bullet_grazes", [this](EventCustom* e) {
+        auto grazes = (std::vector<BulletGraze>*)e->getUserData();
+        for (auto& graze : *grazes) {
+            _grazeCount += graze.count;
+        }
+        _grazeLabel->setString(StringUtils::format("Graze %u", _grazeCount));
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, _grazeLabel);
+}
+
 void
 CtrlPanelLayer::initTouchListener()
 {
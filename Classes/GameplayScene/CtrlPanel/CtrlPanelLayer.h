@@ -27,6 +27,7 @@ private:
     void initCharacterPanelUIAndListener();
     void initTouchListener();
     void initKeyboardListener();
+    void initGrazeCounter();
 
 private:
     GameData* _gamedata;
@@ -36,6 +37,9 @@ private:
     unsigned int _currCharacterIdx;
 
     Vector<Node*> _hpBars;
+
+    Label* _grazeLabel;
+    unsigned int _grazeCount; //本局擦弹总数，两名角色共用
 };
 
 #endif // CTRL_PANEL_LAYER_H
@@ -3,6 +3,7 @@
 #endif
 
 #include "GameplayScene/Elevator.h"
+#include "GameplayScene/ContactDispatcher.h"
 #include "GameplayScene/common.h"
 
 #include "cocos-ext.h"
@@ -96,3 +97,59 @@ Broom::moveTogether(float dt)
         }
     }
 }
+
+//电梯与扫把是两个类，按实际类型增减乘客
+static void
+boardCarrier(Node* carrier, Node* passenger, bool board)
+{
+    if (auto elevator = dynamic_cast<Elevator*>(carrier)) {
+        if (board) {
+            elevator->addPassenger(passenger);
+        } else {
+            elevator->removePassenger(passenger);
+        }
+    } else if (auto broom = dynamic_cast<Broom*>(carrier)) {
+        if (board) {
+            broom->addPassenger(passenger);
+        } else {
+            broom->removePassenger(passenger);
+        }
+    }
+}
+
+void
+Elevator::registerContacts(ContactDispatcher* contacts)
+{
+    //冲量方向向上时站在电梯上，否则不产生碰撞
+    contacts->onBegin(playerCategory, elevatorCategory, [](const ContactPair& pair) {
+        if (pair.contact.getContactData()->normal.y > 0) {
+            static_cast<Player*>(pair.nodeA)->resetJump();
+            boardCarrier(pair.nodeB, pair.nodeA, true);
+            return true;
+        }
+        return false;
+    });
+    contacts->onBegin(enemyCategory, elevatorCategory, [](const ContactPair& pair) {
+        if (pair.contact.getContactData()->normal.y > 0) {
+            static_cast<Enemy*>(pair.nodeA)->resetJump();
+            boardCarrier(pair.nodeB, pair.nodeA, true);
+            return true;
+        }
+        return false;
+    });
+
+    contacts->onSeparate(playerCategory, elevatorCategory, [](const ContactPair& pair) {
+        boardCarrier(pair.nodeB, pair.nodeA, false);
+        return true;
+    });
+    contacts->onSeparate(enemyCategory, elevatorCategory, [](const ContactPair& pair) {
+        boardCarrier(pair.nodeB, pair.nodeA, false);
+        return true;
+    });
+
+    //扫把碰到地形时消失
+    contacts->onBegin(elevatorCategory, groundCategory, [](const ContactPair& pair) {
+        pair.nodeA->removeFromParent();
+        return true;
+    });
+}
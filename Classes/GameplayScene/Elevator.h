@@ -12,11 +12,16 @@
 
 USING_NS_CC;
 
+class ContactDispatcher;
+
 class Elevator : public Node
 {
 public:
     bool init();
 
+    //登记角色、敌人乘上与离开电梯，以及扫把碰到地形的接触处理；电梯与扫把共用 elevatorCategory
+    static void registerContacts(ContactDispatcher* contacts);
+
     static Elevator* create()
     {
         Elevator* pRet;
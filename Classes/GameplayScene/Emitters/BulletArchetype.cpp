@@ -0,0 +1,88 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletArchetype.h"
+
+#include <sstream>
+
+ArchetypeRegistry* ArchetypeRegistry::_self;
+
+ArchetypeRegistry*
+ArchetypeRegistry::getInstance()
+{
+    if (!_self) {
+        _self = new (std::nothrow) ArchetypeRegistry();
+    }
+    return _self;
+}
+
+std::string
+ArchetypeRegistry::keyOf(const BulletConfig& bc)
+{
+    std::ostringstream key;
+    key << bc.name << '#' << bc.length << 'x' << bc.width << '#' << bc.harm << '#'
+        << bc._categoryBitmask << ',' << bc._collisionBitmask << ',' << bc._contactTestBitmask
+        << '#' << bc.homing << (bc.trail ? "#trail" : "");
+    return key.str();
+}
+
+unsigned short
+ArchetypeRegistry::intern(const BulletConfig& bc)
+{
+    auto key = keyOf(bc);
+    auto it = ids.find(key);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    BulletArchetype archetype;
+    archetype.id = (unsigned short)archetypes.size();
+    archetype.config = bc;
+    archetype.frame = SpriteFrameCache::getInstance()->getSpriteFrameByName(bc.name);
+    archetype.texture = nullptr;
+    archetype.blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+    archetype.quad = V3F_C4B_T2F_Quad();
+    if (archetype.frame) {
+        archetype.frame->retain(); //切换场景时帧缓存可能被清空
+
+        //顶点、纹理坐标与混合方式和以该帧创建的 Sprite 完全一致，平移到以中心为原点
+        auto sprite = Sprite::createWithSpriteFrame(archetype.frame);
+        archetype.texture = sprite->getTexture();
+        archetype.blendFunc = sprite->getBlendFunc();
+        archetype.quad = sprite->getQuad();
+        archetype.contentSize = sprite->getContentSize();
+        const Vec2& anchor = sprite->getAnchorPointInPoints();
+        V3F_C4B_T2F* corners[4] = { &archetype.quad.tl, &archetype.quad.bl, &archetype.quad.tr,
+                                    &archetype.quad.br };
+        for (auto corner : corners) {
+            corner->vertices.x -= anchor.x;
+            corner->vertices.y -= anchor.y;
+        }
+    } else {
+        log("[ArchetypeRegistry] unknown sprite frame %s", bc.name.c_str());
+    }
+    archetype.halfLength = bc.length / 2.0f;
+    archetype.halfWidth = bc.width / 2.0f;
+    archetype.radius = (bc.length + bc.width) / 4.0f;
+    archetype.damage = bc.harm;
+    archetype.categoryMask = (unsigned int)bc._categoryBitmask;
+    archetype.contactMask = (unsigned int)bc._contactTestBitmask;
+    archetype.homing = CC_DEGREES_TO_RADIANS((float)bc.homing);
+    archetype.trail = bc.trail;
+
+    archetypes.push_back(archetype);
+    ids[key] = archetype.id;
+    return archetype.id;
+}
+
+bool
+ArchetypeRegistry::find(const BulletConfig& bc, unsigned short& id) const
+{
+    auto it = ids.find(keyOf(bc));
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
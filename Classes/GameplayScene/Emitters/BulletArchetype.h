@@ -0,0 +1,69 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_ARCHETYPE_H
+#define BULLET_ARCHETYPE_H
+
+#include "StyleConfig.h"
+#include "cocos2d.h"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+USING_NS_CC;
+
+/* 子弹原型：同一 BulletConfig 的子弹共用，登记后只读 */
+struct BulletArchetype
+{
+    unsigned short id;
+    BulletConfig config;       //登记时的配置
+    SpriteFrame* frame;        //已解析的纹理帧，持有引用
+    Texture2D* texture;        //纹理帧所在的图集，由 frame 持有
+    BlendFunc blendFunc;       //与同一纹理帧的 Sprite 相同
+    V3F_C4B_T2F_Quad quad;     //以纹理帧中心为原点的四个顶点，BulletRenderer 逐颗缩放、旋转后绘制
+    Size contentSize;          //纹理帧的尺寸，激光按它换算缩放
+    float halfLength;          //碰撞盒半长
+    float halfWidth;           //碰撞盒半宽
+    float radius;              //子弹场命中检测的半径
+    int damage;                //伤害
+    unsigned int categoryMask; //种别掩码
+    unsigned int contactMask;  //命中掩码
+    float homing;              //追踪弹每秒最多转过的弧度，0 为直飞
+    bool trail;                //是否带拖尾
+};
+
+/* 原型表：单例
+ *
+ *  + intern 将 BulletConfig 登记为 16 位编号，纹理帧与碰撞参数只解析一次；
+ *    同一配置重复登记返回同一编号，需要拼接键并查表，应在弹幕创建或模式编译时调用
+ *  + 子弹只保存编号，发射路径上以 get 按下标取原型，不再复制配置中的字符串
+ *  + 子弹不对应任何节点，纹理、混合方式与顶点在登记时从同一纹理帧的 Sprite 取一次，
+ *    之后由 BulletRenderer 直接读取
+ *  + 编号在整个游戏过程中有效，离开游戏场景时不清空
+ */
+class ArchetypeRegistry
+{
+public:
+    static ArchetypeRegistry* getInstance();
+
+    unsigned short intern(const BulletConfig& bc);
+
+    /* 未登记时返回 false */
+    bool find(const BulletConfig& bc, unsigned short& id) const;
+
+    const BulletArchetype& get(unsigned short id) const { return archetypes[id]; }
+    int size() const { return (int)archetypes.size(); }
+
+    static std::string keyOf(const BulletConfig& bc);
+
+private:
+    ArchetypeRegistry() {}
+    static ArchetypeRegistry* _self;
+
+    std::deque<BulletArchetype> archetypes; //追加时不移动已有元素，get 返回的引用一直有效
+    std::unordered_map<std::string, unsigned short> ids;
+};
+
+#endif // BULLET_ARCHETYPE_H
@@ -0,0 +1,406 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletField.h"
+#include "JobSystem.h"
+#include "StyleLifetime.h"
+
+#include <cmath>
+
+// 并行推进时每块的子弹数，块太小时调度开销超过计算本身
+#define BULLET_FIELD_GRAIN 2048
+
+#define BULLET_FIELD_PI 3.14159265358979323846f
+
+BulletField::BulletField()
+{
+    count = 0;
+    kernels = &getBulletKernels();
+}
+
+void
+BulletField::reserve(int capacity)
+{
+    posX.reserve(capacity);
+    posY.reserve(capacity);
+    velX.reserve(capacity);
+    velY.reserve(capacity);
+    originX.reserve(capacity);
+    originY.reserve(capacity);
+    age.reserve(capacity);
+    life.reserve(capacity);
+    rotation.reserve(capacity);
+    startRotation.reserve(capacity);
+    spin.reserve(capacity);
+    motion.reserve(capacity);
+    curve.reserve(capacity);
+    archetype.reserve(capacity);
+    ownerMask.reserve(capacity);
+    hitMask.reserve(capacity);
+    radius.reserve(capacity);
+    damage.reserve(capacity);
+    despawn.reserve(capacity);
+    priority.reserve(capacity);
+    flags.reserve(capacity);
+    turnRate.reserve(capacity);
+    trail.reserve(capacity);
+    scale.reserve(capacity);
+    owner.reserve(capacity);
+    ownerSlot.reserve(capacity);
+}
+
+int
+BulletField::spawn(const Trajectory& trajectory, float life, const BulletTraits& traits,
+                   StyleLifetime* owner, float age, uint32_t flags)
+{
+    this->posX.push_back(trajectory.originX);
+    this->posY.push_back(trajectory.originY);
+    this->velX.push_back(trajectory.velX);
+    this->velY.push_back(trajectory.velY);
+    this->originX.push_back(trajectory.originX);
+    this->originY.push_back(trajectory.originY);
+    this->age.push_back(age);
+    this->life.push_back(life);
+    this->rotation.push_back(trajectory.rotation);
+    this->startRotation.push_back(trajectory.rotation);
+    this->spin.push_back(trajectory.spin);
+    this->motion.push_back(trajectory.type);
+    this->curve.push_back(trajectory.curve);
+    this->archetype.push_back(traits.archetype);
+    this->ownerMask.push_back(traits.ownerMask);
+    this->hitMask.push_back(traits.hitMask);
+    this->radius.push_back(traits.radius);
+    this->damage.push_back(traits.damage);
+    this->despawn.push_back(traits.despawn);
+    this->priority.push_back(traits.priority);
+    this->flags.push_back(flags);
+    this->turnRate.push_back(0);
+    this->trail.push_back(-1);
+    this->scale.push_back(1.0f);
+    this->owner.push_back(owner);
+    this->ownerSlot.push_back(owner ? owner->attachBullet(this, count) : SlotHandle());
+    if (age > 0) {
+        evaluate(count);
+    }
+    return count++;
+}
+
+void
+BulletField::kill(int index)
+{
+    if (index >= 0 && index < count) {
+        flags[index] |= FLAG_DEAD;
+    }
+}
+
+void
+BulletField::respawn(int index, const Trajectory& trajectory, float life,
+                      const BulletTraits& traits, uint32_t flags)
+{
+    posX[index] = trajectory.originX;
+    posY[index] = trajectory.originY;
+    velX[index] = trajectory.velX;
+    velY[index] = trajectory.velY;
+    originX[index] = trajectory.originX;
+    originY[index] = trajectory.originY;
+    age[index] = 0;
+    this->life[index] = life;
+    rotation[index] = trajectory.rotation;
+    startRotation[index] = trajectory.rotation;
+    spin[index] = trajectory.spin;
+    motion[index] = trajectory.type;
+    curve[index] = trajectory.curve;
+    archetype[index] = traits.archetype;
+    ownerMask[index] = traits.ownerMask;
+    hitMask[index] = traits.hitMask;
+    radius[index] = traits.radius;
+    damage[index] = traits.damage;
+    despawn[index] = traits.despawn;
+    priority[index] = traits.priority;
+    this->flags[index] = flags;
+    turnRate[index] = 0;
+    scale[index] = 1.0f;
+    releaseTrail(index);
+}
+
+void
+BulletField::update(float dt)
+{
+    //各块只写自己的下标范围，结果与线程数无关
+    JobSystem::getInstance()->parallelFor(count, BULLET_FIELD_GRAIN,
+                                          [this, dt](int begin, int end) {
+                                              updateRange(begin, end, dt);
+                                          });
+    recordTrails();
+}
+
+void
+BulletField::updateRange(int begin, int end, float dt)
+{
+    int n = end - begin;
+    kernels->advance(age.data() + begin, rotation.data() + begin, startRotation.data() + begin,
+                     spin.data() + begin, n, dt);
+
+    // LINEAR 与 INTEGRATED 都是 origin + vel * age，全部交给内核
+    kernels->integrate(posX.data() + begin, posY.data() + begin, originX.data() + begin,
+                       originY.data() + begin, velX.data() + begin, velY.data() + begin,
+                       age.data() + begin, n);
+
+    //曲线子弹覆盖内核的结果
+    for (int i = begin; i < end; i++) {
+        if (motion[i] == TrajectoryType::EASED || motion[i] == TrajectoryType::BEZIER) {
+            float dx, dy;
+            curve[i].evaluate(motion[i], age[i], dx, dy);
+            posX[i] = originX[i] + dx;
+            posY[i] = originY[i] + dy;
+        }
+    }
+}
+
+void
+BulletField::evaluate(int index)
+{
+    //与内核的运算顺序一致，补发的子弹与正常推进的结果相同
+    rotation[index] = startRotation[index] + spin[index] * age[index];
+    if (motion[index] == TrajectoryType::EASED || motion[index] == TrajectoryType::BEZIER) {
+        float dx, dy;
+        curve[index].evaluate(motion[index], age[index], dx, dy);
+        posX[index] = originX[index] + dx;
+        posY[index] = originY[index] + dy;
+    } else {
+        posX[index] = originX[index] + velX[index] * age[index];
+        posY[index] = originY[index] + velY[index] * age[index];
+    }
+}
+
+void
+BulletField::setVelocity(int index, float vx, float vy)
+{
+    velX[index] = vx;
+    velY[index] = vy;
+    originX[index] = posX[index] - vx * age[index];
+    originY[index] = posY[index] - vy * age[index];
+}
+
+void
+BulletField::setHoming(int index, float turnRate)
+{
+    flags[index] |= FLAG_HOMING;
+    this->turnRate[index] = turnRate;
+}
+
+void
+BulletField::setTrail(int index)
+{
+    if (trail[index] < 0) {
+        int slot;
+        if (!freeTrails.empty()) {
+            slot = freeTrails.back();
+            freeTrails.pop_back();
+        } else {
+            slot = (int)trailOwner.size();
+            trailOwner.push_back(-1);
+            trailHead.push_back(0);
+            trailLength.push_back(0);
+            trailX.resize(trailX.size() + BULLET_TRAIL_LENGTH);
+            trailY.resize(trailY.size() + BULLET_TRAIL_LENGTH);
+        }
+        trailOwner[slot] = index;
+        trail[index] = slot;
+    }
+
+    int slot = trail[index];
+    flags[index] |= FLAG_TRAIL;
+    trailHead[slot] = 0;
+    trailLength[slot] = 1;
+    trailX[slot * BULLET_TRAIL_LENGTH] = posX[index];
+    trailY[slot * BULLET_TRAIL_LENGTH] = posY[index];
+}
+
+void
+BulletField::releaseTrail(int index)
+{
+    int slot = trail[index];
+    if (slot >= 0) {
+        trailOwner[slot] = -1;
+        freeTrails.push_back(slot);
+        trail[index] = -1;
+    }
+    flags[index] &= ~(uint32_t)FLAG_TRAIL;
+}
+
+void
+BulletField::recordTrails()
+{
+    //只遍历槽位，不带拖尾的子弹不产生任何开销
+    for (int slot = 0; slot < (int)trailOwner.size(); slot++) {
+        int i = trailOwner[slot];
+        if (i < 0) {
+            continue;
+        }
+        int head = (trailHead[slot] + 1) % BULLET_TRAIL_LENGTH;
+        trailHead[slot] = (uint8_t)head;
+        trailX[slot * BULLET_TRAIL_LENGTH + head] = posX[i];
+        trailY[slot * BULLET_TRAIL_LENGTH + head] = posY[i];
+        if (trailLength[slot] < BULLET_TRAIL_LENGTH) {
+            trailLength[slot]++;
+        }
+    }
+}
+
+void
+BulletField::getTurn(float turnRate, float dt, float& cosTurn, float& sinTurn)
+{
+    float turn = turnRate * dt;
+    if (turn > BULLET_FIELD_PI) {
+        turn = BULLET_FIELD_PI;
+    }
+    cosTurn = cosf(turn);
+    sinTurn = sinf(turn);
+}
+
+void
+BulletField::steerToward(int index, float x, float y, float cosTurn, float sinTurn)
+{
+    float vx = velX[index];
+    float vy = velY[index];
+    float dx = x - posX[index];
+    float dy = y - posY[index];
+    float speed = sqrtf(vx * vx + vy * vy);
+    float distance = sqrtf(dx * dx + dy * dy);
+    if (speed <= 0 || distance <= 0) {
+        return;
+    }
+
+    //以单位向量比较航向与目标方向，夹角在本帧可转范围内时直接对准，否则朝目标一侧转满
+    float hx = vx / speed;
+    float hy = vy / speed;
+    dx /= distance;
+    dy /= distance;
+    if (hx * dx + hy * dy >= cosTurn) {
+        hx = dx;
+        hy = dy;
+    } else {
+        float side = hx * dy - hy * dx >= 0 ? sinTurn : -sinTurn;
+        float rx = hx * cosTurn - hy * side;
+        float ry = hx * side + hy * cosTurn;
+        hx = rx;
+        hy = ry;
+    }
+    setVelocity(index, speed * hx, speed * hy);
+
+    // Node::setRotation 为顺时针，0 度朝上
+    float degrees = 90.0f - atan2f(hy, hx) * 180.0f / BULLET_FIELD_PI;
+    startRotation[index] = degrees - spin[index] * age[index];
+    rotation[index] = degrees;
+}
+
+void
+BulletField::removeDead(std::vector<Released>& released)
+{
+    int i = 0;
+    while (i < count) {
+        if (isDead(i)) {
+            if (owner[i]) {
+                released.push_back(Released{ owner[i], ownerSlot[i] });
+            }
+            releaseTrail(i);
+            moveEntry(count - 1, i);
+            popBack();
+        } else {
+            i++;
+        }
+    }
+}
+
+void
+BulletField::clear(std::vector<Released>& released)
+{
+    for (int i = 0; i < count; i++) {
+        if (owner[i]) {
+            released.push_back(Released{ owner[i], ownerSlot[i] });
+        }
+    }
+    while (count > 0) {
+        popBack();
+    }
+    trailOwner.clear();
+    trailHead.clear();
+    trailLength.clear();
+    trailX.clear();
+    trailY.clear();
+    freeTrails.clear();
+}
+
+void
+BulletField::moveEntry(int from, int to)
+{
+    if (from == to) {
+        return;
+    }
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    velX[to] = velX[from];
+    velY[to] = velY[from];
+    originX[to] = originX[from];
+    originY[to] = originY[from];
+    age[to] = age[from];
+    life[to] = life[from];
+    rotation[to] = rotation[from];
+    startRotation[to] = startRotation[from];
+    spin[to] = spin[from];
+    motion[to] = motion[from];
+    curve[to] = curve[from];
+    archetype[to] = archetype[from];
+    ownerMask[to] = ownerMask[from];
+    hitMask[to] = hitMask[from];
+    radius[to] = radius[from];
+    damage[to] = damage[from];
+    despawn[to] = despawn[from];
+    priority[to] = priority[from];
+    flags[to] = flags[from];
+    turnRate[to] = turnRate[from];
+    trail[to] = trail[from];
+    if (trail[to] >= 0) {
+        trailOwner[trail[to]] = to;
+    }
+    scale[to] = scale[from];
+    owner[to] = owner[from];
+    ownerSlot[to] = ownerSlot[from];
+    if (owner[to]) {
+        owner[to]->relocateBullet(ownerSlot[to], to);
+    }
+}
+
+void
+BulletField::popBack()
+{
+    posX.pop_back();
+    posY.pop_back();
+    velX.pop_back();
+    velY.pop_back();
+    originX.pop_back();
+    originY.pop_back();
+    age.pop_back();
+    life.pop_back();
+    rotation.pop_back();
+    startRotation.pop_back();
+    spin.pop_back();
+    motion.pop_back();
+    curve.pop_back();
+    archetype.pop_back();
+    ownerMask.pop_back();
+    hitMask.pop_back();
+    radius.pop_back();
+    damage.pop_back();
+    despawn.pop_back();
+    priority.pop_back();
+    flags.pop_back();
+    turnRate.pop_back();
+    trail.pop_back();
+    scale.pop_back();
+    owner.pop_back();
+    ownerSlot.pop_back();
+    count--;
+}
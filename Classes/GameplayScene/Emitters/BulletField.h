@@ -0,0 +1,190 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_FIELD_H
+#define BULLET_FIELD_H
+
+#include "BulletKernels.h"
+#include "Trajectory.h"
+
+#include "SlotMap.h"
+
+#include <cstdint>
+#include <vector>
+
+class StyleLifetime;
+
+/* 子弹场：以结构数组（SoA）形式保存所有在场子弹
+ *
+ *  + 每颗子弹只是各数组中的同一下标，每帧由 update 在一个紧凑循环里统一推进
+ *  + 位置按轨迹从发射时刻解析求值（见 Trajectory），不随帧累积误差
+ *  + 不依赖 cocos2d，也不对应任何节点；纹理与尺寸取自原型（BulletArchetype），缩放逐颗记录，
+ *    由 BulletRenderer 直接按各数组绘制
+ *  + 每颗子弹记下发射它的弹幕（StyleLifetime）及在其子弹表中的句柄，移动下标时通知弹幕，
+ *    离场时由调用者交还（见 removeDead）
+ *  + 删除采用与末尾交换的方式，下标在 removeDead 之后可能改变
+ *  + 带拖尾的子弹另占一个拖尾槽位，槽位中是最近 BULLET_TRAIL_LENGTH 帧位置的环形缓冲；
+ *    槽位数据不随子弹的下标移动，只在槽位上记下所属子弹的下标
+ */
+
+// 拖尾记录的帧数，包含当前帧
+#define BULLET_TRAIL_LENGTH 8
+
+/* 子弹预算的优先级，超出预算时先拒绝或挤掉优先级低的子弹 */
+enum class BulletPriority : uint8_t
+{
+    FILLER, //装饰性的散弹、抛物线弹
+    AIMED,  //敌人的自机狙
+    PLAYER, //自机的子弹与拾取物
+};
+
+#define BULLET_PRIORITY_COUNT 3
+
+/* 子弹的种类与判定参数，发射时写入子弹场 */
+struct BulletTraits
+{
+    uint16_t archetype;
+    uint32_t ownerMask; //发射方种别掩码
+    uint32_t hitMask;   //可命中的目标种别掩码
+    float radius;       //判定半径，判定形状近似为圆
+    int damage;
+    uint8_t despawn; //出界回收规则的编号，0 表示只按寿命回收（见 BulletSimulation）
+    BulletPriority priority;
+};
+
+class BulletField
+{
+public:
+    enum Flag
+    {
+        FLAG_DEAD = 0x1,   //已被击中或取消，下一次 removeDead 时移除
+        FLAG_GRAZED = 0x2, //已擦弹，每颗子弹一生只计一次
+        FLAG_PICKUP = 0x4, //由 cancelBullets 转成的拾取物，碰到角色时拾取而不是造成伤害
+        FLAG_HOMING = 0x8, //追踪弹，每帧由 steerToward 转向目标
+        FLAG_TRAIL = 0x10, //带拖尾，每帧 update 之后记录位置
+    };
+
+    BulletField();
+
+    /* 写入一颗子弹，返回其当前下标；age 为发射时已经过的时间，用于补发的子弹。
+     * owner 不为空时子弹登记到它的子弹表 */
+    int spawn(const Trajectory& trajectory, float life, const BulletTraits& traits,
+              StyleLifetime* owner = nullptr, float age = 0, uint32_t flags = 0);
+
+    /* 标记子弹死亡 */
+    void kill(int index);
+
+    /* 就地改写一颗子弹的轨迹与属性，age 从 0 开始，缩放复位；发射方不变，需要时由调用者先交还 */
+    void respawn(int index, const Trajectory& trajectory, float life, const BulletTraits& traits,
+                 uint32_t flags);
+
+    /* 推进所有子弹 dt 秒，匀速部分由 SIMD 内核完成；子弹较多时分块交给 JobSystem 并行 */
+    void update(float dt);
+
+    /* 改变 INTEGRATED 子弹的速度，以当前位置作为新的起点 */
+    void setVelocity(int index, float vx, float vy);
+
+    /* 把 INTEGRATED 子弹标为追踪弹，turnRate 为每秒最多转过的角度（弧度） */
+    void setHoming(int index, float turnRate);
+
+    /* 为子弹分配拖尾槽位，历史位置从当前位置开始记录；转为拾取物（respawn）时拖尾随之取消 */
+    void setTrail(int index);
+
+    /* 已记录的拖尾位置数，不带拖尾时为 0 */
+    int getTrailLength(int index) const
+    {
+        return trail[index] < 0 ? 0 : trailLength[trail[index]];
+    }
+
+    /* 拖尾中第 k 个位置，k 为 0 时是最新的位置，k 须小于 getTrailLength */
+    void getTrailPoint(int index, int k, float& x, float& y) const
+    {
+        int slot = trail[index];
+        int i = (trailHead[slot] + BULLET_TRAIL_LENGTH - k) % BULLET_TRAIL_LENGTH;
+        x = trailX[slot * BULLET_TRAIL_LENGTH + i];
+        y = trailY[slot * BULLET_TRAIL_LENGTH + i];
+    }
+
+    /* 带拖尾的子弹数 */
+    int getTrailCount() const { return (int)trailOwner.size() - (int)freeTrails.size(); }
+
+    /* 追踪弹朝 (x, y) 转向，速率不变，角度与速度方向一致；本帧最多转过的角度以余弦、正弦给出
+     * （见 getTurn），转向速率相同的追踪弹可共用，不必逐颗求三角函数 */
+    void steerToward(int index, float x, float y, float cosTurn, float sinTurn);
+
+    /* 转向速率为 turnRate 时 dt 秒内最多转过的角度，超过半圈按半圈计 */
+    static void getTurn(float turnRate, float dt, float& cosTurn, float& sinTurn);
+
+    /* 被移除子弹的发射方与句柄，由调用者交还发射方 */
+    struct Released
+    {
+        StyleLifetime* owner;
+        SlotHandle slot;
+    };
+
+    /* 移除死亡或到期的子弹，仍有发射方的追加到 released */
+    void removeDead(std::vector<Released>& released);
+
+    /* 清空，仍有发射方的子弹追加到 released */
+    void clear(std::vector<Released>& released);
+
+    void reserve(int capacity);
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const BulletKernels& getKernels() const { return *kernels; }
+    bool isDead(int index) const
+    {
+        return (flags[index] & FLAG_DEAD) != 0 || age[index] >= life[index];
+    }
+
+public:
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> originX; //发射位置
+    std::vector<float> originY;
+    std::vector<float> age;      //已存活时间
+    std::vector<float> life;     //寿命，age 达到 life 即到期
+    std::vector<float> rotation; //角度制，与 Node::setRotation 一致
+    std::vector<float> startRotation;
+    std::vector<float> spin; //每秒旋转角度
+    std::vector<TrajectoryType> motion;
+    std::vector<TrajectoryCurve> curve; //仅 EASED、BEZIER 使用
+    std::vector<uint16_t> archetype;
+    std::vector<uint32_t> ownerMask; //发射方种别掩码
+    std::vector<uint32_t> hitMask;
+    std::vector<float> radius;
+    std::vector<int> damage;
+    std::vector<uint8_t> despawn;
+    std::vector<BulletPriority> priority;
+    std::vector<uint32_t> flags;
+    std::vector<float> turnRate; //追踪弹每秒最多转过的弧度，其余子弹为 0
+    std::vector<int> trail;      //拖尾槽位，-1 为不带拖尾
+    std::vector<float> scale;    //显示的缩放，不影响判定
+    std::vector<StyleLifetime*> owner; //发射它的弹幕，弹幕已销毁或子弹已交还时为 nullptr
+    std::vector<SlotHandle> ownerSlot; //在 owner 子弹表中的句柄
+
+private:
+    void updateRange(int begin, int end, float dt);
+    void evaluate(int index);
+    void recordTrails();
+    void releaseTrail(int index);
+    void moveEntry(int from, int to);
+    void popBack();
+
+private:
+    int count;
+    const BulletKernels* kernels;
+
+    //拖尾槽位，第 s 个槽位的位置存放在 [s * BULLET_TRAIL_LENGTH, (s + 1) * BULLET_TRAIL_LENGTH)
+    std::vector<float> trailX;
+    std::vector<float> trailY;
+    std::vector<uint8_t> trailHead;   //最新位置在环形缓冲中的下标
+    std::vector<uint8_t> trailLength; //已记录的位置数
+    std::vector<int> trailOwner;      //所属子弹的下标，-1 为空闲
+    std::vector<int> freeTrails;
+};
+
+#endif // BULLET_FIELD_H
@@ -0,0 +1,94 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+BulletGrid::BulletGrid()
+{
+    setBounds(0, 0, 1, 1, 64);
+}
+
+void
+BulletGrid::setBounds(float x, float y, float width, float height, float cellSize)
+{
+    this->originX = x;
+    this->originY = y;
+    this->cellSize = cellSize > 1 ? cellSize : 1;
+    this->invCellSize = 1.0f / this->cellSize;
+    this->columns = (int)ceilf(width * invCellSize);
+    this->rows = (int)ceilf(height * invCellSize);
+    if (columns < 1) {
+        columns = 1;
+    }
+    if (rows < 1) {
+        rows = 1;
+    }
+    cellStart.assign(columns * rows + 1, 0);
+}
+
+int
+BulletGrid::columnOf(float x) const
+{
+    int c = (int)floorf((x - originX) * invCellSize);
+    return c < 0 ? 0 : (c >= columns ? columns - 1 : c);
+}
+
+int
+BulletGrid::rowOf(float y) const
+{
+    int r = (int)floorf((y - originY) * invCellSize);
+    return r < 0 ? 0 : (r >= rows ? rows - 1 : r);
+}
+
+void
+BulletGrid::build(const float* xs, const float* ys, int count)
+{
+    int cells = columns * rows;
+    bulletCell.resize(count);
+    entries.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+
+    //计数
+    for (int i = 0; i < count; i++) {
+        int cell = rowOf(ys[i]) * columns + columnOf(xs[i]);
+        bulletCell[i] = cell;
+        cellStart[cell + 1]++;
+    }
+
+    //前缀和
+    for (int c = 0; c < cells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    //倒序填充，直接以 cellStart 作游标，格内下标保持升序
+    for (int i = count - 1; i >= 0; i--) {
+        int cell = bulletCell[i];
+        entries[--cellStart[cell + 1]] = i;
+    }
+    //倒序填充后 cellStart[c + 1] 退回到格子 c 的起点，整体左移一位
+    for (int c = 0; c < cells; c++) {
+        cellStart[c] = cellStart[c + 1];
+    }
+    cellStart[cells] = count;
+}
+
+void
+BulletGrid::query(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const
+{
+    int c0 = columnOf(minX);
+    int c1 = columnOf(maxX);
+    int r0 = rowOf(minY);
+    int r1 = rowOf(maxY);
+
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            int cell = r * columns + c;
+            out.insert(out.end(), entries.begin() + cellStart[cell],
+                       entries.begin() + cellStart[cell + 1]);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_GRID_H
+#define BULLET_GRID_H
+
+#include <vector>
+
+/* 子弹均匀网格：代替物理引擎的宽相检测
+ *
+ *  + 覆盖当前区域（curArea），格子边长可调，区域外的子弹归入边缘格子
+ *  + 每帧按计数排序重建一次，格内子弹下标连续存放，不产生分配
+ *  + 查询只返回候选下标，精确判定由调用者完成
+ */
+
+class BulletGrid
+{
+public:
+    BulletGrid();
+
+    /* 设置覆盖范围与格子边长 */
+    void setBounds(float x, float y, float width, float height, float cellSize);
+    float getCellSize() const { return cellSize; }
+
+    /* 以 count 颗子弹的位置重建网格 */
+    void build(const float* xs, const float* ys, int count);
+
+    /* 将与矩形 [minX, maxX] x [minY, maxY] 相交的格子中的子弹下标追加到 out */
+    void query(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
+
+private:
+    int columnOf(float x) const;
+    int rowOf(float y) const;
+
+private:
+    float originX;
+    float originY;
+    float cellSize;
+    float invCellSize;
+    int columns;
+    int rows;
+
+    std::vector<int> cellStart; //每个格子在 entries 中的起始位置，多一项作为结尾
+    std::vector<int> entries;   //按格子排列的子弹下标
+    std::vector<int> bulletCell;
+};
+
+#endif // BULLET_GRID_H
@@ -0,0 +1,618 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletKernels.h"
+
+#include <cmath>
+
+// 需要以 -ffp-contract=off 编译（见 CMakeLists.txt、Android.mk），否则标量版本可能被合并为
+// 乘加指令，与 SIMD 版本不再逐位一致；BulletField.cpp、Trajectory.cpp 同样如此
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BULLET_KERNELS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BULLET_KERNELS_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BULLET_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__)
+#define BULLET_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BULLET_TARGET_AVX2
+#endif
+
+/* 标量实现，也用于各 SIMD 版本的尾部 */
+
+static void
+advanceScalar(float* age, float* rotation, const float* startRotation, const float* spin,
+              int count, float dt)
+{
+    for (int i = 0; i < count; i++) {
+        age[i] = age[i] + dt;
+        rotation[i] = startRotation[i] + spin[i] * age[i];
+    }
+}
+
+static void
+integrateScalar(float* posX, float* posY, const float* originX, const float* originY,
+                const float* velX, const float* velY, const float* age, int count)
+{
+    for (int i = 0; i < count; i++) {
+        posX[i] = originX[i] + velX[i] * age[i];
+        posY[i] = originY[i] + velY[i] * age[i];
+    }
+}
+
+static int
+cullOutsideScalar(const float* posX, const float* posY, int count, float minX, float minY,
+                  float maxX, float maxY, uint8_t* outside)
+{
+    int culled = 0;
+    for (int i = 0; i < count; i++) {
+        bool out = posX[i] < minX || posX[i] > maxX || posY[i] < minY || posY[i] > maxY;
+        outside[i] = out ? 1 : 0;
+        culled += outside[i];
+    }
+    return culled;
+}
+
+static int
+overlapBoxesScalar(const float* posX, const float* posY, const float* radius, int count,
+                   const float* boxes, int targetCount, int32_t* firstHit)
+{
+    int hitCount = 0;
+    for (int i = 0; i < count; i++) {
+        float x = posX[i];
+        float y = posY[i];
+        float r2 = radius[i] * radius[i];
+        firstHit[i] = -1;
+        for (int t = 0; t < targetCount; t++) {
+            const float* box = boxes + t * 4;
+            float cx = x < box[0] ? box[0] : (x > box[2] ? box[2] : x);
+            float cy = y < box[1] ? box[1] : (y > box[3] ? box[3] : y);
+            float dx = x - cx;
+            float dy = y - cy;
+            if (dx * dx + dy * dy <= r2) {
+                firstHit[i] = t;
+                hitCount++;
+                break;
+            }
+        }
+    }
+    return hitCount;
+}
+
+/* 一个目标与第 first 个起的查找比较，保留较近者 */
+static void
+closerTargetScalar(const float* queryX, const float* queryY, const uint32_t* queryMask, int first,
+                   int queryCount, float x, float y, uint32_t category, int32_t id, float* best,
+                   int32_t* out)
+{
+    for (int q = first; q < queryCount; q++) {
+        float dx = x - queryX[q];
+        float dy = y - queryY[q];
+        float d = dx * dx + dy * dy;
+        if ((category & queryMask[q]) != 0 && d < best[q]) {
+            best[q] = d;
+            out[q] = id;
+        }
+    }
+}
+
+static void
+resetNearest(int queryCount, float* best, int32_t* out)
+{
+    for (int q = 0; q < queryCount; q++) {
+        best[q] = INFINITY;
+        out[q] = -1;
+    }
+}
+
+static void
+nearestTargetsScalar(const float* queryX, const float* queryY, const uint32_t* queryMask,
+                     int queryCount, const float* targetX, const float* targetY,
+                     const uint32_t* targetCategory, const int32_t* ids, int targetCount,
+                     float* best, int32_t* out)
+{
+    resetNearest(queryCount, best, out);
+    for (int t = 0; t < targetCount; t++) {
+        closerTargetScalar(queryX, queryY, queryMask, 0, queryCount, targetX[t], targetY[t],
+                           targetCategory[t], ids ? ids[t] : t, best, out);
+    }
+}
+
+static const BulletKernels scalarKernels = { "scalar", advanceScalar, integrateScalar,
+                                             cullOutsideScalar, overlapBoxesScalar,
+                                             nearestTargetsScalar };
+
+#ifdef BULLET_KERNELS_SSE2
+
+static void
+advanceSSE2(float* age, float* rotation, const float* startRotation, const float* spin, int count,
+            float dt)
+{
+    int i = 0;
+    __m128 vdt = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(age + i), vdt);
+        _mm_storeu_ps(age + i, a);
+        __m128 r =
+            _mm_add_ps(_mm_loadu_ps(startRotation + i), _mm_mul_ps(_mm_loadu_ps(spin + i), a));
+        _mm_storeu_ps(rotation + i, r);
+    }
+    advanceScalar(age + i, rotation + i, startRotation + i, spin + i, count - i, dt);
+}
+
+static void
+integrateSSE2(float* posX, float* posY, const float* originX, const float* originY,
+              const float* velX, const float* velY, const float* age, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(age + i);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(originX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), a));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(originY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), a));
+        _mm_storeu_ps(posX + i, x);
+        _mm_storeu_ps(posY + i, y);
+    }
+    integrateScalar(posX + i, posY + i, originX + i, originY + i, velX + i, velY + i, age + i,
+                    count - i);
+}
+
+static int
+cullOutsideSSE2(const float* posX, const float* posY, int count, float minX, float minY,
+                float maxX, float maxY, uint8_t* outside)
+{
+    int culled = 0;
+    int i = 0;
+    __m128 x0 = _mm_set1_ps(minX);
+    __m128 y0 = _mm_set1_ps(minY);
+    __m128 x1 = _mm_set1_ps(maxX);
+    __m128 y1 = _mm_set1_ps(maxY);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(posX + i);
+        __m128 y = _mm_loadu_ps(posY + i);
+        __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(x, x0), _mm_cmpgt_ps(x, x1)),
+                               _mm_or_ps(_mm_cmplt_ps(y, y0), _mm_cmpgt_ps(y, y1)));
+        int mask = _mm_movemask_ps(out);
+        for (int k = 0; k < 4; k++) {
+            outside[i + k] = (mask >> k) & 1;
+        }
+        culled += outside[i] + outside[i + 1] + outside[i + 2] + outside[i + 3];
+    }
+    return culled + cullOutsideScalar(posX + i, posY + i, count - i, minX, minY, maxX, maxY,
+                                      outside + i);
+}
+
+static int
+overlapBoxesSSE2(const float* posX, const float* posY, const float* radius, int count,
+                 const float* boxes, int targetCount, int32_t* firstHit)
+{
+    int hitCount = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(posX + i);
+        __m128 y = _mm_loadu_ps(posY + i);
+        __m128 r = _mm_loadu_ps(radius + i);
+        __m128 r2 = _mm_mul_ps(r, r);
+        __m128i hit = _mm_set1_epi32(-1);
+        int found = 0;
+        for (int t = 0; t < targetCount && found != 0xF; t++) {
+            const float* box = boxes + t * 4;
+            __m128 cx = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(box[0])), _mm_set1_ps(box[2]));
+            __m128 cy = _mm_min_ps(_mm_max_ps(y, _mm_set1_ps(box[1])), _mm_set1_ps(box[3]));
+            __m128 dx = _mm_sub_ps(x, cx);
+            __m128 dy = _mm_sub_ps(y, cy);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 lanes = _mm_cmple_ps(d2, r2);
+            int mask = _mm_movemask_ps(lanes) & ~found;
+            if (mask) {
+                //只更新尚未命中的通道
+                __m128i fresh = _mm_and_si128(_mm_castps_si128(lanes),
+                                              _mm_cmpeq_epi32(hit, _mm_set1_epi32(-1)));
+                hit = _mm_or_si128(_mm_andnot_si128(fresh, hit),
+                                   _mm_and_si128(fresh, _mm_set1_epi32(t)));
+                found |= mask;
+            }
+        }
+        _mm_storeu_si128((__m128i*)(firstHit + i), hit);
+        for (int k = 0; k < 4; k++) {
+            hitCount += (found >> k) & 1;
+        }
+    }
+    return hitCount + overlapBoxesScalar(posX + i, posY + i, radius + i, count - i, boxes,
+                                         targetCount, firstHit + i);
+}
+
+//目标在外、查找在内：同一目标与各组查找的比较互不依赖，不会排成一条等待上一次结果的长链
+static void
+nearestTargetsSSE2(const float* queryX, const float* queryY, const uint32_t* queryMask,
+                   int queryCount, const float* targetX, const float* targetY,
+                   const uint32_t* targetCategory, const int32_t* ids, int targetCount,
+                   float* best, int32_t* out)
+{
+    resetNearest(queryCount, best, out);
+    __m128i zero = _mm_setzero_si128();
+    for (int t = 0; t < targetCount; t++) {
+        __m128 x = _mm_set1_ps(targetX[t]);
+        __m128 y = _mm_set1_ps(targetY[t]);
+        __m128i category = _mm_set1_epi32(targetCategory[t]);
+        int32_t id = ids ? ids[t] : t;
+        __m128i vid = _mm_set1_epi32(id);
+        int q = 0;
+        for (; q + 4 <= queryCount; q += 4) {
+            __m128 dx = _mm_sub_ps(x, _mm_loadu_ps(queryX + q));
+            __m128 dy = _mm_sub_ps(y, _mm_loadu_ps(queryY + q));
+            __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 b = _mm_loadu_ps(best + q);
+            __m128i mask = _mm_loadu_si128((const __m128i*)(queryMask + q));
+            __m128i miss = _mm_cmpeq_epi32(_mm_and_si128(mask, category), zero);
+            __m128i closer = _mm_andnot_si128(miss, _mm_castps_si128(_mm_cmplt_ps(d, b)));
+            __m128 keep = _mm_castsi128_ps(closer);
+            __m128i found = _mm_loadu_si128((const __m128i*)(out + q));
+            _mm_storeu_ps(best + q, _mm_or_ps(_mm_andnot_ps(keep, b), _mm_and_ps(keep, d)));
+            _mm_storeu_si128((__m128i*)(out + q), _mm_or_si128(_mm_andnot_si128(closer, found),
+                                                               _mm_and_si128(closer, vid)));
+        }
+        closerTargetScalar(queryX, queryY, queryMask, q, queryCount, targetX[t], targetY[t],
+                           targetCategory[t], id, best, out);
+    }
+}
+
+static const BulletKernels sse2Kernels = { "sse2", advanceSSE2, integrateSSE2, cullOutsideSSE2,
+                                           overlapBoxesSSE2, nearestTargetsSSE2 };
+
+#endif // BULLET_KERNELS_SSE2
+
+#ifdef BULLET_KERNELS_AVX2
+
+BULLET_TARGET_AVX2 static void
+advanceAVX2(float* age, float* rotation, const float* startRotation, const float* spin, int count,
+            float dt)
+{
+    int i = 0;
+    __m256 vdt = _mm256_set1_ps(dt);
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(age + i), vdt);
+        _mm256_storeu_ps(age + i, a);
+        __m256 r = _mm256_add_ps(_mm256_loadu_ps(startRotation + i),
+                                 _mm256_mul_ps(_mm256_loadu_ps(spin + i), a));
+        _mm256_storeu_ps(rotation + i, r);
+    }
+    advanceScalar(age + i, rotation + i, startRotation + i, spin + i, count - i, dt);
+}
+
+BULLET_TARGET_AVX2 static void
+integrateAVX2(float* posX, float* posY, const float* originX, const float* originY,
+              const float* velX, const float* velY, const float* age, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(age + i);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(originX + i),
+                                 _mm256_mul_ps(_mm256_loadu_ps(velX + i), a));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(originY + i),
+                                 _mm256_mul_ps(_mm256_loadu_ps(velY + i), a));
+        _mm256_storeu_ps(posX + i, x);
+        _mm256_storeu_ps(posY + i, y);
+    }
+    integrateScalar(posX + i, posY + i, originX + i, originY + i, velX + i, velY + i, age + i,
+                    count - i);
+}
+
+BULLET_TARGET_AVX2 static int
+cullOutsideAVX2(const float* posX, const float* posY, int count, float minX, float minY,
+                float maxX, float maxY, uint8_t* outside)
+{
+    int culled = 0;
+    int i = 0;
+    __m256 x0 = _mm256_set1_ps(minX);
+    __m256 y0 = _mm256_set1_ps(minY);
+    __m256 x1 = _mm256_set1_ps(maxX);
+    __m256 y1 = _mm256_set1_ps(maxY);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(posX + i);
+        __m256 y = _mm256_loadu_ps(posY + i);
+        __m256 out = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(x, x0, _CMP_LT_OQ), _mm256_cmp_ps(x, x1, _CMP_GT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(y, y0, _CMP_LT_OQ), _mm256_cmp_ps(y, y1, _CMP_GT_OQ)));
+        int mask = _mm256_movemask_ps(out);
+        for (int k = 0; k < 8; k++) {
+            outside[i + k] = (mask >> k) & 1;
+            culled += (mask >> k) & 1;
+        }
+    }
+    return culled + cullOutsideScalar(posX + i, posY + i, count - i, minX, minY, maxX, maxY,
+                                      outside + i);
+}
+
+BULLET_TARGET_AVX2 static int
+overlapBoxesAVX2(const float* posX, const float* posY, const float* radius, int count,
+                 const float* boxes, int targetCount, int32_t* firstHit)
+{
+    int hitCount = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(posX + i);
+        __m256 y = _mm256_loadu_ps(posY + i);
+        __m256 r = _mm256_loadu_ps(radius + i);
+        __m256 r2 = _mm256_mul_ps(r, r);
+        __m256i hit = _mm256_set1_epi32(-1);
+        int found = 0;
+        for (int t = 0; t < targetCount && found != 0xFF; t++) {
+            const float* box = boxes + t * 4;
+            __m256 cx = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(box[0])),
+                                      _mm256_set1_ps(box[2]));
+            __m256 cy = _mm256_min_ps(_mm256_max_ps(y, _mm256_set1_ps(box[1])),
+                                      _mm256_set1_ps(box[3]));
+            __m256 dx = _mm256_sub_ps(x, cx);
+            __m256 dy = _mm256_sub_ps(y, cy);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 lanes = _mm256_cmp_ps(d2, r2, _CMP_LE_OQ);
+            int mask = _mm256_movemask_ps(lanes) & ~found;
+            if (mask) {
+                //只更新尚未命中的通道
+                __m256i fresh = _mm256_and_si256(_mm256_castps_si256(lanes),
+                                                 _mm256_cmpeq_epi32(hit, _mm256_set1_epi32(-1)));
+                hit = _mm256_blendv_epi8(hit, _mm256_set1_epi32(t), fresh);
+                found |= mask;
+            }
+        }
+        _mm256_storeu_si256((__m256i*)(firstHit + i), hit);
+        for (int k = 0; k < 8; k++) {
+            hitCount += (found >> k) & 1;
+        }
+    }
+    return hitCount + overlapBoxesScalar(posX + i, posY + i, radius + i, count - i, boxes,
+                                         targetCount, firstHit + i);
+}
+
+BULLET_TARGET_AVX2 static void
+nearestTargetsAVX2(const float* queryX, const float* queryY, const uint32_t* queryMask,
+                   int queryCount, const float* targetX, const float* targetY,
+                   const uint32_t* targetCategory, const int32_t* ids, int targetCount,
+                   float* best, int32_t* out)
+{
+    resetNearest(queryCount, best, out);
+    __m256i zero = _mm256_setzero_si256();
+    for (int t = 0; t < targetCount; t++) {
+        __m256 x = _mm256_set1_ps(targetX[t]);
+        __m256 y = _mm256_set1_ps(targetY[t]);
+        __m256i category = _mm256_set1_epi32(targetCategory[t]);
+        int32_t id = ids ? ids[t] : t;
+        int q = 0;
+        for (; q + 8 <= queryCount; q += 8) {
+            __m256 dx = _mm256_sub_ps(x, _mm256_loadu_ps(queryX + q));
+            __m256 dy = _mm256_sub_ps(y, _mm256_loadu_ps(queryY + q));
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 b = _mm256_loadu_ps(best + q);
+            __m256i mask = _mm256_loadu_si256((const __m256i*)(queryMask + q));
+            __m256i miss = _mm256_cmpeq_epi32(_mm256_and_si256(mask, category), zero);
+            __m256i closer =
+                _mm256_andnot_si256(miss, _mm256_castps_si256(_mm256_cmp_ps(d, b, _CMP_LT_OQ)));
+            __m256i found = _mm256_loadu_si256((const __m256i*)(out + q));
+            _mm256_storeu_ps(best + q, _mm256_blendv_ps(b, d, _mm256_castsi256_ps(closer)));
+            _mm256_storeu_si256((__m256i*)(out + q),
+                                _mm256_blendv_epi8(found, _mm256_set1_epi32(id), closer));
+        }
+        closerTargetScalar(queryX, queryY, queryMask, q, queryCount, targetX[t], targetY[t],
+                           targetCategory[t], id, best, out);
+    }
+}
+
+static const BulletKernels avx2Kernels = { "avx2", advanceAVX2, integrateAVX2, cullOutsideAVX2,
+                                           overlapBoxesAVX2, nearestTargetsAVX2 };
+
+static bool
+cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // BULLET_KERNELS_AVX2
+
+#ifdef BULLET_KERNELS_NEON
+
+static void
+advanceNEON(float* age, float* rotation, const float* startRotation, const float* spin, int count,
+            float dt)
+{
+    int i = 0;
+    float32x4_t vdt = vdupq_n_f32(dt);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t a = vaddq_f32(vld1q_f32(age + i), vdt);
+        vst1q_f32(age + i, a);
+        vst1q_f32(rotation + i,
+                  vaddq_f32(vld1q_f32(startRotation + i), vmulq_f32(vld1q_f32(spin + i), a)));
+    }
+    advanceScalar(age + i, rotation + i, startRotation + i, spin + i, count - i, dt);
+}
+
+static void
+integrateNEON(float* posX, float* posY, const float* originX, const float* originY,
+              const float* velX, const float* velY, const float* age, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t a = vld1q_f32(age + i);
+        vst1q_f32(posX + i, vaddq_f32(vld1q_f32(originX + i), vmulq_f32(vld1q_f32(velX + i), a)));
+        vst1q_f32(posY + i, vaddq_f32(vld1q_f32(originY + i), vmulq_f32(vld1q_f32(velY + i), a)));
+    }
+    integrateScalar(posX + i, posY + i, originX + i, originY + i, velX + i, velY + i, age + i,
+                    count - i);
+}
+
+static int
+cullOutsideNEON(const float* posX, const float* posY, int count, float minX, float minY,
+                float maxX, float maxY, uint8_t* outside)
+{
+    int culled = 0;
+    int i = 0;
+    float32x4_t x0 = vdupq_n_f32(minX);
+    float32x4_t y0 = vdupq_n_f32(minY);
+    float32x4_t x1 = vdupq_n_f32(maxX);
+    float32x4_t y1 = vdupq_n_f32(maxY);
+    uint32_t lanes[4];
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(posX + i);
+        float32x4_t y = vld1q_f32(posY + i);
+        uint32x4_t out = vorrq_u32(vorrq_u32(vcltq_f32(x, x0), vcgtq_f32(x, x1)),
+                                   vorrq_u32(vcltq_f32(y, y0), vcgtq_f32(y, y1)));
+        vst1q_u32(lanes, vshrq_n_u32(out, 31));
+        for (int k = 0; k < 4; k++) {
+            outside[i + k] = (uint8_t)lanes[k];
+            culled += lanes[k];
+        }
+    }
+    return culled + cullOutsideScalar(posX + i, posY + i, count - i, minX, minY, maxX, maxY,
+                                      outside + i);
+}
+
+static int
+overlapBoxesNEON(const float* posX, const float* posY, const float* radius, int count,
+                 const float* boxes, int targetCount, int32_t* firstHit)
+{
+    int hitCount = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(posX + i);
+        float32x4_t y = vld1q_f32(posY + i);
+        float32x4_t r = vld1q_f32(radius + i);
+        float32x4_t r2 = vmulq_f32(r, r);
+        int32x4_t hit = vdupq_n_s32(-1);
+        uint32x4_t found = vdupq_n_u32(0);
+        for (int t = 0; t < targetCount; t++) {
+            const float* box = boxes + t * 4;
+            float32x4_t cx = vminq_f32(vmaxq_f32(x, vdupq_n_f32(box[0])), vdupq_n_f32(box[2]));
+            float32x4_t cy = vminq_f32(vmaxq_f32(y, vdupq_n_f32(box[1])), vdupq_n_f32(box[3]));
+            float32x4_t dx = vsubq_f32(x, cx);
+            float32x4_t dy = vsubq_f32(y, cy);
+            float32x4_t d2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+            uint32x4_t fresh = vbicq_u32(vcleq_f32(d2, r2), found);
+            hit = vbslq_s32(fresh, vdupq_n_s32(t), hit);
+            found = vorrq_u32(found, fresh);
+        }
+        vst1q_s32(firstHit + i, hit);
+        for (int k = 0; k < 4; k++) {
+            hitCount += firstHit[i + k] >= 0 ? 1 : 0;
+        }
+    }
+    return hitCount + overlapBoxesScalar(posX + i, posY + i, radius + i, count - i, boxes,
+                                         targetCount, firstHit + i);
+}
+
+static void
+nearestTargetsNEON(const float* queryX, const float* queryY, const uint32_t* queryMask,
+                   int queryCount, const float* targetX, const float* targetY,
+                   const uint32_t* targetCategory, const int32_t* ids, int targetCount,
+                   float* best, int32_t* out)
+{
+    resetNearest(queryCount, best, out);
+    for (int t = 0; t < targetCount; t++) {
+        float32x4_t x = vdupq_n_f32(targetX[t]);
+        float32x4_t y = vdupq_n_f32(targetY[t]);
+        uint32x4_t category = vdupq_n_u32(targetCategory[t]);
+        int32_t id = ids ? ids[t] : t;
+        int q = 0;
+        for (; q + 4 <= queryCount; q += 4) {
+            float32x4_t dx = vsubq_f32(x, vld1q_f32(queryX + q));
+            float32x4_t dy = vsubq_f32(y, vld1q_f32(queryY + q));
+            float32x4_t d = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+            float32x4_t b = vld1q_f32(best + q);
+            uint32x4_t closer =
+                vandq_u32(vtstq_u32(vld1q_u32(queryMask + q), category), vcltq_f32(d, b));
+            vst1q_f32(best + q, vbslq_f32(closer, d, b));
+            vst1q_s32(out + q, vbslq_s32(closer, vdupq_n_s32(id), vld1q_s32(out + q)));
+        }
+        closerTargetScalar(queryX, queryY, queryMask, q, queryCount, targetX[t], targetY[t],
+                           targetCategory[t], id, best, out);
+    }
+}
+
+static const BulletKernels neonKernels = { "neon", advanceNEON, integrateNEON, cullOutsideNEON,
+                                           overlapBoxesNEON, nearestTargetsNEON };
+
+#endif // BULLET_KERNELS_NEON
+
+static const BulletKernels*
+selectBulletKernels()
+{
+#ifdef BULLET_KERNELS_AVX2
+    if (cpuHasAVX2()) {
+        return &avx2Kernels;
+    }
+#endif
+#ifdef BULLET_KERNELS_SSE2
+    return &sse2Kernels;
+#endif
+#ifdef BULLET_KERNELS_NEON
+    return &neonKernels; // NEON 按编译目标决定，armeabi 下不会编入
+#endif
+    return &scalarKernels;
+}
+
+const BulletKernels&
+getBulletKernels()
+{
+    static const BulletKernels* kernels = selectBulletKernels();
+    return *kernels;
+}
+
+const BulletKernels&
+getScalarBulletKernels()
+{
+    return scalarKernels;
+}
+
+int
+getAvailableBulletKernels(const BulletKernels** out, int maxCount)
+{
+    int n = 0;
+    if (n < maxCount) {
+        out[n++] = &scalarKernels;
+    }
+#ifdef BULLET_KERNELS_SSE2
+    if (n < maxCount) {
+        out[n++] = &sse2Kernels;
+    }
+#endif
+#ifdef BULLET_KERNELS_AVX2
+    if (n < maxCount && cpuHasAVX2()) {
+        out[n++] = &avx2Kernels;
+    }
+#endif
+#ifdef BULLET_KERNELS_NEON
+    if (n < maxCount) {
+        out[n++] = &neonKernels;
+    }
+#endif
+    return n;
+}
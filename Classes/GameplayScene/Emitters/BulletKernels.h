@@ -0,0 +1,56 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_KERNELS_H
+#define BULLET_KERNELS_H
+
+#include <cstdint>
+
+/* 子弹场的批量计算内核
+ *
+ *  + 提供标量、SSE2、AVX2（x86）与 NEON（arm）实现，启动时按 CPU 特性选择一次
+ *  + 各实现的运算顺序相同且不使用乘加融合，结果与标量版本逐位一致
+ *  + 数组为结构数组中的连续片段，不要求对齐
+ */
+
+struct BulletKernels
+{
+    const char* name;
+
+    /* age += dt; rotation = startRotation + spin * age */
+    void (*advance)(float* age, float* rotation, const float* startRotation, const float* spin,
+                    int count, float dt);
+
+    /* pos = origin + vel * age */
+    void (*integrate)(float* posX, float* posY, const float* originX, const float* originY,
+                      const float* velX, const float* velY, const float* age, int count);
+
+    /* 位于矩形 [minX, maxX] x [minY, maxY] 之外的子弹 outside[i] 置 1，否则置 0，返回界外数 */
+    int (*cullOutside)(const float* posX, const float* posY, int count, float minX, float minY,
+                       float maxX, float maxY, uint8_t* outside);
+
+    /* 圆与 targetCount 个盒子（每个盒子依次为 minX, minY, maxX, maxY）相交检测，
+       firstHit[i] 为第一个相交盒子的序号，没有则为 -1，返回命中数 */
+    int (*overlapBoxes)(const float* posX, const float* posY, const float* radius, int count,
+                        const float* boxes, int targetCount, int32_t* firstHit);
+
+    /* queryCount 个查找各自在 targetCount 个目标中取种别与 mask 相交、距离平方最小者，
+       out[q] 为其 ids 中的值（ids 为空时即目标序号），没有则为 -1，best[q] 为距离平方；
+       距离相同时取序号小的目标 */
+    void (*nearestTargets)(const float* queryX, const float* queryY, const uint32_t* queryMask,
+                           int queryCount, const float* targetX, const float* targetY,
+                           const uint32_t* targetCategory, const int32_t* ids, int targetCount,
+                           float* best, int32_t* out);
+};
+
+/* 按 CPU 特性选出的内核，首次调用时检测 */
+const BulletKernels& getBulletKernels();
+
+/* 标量内核，作为各 SIMD 实现的对照 */
+const BulletKernels& getScalarBulletKernels();
+
+/* 当前平台编译进来的全部内核（含标量），返回个数，供基准与校验使用 */
+int getAvailableBulletKernels(const BulletKernels** out, int maxCount);
+
+#endif // BULLET_KERNELS_H
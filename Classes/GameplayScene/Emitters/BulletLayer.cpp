@@ -0,0 +1,225 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletLayer.h"
+#include "GameplayScene/common.h"
+
+// 拾取物：纹理帧、判定半径、灵力
+#define PICKUP_FRAME "b1_14_8.png"
+#define PICKUP_RADIUS 12.0f
+#define PICKUP_MANA 1
+
+bool
+BulletLayer::init()
+{
+    if (!Node::init()) {
+        return false;
+    }
+
+    this->setName("bulletLayer");
+    simulation.setPlayerCategory(playerCategory);
+    setArea(Rect(Vec2::ZERO, Director::getInstance()->getWinSize())); //进入区域前先以窗口大小代替
+
+    //拾取物也是子弹场中的子弹，纹理与判定取自单独的原型，只对自机生效
+    BulletConfig pickup;
+    pickup.name = PICKUP_FRAME;
+    pickup.harm = PICKUP_MANA;
+    pickup.length = (int)(PICKUP_RADIUS * 2);
+    pickup.width = (int)(PICKUP_RADIUS * 2);
+    pickup._categoryBitmask = 0;
+    pickup._collisionBitmask = 0;
+    pickup._contactTestBitmask = playerCategory;
+    pickup.homing = 0;
+    pickup.trail = false;
+    pickupArchetype = ArchetypeRegistry::getInstance()->intern(pickup);
+    auto& archetype = ArchetypeRegistry::getInstance()->get(pickupArchetype);
+    BulletTraits traits;
+    traits.archetype = archetype.id;
+    traits.ownerMask = 0;
+    traits.hitMask = archetype.contactMask;
+    traits.radius = archetype.radius;
+    traits.damage = archetype.damage;
+    traits.despawn = 0;
+    traits.priority = BulletPriority::PLAYER;
+    simulation.setPickupTraits(traits);
+
+    bulletRenderer = BulletRenderer::create();
+    bulletRenderer->setSimulation(&simulation);
+    this->addChild(bulletRenderer);
+
+    this->scheduleUpdate();
+
+    return true;
+}
+
+BulletLayer*
+BulletLayer::getLayerOf(Node* mapLayer)
+{
+    return static_cast<BulletLayer*>(mapLayer->getChildByName("bulletLayer"));
+}
+
+int
+BulletLayer::addBullet(unsigned short archetypeId, const Trajectory& trajectory, float life,
+                       StyleLifetime* owner, unsigned int ownerMask, const DespawnPolicy& despawn,
+                       float age, BulletPriority priority)
+{
+    auto& archetype = ArchetypeRegistry::getInstance()->get(archetypeId);
+    BulletTraits traits;
+    traits.archetype = archetype.id;
+    traits.ownerMask = ownerMask;
+    traits.hitMask = archetype.contactMask;
+    traits.radius = archetype.radius;
+    traits.damage = archetype.damage;
+    traits.despawn = 0;
+    traits.priority = priority;
+    return simulation.addBullet(trajectory, life, traits, despawn, archetype.homing,
+                                archetype.trail, owner, age);
+}
+
+SlotHandle
+BulletLayer::addBeam(unsigned short archetypeId, const LaserBeam& beam, StyleLifetime* owner,
+                     unsigned int ownerMask)
+{
+    auto& archetype = ArchetypeRegistry::getInstance()->get(archetypeId);
+    BulletTraits traits;
+    traits.archetype = archetype.id;
+    traits.ownerMask = ownerMask;
+    traits.hitMask = archetype.contactMask;
+    traits.radius = 0;
+    traits.damage = archetype.damage;
+    traits.despawn = 0;
+    traits.priority = BulletPriority::PLAYER;
+    return simulation.addBeam(beam, traits, owner);
+}
+
+void
+BulletLayer::setArea(const Rect& area)
+{
+    this->area = area;
+    simulation.setArea(area.getMinX(), area.getMinY(), area.size.width, area.size.height);
+}
+
+int
+BulletLayer::cancelBullets(unsigned int ownerMask, const Rect& region)
+{
+    return simulation.cancelBullets(ownerMask, region.getMinX(), region.getMinY(),
+                                    region.getMaxX(), region.getMaxY());
+}
+
+void
+BulletLayer::update(float dt)
+{
+    //摄像机以 Follow 移动 mapLayer，可见范围换算到本层坐标
+    auto director = Director::getInstance();
+    Vec2 origin = this->convertToNodeSpace(director->getVisibleOrigin());
+    Size size = director->getVisibleSize();
+    simulation.setViewport(origin.x, origin.y, origin.x + size.width, origin.y + size.height);
+
+    collectTargets();
+    simulation.update(dt);
+    collectHits();
+    dispatchHits();
+    simulation.removeDead();
+}
+
+/* 取角色刚体的盒子（忽略索敌框），以节点位置为中心 */
+static bool
+getTargetBox(Node* target, Rect& box)
+{
+    auto body = target->getPhysicsBody();
+    if (nullptr == body) {
+        return false;
+    }
+    for (auto shape : body->getShapes()) {
+        if (shape->getTag() == lockCategoryTag) {
+            continue;
+        }
+        auto boxShape = dynamic_cast<PhysicsShapeBox*>(shape);
+        if (boxShape) {
+            auto size = boxShape->getSize();
+            auto center = target->getPosition() + boxShape->getOffset();
+            box.setRect(center.x - size.width / 2, center.y - size.height / 2, size.width,
+                        size.height);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+BulletLayer::collectTargets()
+{
+    //节点只能在主线程访问，每帧把敌人与角色及其盒子交给模拟一次
+    simulation.clearTargets();
+    targets.clear();
+    categories.clear();
+    if (nullptr == this->getParent()) {
+        return;
+    }
+    for (auto child : this->getParent()->getChildren()) {
+        unsigned int category;
+        if (child->getTag() == enemyCategoryTag) {
+            category = enemyCategory;
+        } else if (child->getTag() == playerCategoryTag) {
+            category = playerCategory;
+        } else {
+            continue;
+        }
+
+        Rect box;
+        auto pos = child->getPosition();
+        if (getTargetBox(child, box)) {
+            float bounds[4] = { box.getMinX(), box.getMinY(), box.getMaxX(), box.getMaxY() };
+            simulation.addTarget(pos.x, pos.y, category, bounds, child);
+        } else {
+            simulation.addTarget(pos.x, pos.y, category, nullptr, child);
+        }
+        targets.push_back(child);
+        categories.push_back(category);
+    }
+}
+
+void
+BulletLayer::collectHits()
+{
+    hits.clear();
+    grazes.clear();
+    pickups.clear();
+
+    for (auto& h : simulation.getHits()) {
+        BulletHit hit;
+        hit.position = Vec2(h.x, h.y);
+        hit.target = targets[h.target];
+        hit.category = categories[h.target];
+        hit.damage = h.damage;
+        hits.push_back(hit);
+    }
+    for (auto& g : simulation.getGrazes()) {
+        grazes.push_back(BulletGraze{ targets[g.target], g.count });
+    }
+    for (auto& p : simulation.getPickups()) {
+        pickups.push_back(BulletPickup{ targets[p.target], p.count, p.mana });
+    }
+}
+
+void
+BulletLayer::dispatchHits()
+{
+    //整批抛出，处理过程中可能移除角色，因此放在遍历之后
+    if (!hits.empty()) {
+        EventCustom event("bullet_hits");
+        event.setUserData((void*)&hits);
+        _eventDispatcher->dispatchEvent(&event);
+    }
+    if (!grazes.empty()) {
+        EventCustom event("bullet_grazes");
+        event.setUserData((void*)&grazes);
+        _eventDispatcher->dispatchEvent(&event);
+    }
+    if (!pickups.empty()) {
+        EventCustom event("bullet_pickups");
+        event.setUserData((void*)&pickups);
+        _eventDispatcher->dispatchEvent(&event);
+    }
+}
@@ -0,0 +1,134 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_LAYER_H
+#define BULLET_LAYER_H
+
+#include "BulletArchetype.h"
+#include "BulletRenderer.h"
+#include "BulletSimulation.h"
+#include "LaserBeam.h"
+#include "StyleLifetime.h"
+#include "cocos2d.h"
+
+#include <vector>
+
+USING_NS_CC;
+
+/* 一次命中记录，每帧汇总后以 "bullet_hits" 事件整批抛出 */
+struct BulletHit
+{
+    Vec2 position;         //子弹命中时的位置
+    Node* target;          //被命中的角色
+    unsigned int category; //目标种别，enemyCategory 或 playerCategory
+    int damage;
+};
+
+/* 一个角色本帧的擦弹数，每帧汇总后以 "bullet_grazes" 事件整批抛出 */
+struct BulletGraze
+{
+    Node* target; //擦弹的角色
+    int count;
+};
+
+/* 一个角色本帧拾取的拾取物，每帧汇总后以 "bullet_pickups" 事件整批抛出 */
+struct BulletPickup
+{
+    Node* target; //拾取的角色
+    int count;
+    int mana; //拾取物带来的灵力之和
+};
+
+/* 子弹层：mapLayer 的子节点，持有整个场景的 BulletSimulation
+ *
+ *  + 所有弹幕发射的子弹都写入同一个子弹场，每帧只推进一次；推进、出界回收、追踪、拾取物、
+ *    子弹预算与命中检测都在 BulletSimulation 中，与 bullet_bench、pattern_sim 共用同一份代码
+ *  + 本层每帧把 mapLayer 下的敌人与角色连同刚体的盒子交给模拟，把命中结果换回节点后
+ *    以 "bullet_hits"、"bullet_grazes"、"bullet_pickups" 事件整批抛出
+ *  + 子弹不是节点，不进入场景树：纹理取自原型，缩放记在子弹场，由 BulletRenderer 按图集合批绘制；
+ *    发射与回收不增删子节点，离场时只把子弹场中的句柄交还发射它的弹幕（StyleLifetime）
+ *  + 激光以 addBeam 登记到模拟，同样不是节点：由 BulletRenderer 与子弹一起绘制，命中与子弹命中
+ *    一并抛出
+ *  + cancelBullets 把子弹就地改写为飞向自机的拾取物，只换成拾取物的原型
+ *  + 随 mapLayer 一起暂停（设置界面会调用 mapLayer->onExit）
+ */
+
+class BulletLayer : public Node
+{
+public:
+    CREATE_FUNC(BulletLayer);
+    virtual bool init() override;
+    virtual void update(float dt) override;
+
+    /* 在 mapLayer 下查找子弹层 */
+    static BulletLayer* getLayerOf(Node* mapLayer);
+
+    /* 发射一颗原型为 archetype 的子弹，按轨迹飞行 life 秒；age 为发射时已经过的时间。
+     * 子弹登记到 owner 的子弹表，离场时交还。返回子弹场中的下标（到下一帧前有效），
+     * 超出子弹预算被拒绝时返回 -1 */
+    int addBullet(unsigned short archetype, const Trajectory& trajectory, float life,
+                  StyleLifetime* owner = nullptr, unsigned int ownerMask = 0,
+                  const DespawnPolicy& despawn = DespawnPolicy(), float age = 0,
+                  BulletPriority priority = BulletPriority::AIMED);
+
+    /* 立即移除一颗子弹（击中目标等），条目在下一帧移除 */
+    void removeBullet(int index) { simulation.removeBullet(index); }
+
+    /* 移除所有子弹 */
+    void clearBullets() { simulation.clearBullets(); }
+
+    /* 发射一条纹理与伤害取自原型 archetype 的激光，每个目标只命中一次。激光登记到 owner，
+     * 消散后交还；返回的句柄以 getSimulation().getBeam 更新起点，激光移除后取得空指针 */
+    SlotHandle addBeam(unsigned short archetype, const LaserBeam& beam,
+                       StyleLifetime* owner = nullptr, unsigned int ownerMask = 0);
+
+    /* 消弹：发射方属于 ownerMask、位于 region 内的子弹全部转为拾取物，返回转换的子弹数
+     *
+     *  + 对子弹场只遍历一次，子弹就地换成拾取物的原型，并交还发射它的弹幕
+     *  + 拾取物先向上弹出，随后被最近的自机吸引，碰到自机时随 bullet_pickups 事件抛出
+     *  + Boss 转阶段、符卡等调用；激光不在子弹场中，不受影响 */
+    int cancelBullets(unsigned int ownerMask, const Rect& region);
+
+    /* 命中检测网格覆盖的区域与格子边长 */
+    void setArea(const Rect& area);
+    const Rect& getArea() const { return area; }
+    void setCellSize(float cellSize) { simulation.setCellSize(cellSize); }
+
+    /* 同屏子弹预算，0 为不限；setQuality 按画质档位设定 */
+    void setBudget(int budget) { simulation.setBudget(budget); }
+    int getBudget() const { return simulation.getBudget(); }
+    void setQuality(QualityTier tier) { simulation.setQuality(tier); }
+
+    /* 擦弹距离：子弹判定圆与自机盒子的间距小于该值且未命中即为擦弹，0 时不检测 */
+    void setGrazeRadius(float radius) { simulation.setGrazeRadius(radius); }
+    float getGrazeRadius() const { return simulation.getGrazeRadius(); }
+
+    BulletSimulation& getSimulation() { return simulation; }
+    BulletField& getField() { return simulation.getField(); }
+    BulletRenderer* getRenderer() const { return bulletRenderer; }
+    const std::vector<BulletHit>& getHits() const { return hits; }
+    const std::vector<BulletGraze>& getGrazes() const { return grazes; }
+    const std::vector<BulletPickup>& getPickups() const { return pickups; }
+    const DespawnStats& getDespawnStats() const { return simulation.getDespawnStats(); }
+    const BulletBudgetStats& getBudgetStats() const { return simulation.getBudgetStats(); }
+
+private:
+    void collectTargets();
+    void collectHits();
+    void dispatchHits();
+
+private:
+    BulletSimulation simulation;
+    unsigned short pickupArchetype; //拾取物的原型
+    BulletRenderer* bulletRenderer;
+    Rect area;
+
+    std::vector<Node*> targets;           //本帧交给模拟的目标，下标即目标编号
+    std::vector<unsigned int> categories; //各目标的种别
+    std::vector<BulletHit> hits;
+    std::vector<BulletGraze> grazes;
+    std::vector<BulletPickup> pickups;
+};
+
+#endif // BULLET_LAYER_H
@@ -0,0 +1,361 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 单条命令的子弹数上限，使顶点数低于 Renderer 的 VBO 容量（65536）
+#define BULLET_RENDERER_MAX_QUADS 8192
+// 单条拖尾命令的顶点上限，须能以 unsigned short 索引
+#define BULLET_RENDERER_MAX_TRAIL_VERTICES 32768
+// 拖尾每帧的默认顶点预算，约 1000 条完整的拖尾
+#define BULLET_TRAIL_VERTEX_BUDGET 16384
+// 拖尾最新一段的不透明度，相对子弹本身
+#define BULLET_TRAIL_ALPHA 0.6f
+// 激光预警时的不透明度
+#define BULLET_BEAM_WARMUP_ALPHA (128.0f / 255.0f)
+
+bool
+BulletRenderer::init()
+{
+    if (!Node::init()) {
+        return false;
+    }
+
+    this->simulation = nullptr;
+    this->field = nullptr;
+    this->usedBatches = 0;
+    this->usedTrailBatches = 0;
+    this->trailVertexBudget = BULLET_TRAIL_VERTEX_BUDGET;
+    this->stats = Stats{ 0, 0, 0, 0, 0, 0, 0 };
+    this->setName("bulletRenderer");
+    this->setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(
+        GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+
+    return true;
+}
+
+BulletRenderer::~BulletRenderer()
+{
+    for (auto batch : batches) {
+        delete batch;
+    }
+    for (auto batch : trailBatches) {
+        delete batch;
+    }
+}
+
+void
+BulletRenderer::setSimulation(const BulletSimulation* simulation)
+{
+    this->simulation = simulation;
+    this->field = simulation ? &simulation->getField() : nullptr;
+}
+
+BulletRenderer::Batch*
+BulletRenderer::getBatch(Texture2D* texture, const BlendFunc& blendFunc)
+{
+    //图集只有几张，线性查找即可
+    for (int i = usedBatches - 1; i >= 0; i--) {
+        auto batch = batches[i];
+        if (batch->texture == texture && batch->blendFunc == blendFunc &&
+            batch->quadCount < BULLET_RENDERER_MAX_QUADS) {
+            return batch;
+        }
+    }
+
+    if (usedBatches == (int)batches.size()) {
+        batches.push_back(new Batch());
+    }
+    auto batch = batches[usedBatches++];
+    batch->texture = texture;
+    batch->blendFunc = blendFunc;
+    batch->quadCount = 0;
+    return batch;
+}
+
+BulletRenderer::TrailBatch*
+BulletRenderer::getTrailBatch(Texture2D* texture, const BlendFunc& blendFunc, int vertexCount)
+{
+    for (int i = usedTrailBatches - 1; i >= 0; i--) {
+        auto batch = trailBatches[i];
+        if (batch->texture == texture && batch->blendFunc == blendFunc &&
+            batch->vertexCount + vertexCount <= BULLET_RENDERER_MAX_TRAIL_VERTICES) {
+            return batch;
+        }
+    }
+
+    if (usedTrailBatches == (int)trailBatches.size()) {
+        trailBatches.push_back(new TrailBatch());
+    }
+    auto batch = trailBatches[usedTrailBatches++];
+    batch->texture = texture;
+    batch->blendFunc = blendFunc;
+    batch->vertexCount = 0;
+    batch->indexCount = 0;
+    return batch;
+}
+
+void
+BulletRenderer::appendTrail(int index, const BulletArchetype& archetype)
+{
+    int n = field->getTrailLength(index);
+    int remaining = trailVertexBudget - stats.trailVertexCount;
+    if (n * 2 > remaining) {
+        n = remaining / 2; //预算不足时只画最新的几段
+    }
+    if (n < 2) {
+        if (field->getTrailLength(index) >= 2) {
+            stats.droppedTrails++;
+        }
+        return;
+    }
+
+    float x[BULLET_TRAIL_LENGTH];
+    float y[BULLET_TRAIL_LENGTH];
+    for (int k = 0; k < n; k++) {
+        field->getTrailPoint(index, k, x[k], y[k]);
+    }
+
+    //各位置的法线取前后两点连线的垂直方向，停住不动的一段沿用上一段的法线
+    float nx = 0;
+    float ny = 0;
+    for (int k = 0; k + 1 < n && nx == 0 && ny == 0; k++) {
+        float dx = x[k] - x[k + 1];
+        float dy = y[k] - y[k + 1];
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length > 0) {
+            nx = -dy / length;
+            ny = dx / length;
+        }
+    }
+    if (nx == 0 && ny == 0) {
+        return; //子弹没有移动过
+    }
+
+    auto batch = getTrailBatch(archetype.texture, archetype.blendFunc, n * 2);
+    int base = batch->vertexCount;
+    if ((int)batch->vertices.size() < base + n * 2) {
+        batch->vertices.resize(base + n * 2);
+    }
+    if ((int)batch->indices.size() < batch->indexCount + (n - 1) * 6) {
+        batch->indices.resize(batch->indexCount + (n - 1) * 6);
+    }
+
+    //宽度取纹理帧的宽，纹理坐标取帧左右两边的中点，沿拖尾方向不变
+    const V3F_C4B_T2F_Quad& quad = archetype.quad;
+    float halfWidth = (quad.tr.vertices.x - quad.tl.vertices.x) * field->scale[index] / 2;
+    Tex2F left((quad.tl.texCoords.u + quad.bl.texCoords.u) / 2,
+               (quad.tl.texCoords.v + quad.bl.texCoords.v) / 2);
+    Tex2F right((quad.tr.texCoords.u + quad.br.texCoords.u) / 2,
+                (quad.tr.texCoords.v + quad.br.texCoords.v) / 2);
+    Color4B color = quad.tl.colors;
+    bool premultiplied = archetype.texture->hasPremultipliedAlpha();
+
+    V3F_C4B_T2F* dst = &batch->vertices[base];
+    for (int k = 0; k < n; k++) {
+        int a = k > 0 ? k - 1 : k;
+        int b = k + 1 < n ? k + 1 : k;
+        float dx = x[a] - x[b];
+        float dy = y[a] - y[b];
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length > 0) {
+            nx = -dy / length;
+            ny = dx / length;
+        }
+
+        //从子弹处向尾端线性收窄、变淡，最后一个位置宽度与不透明度为 0
+        float fade = 1.0f - (float)k / (n - 1);
+        float w = halfWidth * fade;
+        float alpha = BULLET_TRAIL_ALPHA * fade;
+        Color4B c = color;
+        c.a = (GLubyte)(color.a * alpha);
+        if (premultiplied) {
+            c.r = (GLubyte)(color.r * alpha);
+            c.g = (GLubyte)(color.g * alpha);
+            c.b = (GLubyte)(color.b * alpha);
+        }
+
+        dst[2 * k].vertices = Vec3(x[k] + nx * w, y[k] + ny * w, 0);
+        dst[2 * k].colors = c;
+        dst[2 * k].texCoords = left;
+        dst[2 * k + 1].vertices = Vec3(x[k] - nx * w, y[k] - ny * w, 0);
+        dst[2 * k + 1].colors = c;
+        dst[2 * k + 1].texCoords = right;
+    }
+
+    //三角形带 L0 R0 L1 R1 ... 展开为索引，各条拖尾之间不相连
+    unsigned short* out = &batch->indices[batch->indexCount];
+    for (int k = 0; k + 1 < n; k++) {
+        unsigned short l = (unsigned short)(base + 2 * k);
+        out[0] = l;
+        out[1] = (unsigned short)(l + 1);
+        out[2] = (unsigned short)(l + 2);
+        out[3] = (unsigned short)(l + 1);
+        out[4] = (unsigned short)(l + 3);
+        out[5] = (unsigned short)(l + 2);
+        out += 6;
+    }
+
+    batch->vertexCount += n * 2;
+    batch->indexCount += (n - 1) * 6;
+    stats.trailCount++;
+    stats.trailVertexCount += n * 2;
+}
+
+void
+BulletRenderer::appendBeam(const LaserBeam& beam, const BulletArchetype& archetype)
+{
+    auto batch = getBatch(archetype.texture, archetype.blendFunc);
+    int base = batch->quadCount * 4;
+    if ((int)batch->vertices.size() < base + 4) {
+        batch->vertices.resize(base + 4);
+    }
+    batch->quadCount++;
+
+    //纹理帧的下边在起点、上边在终点，宽度取当前显示宽度；dx, dy 沿光束，wx, wy 为帧的右方
+    float radians = CC_DEGREES_TO_RADIANS(beam.angle);
+    float dx = cosf(radians) * beam.length;
+    float dy = sinf(radians) * beam.length;
+    float halfWidth = beam.getVisibleWidth() / 2;
+    float wx = sinf(radians) * halfWidth;
+    float wy = -cosf(radians) * halfWidth;
+    float x = beam.originX;
+    float y = beam.originY;
+
+    const V3F_C4B_T2F_Quad& quad = archetype.quad;
+    float alpha = beam.getPhase() == LaserBeam::WARMUP ? BULLET_BEAM_WARMUP_ALPHA : 1.0f;
+    bool premultiplied = archetype.texture->hasPremultipliedAlpha();
+
+    const V3F_C4B_T2F* src[4] = { &quad.tl, &quad.bl, &quad.tr, &quad.br };
+    Vec3 corners[4] = { Vec3(x + dx - wx, y + dy - wy, 0), Vec3(x - wx, y - wy, 0),
+                        Vec3(x + dx + wx, y + dy + wy, 0), Vec3(x + wx, y + wy, 0) };
+    V3F_C4B_T2F* dst = &batch->vertices[base];
+    for (int k = 0; k < 4; k++) {
+        Color4B c = src[k]->colors;
+        c.a = (GLubyte)(c.a * alpha);
+        if (premultiplied) {
+            c.r = (GLubyte)(c.r * alpha);
+            c.g = (GLubyte)(c.g * alpha);
+            c.b = (GLubyte)(c.b * alpha);
+        }
+        dst[k].vertices = corners[k];
+        dst[k].colors = c;
+        dst[k].texCoords = src[k]->texCoords;
+    }
+    stats.beamCount++;
+}
+
+void
+BulletRenderer::buildBatches()
+{
+    usedBatches = 0;
+    usedTrailBatches = 0;
+    stats = Stats{ 0, 0, 0, 0, 0, 0, 0 };
+    if (nullptr == simulation) {
+        return;
+    }
+
+    auto registry = ArchetypeRegistry::getInstance();
+    int count = field->size();
+    for (int i = 0; i < count; i++) {
+        if (field->isDead(i)) {
+            continue;
+        }
+        auto& archetype = registry->get(field->archetype[i]);
+        if (nullptr == archetype.texture) {
+            continue; //纹理帧不存在
+        }
+        if ((field->flags[i] & BulletField::FLAG_TRAIL) != 0) {
+            appendTrail(i, archetype);
+        }
+
+        auto batch = getBatch(archetype.texture, archetype.blendFunc);
+        int base = batch->quadCount * 4;
+        if ((int)batch->vertices.size() < base + 4) {
+            batch->vertices.resize(base + 4);
+        }
+        batch->quadCount++;
+
+        //与 Node::getNodeToParentTransform 相同：顶点已以锚点为原点，再缩放、旋转（顺时针为正）、平移
+        const V3F_C4B_T2F_Quad& quad = archetype.quad;
+        float radians = -CC_DEGREES_TO_RADIANS(field->rotation[i]);
+        float scale = field->scale[i];
+        float c = cosf(radians) * scale;
+        float s = sinf(radians) * scale;
+        float tx = field->posX[i];
+        float ty = field->posY[i];
+
+        const V3F_C4B_T2F* src[4] = { &quad.tl, &quad.bl, &quad.tr, &quad.br };
+        V3F_C4B_T2F* dst = &batch->vertices[base];
+        for (int k = 0; k < 4; k++) {
+            float x = src[k]->vertices.x;
+            float y = src[k]->vertices.y;
+            dst[k].vertices = Vec3(c * x - s * y + tx, s * x + c * y + ty, 0);
+            dst[k].colors = src[k]->colors;
+            dst[k].texCoords = src[k]->texCoords;
+        }
+    }
+
+    //激光在子弹之后写入，同一图集内画在子弹上面
+    for (auto& b : simulation->getBeams()) {
+        auto& archetype = registry->get(b.traits.archetype);
+        if (nullptr == archetype.texture || b.beam.getPhase() == LaserBeam::DONE) {
+            continue;
+        }
+        appendBeam(b.beam, archetype);
+    }
+
+    //共用的索引缓冲按最大分组补齐，四个顶点的顺序为 tl, bl, tr, br
+    int maxQuads = 0;
+    for (int b = 0; b < usedBatches; b++) {
+        maxQuads = std::max(maxQuads, batches[b]->quadCount);
+        stats.quadCount += batches[b]->quadCount;
+    }
+    for (int q = (int)indices.size() / 6; q < maxQuads; q++) {
+        unsigned short v = (unsigned short)(q * 4);
+        unsigned short quadIndices[6] = { v, (unsigned short)(v + 1), (unsigned short)(v + 2),
+                                          (unsigned short)(v + 3), (unsigned short)(v + 2),
+                                          (unsigned short)(v + 1) };
+        indices.insert(indices.end(), quadIndices, quadIndices + 6);
+    }
+
+    stats.vertexCount = stats.quadCount * 4 + stats.trailVertexCount;
+    stats.commandCount = usedBatches + usedTrailBatches;
+}
+
+void
+BulletRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    buildBatches();
+
+    //同一 globalZOrder 的命令按提交顺序绘制，拖尾先提交
+    for (int b = 0; b < usedTrailBatches; b++) {
+        auto batch = trailBatches[b];
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = batch->vertices.data();
+        triangles.vertCount = batch->vertexCount;
+        triangles.indices = batch->indices.data();
+        triangles.indexCount = batch->indexCount;
+
+        batch->command.init(_globalZOrder, batch->texture->getName(), getGLProgramState(),
+                            batch->blendFunc, triangles, transform, flags);
+        renderer->addCommand(&batch->command);
+    }
+
+    for (int b = 0; b < usedBatches; b++) {
+        auto batch = batches[b];
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = batch->vertices.data();
+        triangles.vertCount = batch->quadCount * 4;
+        triangles.indices = indices.data();
+        triangles.indexCount = batch->quadCount * 6;
+
+        batch->command.init(_globalZOrder, batch->texture->getName(), getGLProgramState(),
+                            batch->blendFunc, triangles, transform, flags);
+        renderer->addCommand(&batch->command);
+    }
+}
@@ -0,0 +1,102 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_RENDERER_H
+#define BULLET_RENDERER_H
+
+#include "BulletArchetype.h"
+#include "BulletSimulation.h"
+#include "cocos2d.h"
+
+#include <vector>
+
+USING_NS_CC;
+
+/* 子弹批量绘制节点：BulletLayer 的子节点，整个子弹场与所有激光只由它绘制
+ *
+ *  + 子弹不是节点：每帧从子弹场读取位置、角度与缩放，从原型（BulletArchetype）读取纹理、
+ *    混合方式与顶点，在 CPU 上把旋转、缩放写进顶点，按（纹理，混合方式）合并为一条 TrianglesCommand
+ *  + 同一图集的子弹只产生一条绘制命令，超过单条命令的顶点上限时才拆分
+ *  + 顶点与索引缓冲跨帧复用，只增不减
+ *  + 统计数据只在 CPU 侧计算，不需要 GPU 即可检查
+ *  + 带拖尾的子弹按子弹场中记录的历史位置生成一条逐渐变细、变淡的三角形带，取子弹纹理帧
+ *    中间一行的纹素；同一图集的拖尾合并为一条命令，先于子弹提交，画在子弹下面
+ *  + 拖尾每帧的顶点数有上限，超出时后面的拖尾被截短或跳过，不影响子弹本身
+ *  + 激光与子弹一样取原型的纹理帧，沿光束拉伸为一个四边形，与同一图集的子弹合在一条命令中；
+ *    预警阶段半透明
+ */
+
+class BulletRenderer : public Node
+{
+public:
+    struct Stats
+    {
+        int quadCount;    //本帧绘制的子弹数
+        int vertexCount;  //本帧提交的顶点数
+        int commandCount; //本帧提交的绘制命令数
+        int trailCount;       //本帧绘制的拖尾数
+        int trailVertexCount; //本帧拖尾的顶点数，已计入 vertexCount
+        int droppedTrails;    //因顶点预算不足而跳过的拖尾数
+        int beamCount;        //本帧绘制的激光数，已计入 quadCount
+    };
+
+    CREATE_FUNC(BulletRenderer);
+    virtual bool init() override;
+    virtual ~BulletRenderer();
+
+    /* 绘制的模拟（子弹场与激光），由 BulletLayer 设置 */
+    void setSimulation(const BulletSimulation* simulation);
+
+    /* 由子弹场与激光生成本帧的顶点与命令分组，draw 时自动调用 */
+    void buildBatches();
+
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+
+    const Stats& getStats() const { return stats; }
+
+    /* 拖尾每帧的顶点预算，每个历史位置两个顶点；0 为不绘制拖尾 */
+    void setTrailVertexBudget(int budget) { trailVertexBudget = budget; }
+    int getTrailVertexBudget() const { return trailVertexBudget; }
+
+private:
+    /* 一条绘制命令对应的顶点分组 */
+    struct Batch
+    {
+        Texture2D* texture;
+        BlendFunc blendFunc;
+        int quadCount;
+        std::vector<V3F_C4B_T2F> vertices;
+        TrianglesCommand command;
+    };
+
+    /* 拖尾的顶点分组，索引按三角形带的顺序逐条写入 */
+    struct TrailBatch
+    {
+        Texture2D* texture;
+        BlendFunc blendFunc;
+        int vertexCount;
+        int indexCount;
+        std::vector<V3F_C4B_T2F> vertices;
+        std::vector<unsigned short> indices;
+        TrianglesCommand command;
+    };
+
+    Batch* getBatch(Texture2D* texture, const BlendFunc& blendFunc);
+    TrailBatch* getTrailBatch(Texture2D* texture, const BlendFunc& blendFunc, int vertexCount);
+    void appendTrail(int index, const BulletArchetype& archetype);
+    void appendBeam(const LaserBeam& beam, const BulletArchetype& archetype);
+
+private:
+    const BulletSimulation* simulation;
+    const BulletField* field;
+    std::vector<Batch*> batches; //跨帧复用，usedBatches 之后的分组本帧未使用
+    int usedBatches;
+    std::vector<unsigned short> indices; //所有分组共用，按最大分组填充
+    std::vector<TrailBatch*> trailBatches; //跨帧复用，usedTrailBatches 之后的分组本帧未使用
+    int usedTrailBatches;
+    int trailVertexBudget;
+    Stats stats;
+};
+
+#endif // BULLET_RENDERER_H
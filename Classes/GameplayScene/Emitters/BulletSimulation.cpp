@@ -0,0 +1,819 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "BulletSimulation.h"
+#include "JobSystem.h"
+#include "StyleLifetime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+// 子弹场初始预留容量
+#define BULLET_FIELD_RESERVE 1024
+// 命中检测网格默认格子边长
+#define BULLET_GRID_CELL_SIZE 64.0f
+// 回收规则的编号以 uint8_t 存入子弹场
+#define DESPAWN_POLICY_MAX 256
+// 默认擦弹距离
+#define BULLET_GRAZE_RADIUS 24.0f
+// 拾取物的寿命
+#define PICKUP_LIFE 8.0f
+// 拾取物弹出的初速度与时长，之后开始被吸引
+#define PICKUP_POP_SPEED 120.0f
+#define PICKUP_POP_TIME 0.3f
+// 拾取物被吸引时的最大速度与转向快慢（每秒）
+#define PICKUP_MAGNET_SPEED 600.0f
+#define PICKUP_MAGNET_RATE 6.0f
+// 追踪弹按格子整批挑选候选目标，格子边长
+#define HOMING_CELL_SIZE 128.0f
+// 并行出界检测时每块的子弹数
+#define BULLET_CULL_GRAIN 4096
+// 各画质档位的同屏子弹预算
+#define BULLET_BUDGET_LOW 800
+#define BULLET_BUDGET_MEDIUM 2000
+#define BULLET_BUDGET_HIGH 5000
+
+DespawnPolicy
+DespawnPolicy::area(float margin)
+{
+    DespawnPolicy policy;
+    policy.rule = AREA;
+    policy.margin = margin;
+    return policy;
+}
+
+DespawnPolicy
+DespawnPolicy::viewport(float margin)
+{
+    DespawnPolicy policy;
+    policy.rule = VIEWPORT;
+    policy.margin = margin;
+    return policy;
+}
+
+DespawnPolicy
+DespawnPolicy::age(float maxAge)
+{
+    DespawnPolicy policy;
+    policy.rule = MAX_AGE;
+    policy.maxAge = maxAge;
+    return policy;
+}
+
+BulletSimulation::BulletSimulation()
+    : pickupTraits(BulletTraits())
+    , playerCategory(0)
+    , despawnStats(DespawnStats{ 0, 0, 0, 0 })
+    , maxRadius(0)
+    , grazeRadius(BULLET_GRAZE_RADIUS)
+    , hasPickups(false)
+    , hasHoming(false)
+    , budget(0)
+    , pendingKills(0)
+    , evictableReady(false)
+    , budgetFrame(BulletBudgetStats())
+    , budgetStats(BulletBudgetStats())
+{
+    field.reserve(BULLET_FIELD_RESERVE);
+    released.reserve(BULLET_FIELD_RESERVE);
+    despawnPolicies.push_back(DespawnPolicy());
+    for (int i = 0; i < 4; i++) {
+        area[i] = 0;
+        viewport[i] = 0;
+    }
+    for (int level = 0; level < BULLET_PRIORITY_COUNT; level++) {
+        evictCursor[level] = 0;
+    }
+    setCellSize(BULLET_GRID_CELL_SIZE);
+}
+
+BulletSimulation::~BulletSimulation()
+{
+    //弹幕可能晚于子弹场销毁，只删除它们的登记，不再通知释放
+    released.clear();
+    field.clear(released);
+    for (auto& r : released) {
+        r.owner->detachBullet(r.slot);
+    }
+    for (auto& b : beams) {
+        if (b.owner) {
+            b.owner->detachBeam(b.ownerSlot);
+        }
+    }
+}
+
+int
+BulletSimulation::addBullet(const Trajectory& trajectory, float life, BulletTraits traits,
+                            const DespawnPolicy& despawn, float homing, bool trail,
+                            StyleLifetime* owner, float age)
+{
+    if (!admit(traits.priority)) {
+        return -1;
+    }
+
+    traits.despawn = (uint8_t)getDespawnIndex(despawn);
+    if (traits.radius > maxRadius) {
+        maxRadius = traits.radius;
+    }
+
+    if (despawn.rule == DespawnPolicy::MAX_AGE && despawn.maxAge < life) {
+        life = despawn.maxAge;
+    }
+
+    //追踪弹以逐段匀速飞行，曲线轨迹无法转向，仍按原轨迹飞行
+    bool steered = homing > 0 && (trajectory.type == TrajectoryType::LINEAR ||
+                                  trajectory.type == TrajectoryType::INTEGRATED);
+    Trajectory motion = trajectory;
+    if (steered) {
+        motion.type = TrajectoryType::INTEGRATED;
+    }
+
+    int index = field.spawn(motion, life, traits, owner, age);
+    if (steered) {
+        field.setHoming(index, homing);
+        hasHoming = true;
+    }
+    if (trail) {
+        field.setTrail(index);
+    }
+    if (evictableReady) {
+        evictable[(int)traits.priority].push_back(index);
+    }
+    return index;
+}
+
+bool
+BulletSimulation::admit(BulletPriority priority)
+{
+    if (budget <= 0 || field.size() - pendingKills < budget) {
+        return true;
+    }
+
+    //从最低一档开始，只挤掉优先级比新子弹低的子弹
+    if (!evictableReady) {
+        collectEvictable();
+    }
+    for (int level = 0; level < (int)priority; level++) {
+        auto& list = evictable[level];
+        while (evictCursor[level] < (int)list.size()) {
+            int i = list[evictCursor[level]++];
+            if (field.isDead(i) || (int)field.priority[i] != level ||
+                (field.flags[i] & BulletField::FLAG_PICKUP) != 0) {
+                continue; //整理之后已被移除或转为拾取物
+            }
+            removeBullet(i);
+            budgetFrame.evicted[level]++;
+            return true;
+        }
+    }
+    budgetFrame.refused[(int)priority]++;
+    return false;
+}
+
+void
+BulletSimulation::collectEvictable()
+{
+    for (int level = 0; level < BULLET_PRIORITY_COUNT; level++) {
+        evictable[level].clear();
+        evictCursor[level] = 0;
+    }
+
+    //拾取物不让位；每帧最多整理一次，之后新发射的子弹追加到末尾
+    int count = field.size();
+    for (int i = 0; i < count; i++) {
+        if (!field.isDead(i) && (field.flags[i] & BulletField::FLAG_PICKUP) == 0) {
+            evictable[(int)field.priority[i]].push_back(i);
+        }
+    }
+
+    //剩余寿命最短的先让位，它们本来也即将回收
+    for (auto& list : evictable) {
+        std::sort(list.begin(), list.end(), [this](int a, int b) {
+            return field.life[a] - field.age[a] < field.life[b] - field.age[b];
+        });
+    }
+    evictableReady = true;
+}
+
+void
+BulletSimulation::sweepBudget()
+{
+    pendingKills = 0;
+    evictableReady = false;
+    budgetFrame.limit = budget;
+    budgetFrame.live = field.size();
+    budgetStats = budgetFrame;
+    budgetFrame = BulletBudgetStats();
+}
+
+void
+BulletSimulation::setQuality(QualityTier tier)
+{
+    switch (tier) {
+        case QualityTier::LOW:
+            budget = BULLET_BUDGET_LOW;
+            break;
+        case QualityTier::MEDIUM:
+            budget = BULLET_BUDGET_MEDIUM;
+            break;
+        case QualityTier::HIGH:
+            budget = BULLET_BUDGET_HIGH;
+            break;
+    }
+}
+
+int
+BulletSimulation::getDespawnIndex(const DespawnPolicy& despawn)
+{
+    //规则只有各弹幕的几种，线性查找即可；登记满后只按寿命回收
+    int n = (int)despawnPolicies.size();
+    for (int i = 0; i < n; i++) {
+        if (despawnPolicies[i] == despawn) {
+            return i;
+        }
+    }
+    if (n >= DESPAWN_POLICY_MAX) {
+        return 0;
+    }
+    despawnPolicies.push_back(despawn);
+    return n;
+}
+
+void
+BulletSimulation::removeBullet(int index)
+{
+    if (index < 0 || index >= field.size() || field.isDead(index)) {
+        return;
+    }
+
+    //先断开子弹场与弹幕的联系再交还，弹幕可能随之释放；条目在下一次 removeDead 时移除
+    auto owner = field.owner[index];
+    field.owner[index] = nullptr;
+    field.kill(index);
+    pendingKills++;
+    if (owner) {
+        owner->releaseBullet(field.ownerSlot[index]);
+    }
+}
+
+void
+BulletSimulation::clearBullets()
+{
+    released.clear();
+    field.clear(released);
+    releaseOwners();
+    pendingKills = 0;
+    evictableReady = false;
+}
+
+void
+BulletSimulation::releaseOwners()
+{
+    //同一弹幕的子弹全部交还后弹幕才会释放，之后列表中不会再出现它
+    for (auto& r : released) {
+        r.owner->releaseBullet(r.slot);
+    }
+    released.clear();
+}
+
+void
+BulletSimulation::setArea(float x, float y, float width, float height)
+{
+    area[0] = x;
+    area[1] = y;
+    area[2] = x + width;
+    area[3] = y + height;
+    grid.setBounds(x, y, width, height, grid.getCellSize());
+    targetIndex.setBounds(x, y, width, height, HOMING_CELL_SIZE);
+}
+
+void
+BulletSimulation::setCellSize(float cellSize)
+{
+    grid.setBounds(area[0], area[1], area[2] - area[0], area[3] - area[1], cellSize);
+}
+
+void
+BulletSimulation::setViewport(float minX, float minY, float maxX, float maxY)
+{
+    viewport[0] = minX;
+    viewport[1] = minY;
+    viewport[2] = maxX;
+    viewport[3] = maxY;
+}
+
+void
+BulletSimulation::clearTargets()
+{
+    targets.clear();
+}
+
+int
+BulletSimulation::addTarget(float x, float y, unsigned int category, const float* box,
+                            const void* key)
+{
+    Target target;
+    target.x = x;
+    target.y = y;
+    target.category = category;
+    target.hasBox = box != nullptr;
+    for (int i = 0; i < 4; i++) {
+        target.bounds[i] = box ? box[i] : 0;
+    }
+    target.key = key;
+    targets.push_back(target);
+    return (int)targets.size() - 1;
+}
+
+SlotHandle
+BulletSimulation::addBeam(const LaserBeam& beam, const BulletTraits& traits,
+                          StyleLifetime* owner)
+{
+    Beam b;
+    b.beam = beam;
+    b.traits = traits;
+    b.owner = owner;
+    SlotHandle handle = beams.insert(b);
+    auto added = beams.get(handle);
+    added->handle = handle;
+    if (owner) {
+        added->ownerSlot = owner->attachBeam(this, handle);
+    }
+    return handle;
+}
+
+void
+BulletSimulation::disownBeam(SlotHandle handle)
+{
+    Beam* b = beams.get(handle);
+    if (b) {
+        b->owner = nullptr;
+    }
+}
+
+LaserBeam*
+BulletSimulation::getBeam(SlotHandle handle)
+{
+    Beam* b = beams.get(handle);
+    return b ? &b->beam : nullptr;
+}
+
+void
+BulletSimulation::update(float dt)
+{
+    attractPickups(dt);
+    steerHoming(dt);
+    field.update(dt);
+    advanceBeams(dt);
+    cullBullets();
+    resolveHits();
+    castBeams();
+}
+
+void
+BulletSimulation::removeDead()
+{
+    released.clear();
+    field.removeDead(released);
+    releaseOwners();
+    removeBeams();
+    sweepBudget();
+}
+
+void
+BulletSimulation::advanceBeams(float dt)
+{
+    for (auto& b : beams) {
+        b.beam.advance(dt);
+    }
+}
+
+void
+BulletSimulation::castBeams()
+{
+    //激光只有几条，逐条对每个带盒子的目标检测；命中的位置取目标的位置
+    int targetCount = (int)targets.size();
+    for (auto& b : beams) {
+        if (!b.beam.isLethal()) {
+            continue;
+        }
+        for (int t = 0; t < targetCount; t++) {
+            auto& target = targets[t];
+            if (!target.hasBox || (b.traits.hitMask & target.category) == 0 ||
+                std::find(b.struck.begin(), b.struck.end(), target.key) != b.struck.end()) {
+                continue;
+            }
+            const float* bounds = target.bounds;
+            if (!b.beam.overlapsBox(bounds[0], bounds[1], bounds[2], bounds[3])) {
+                continue;
+            }
+            b.struck.push_back(target.key);
+            hits.push_back(Hit{ t, target.x, target.y, b.traits.damage });
+        }
+    }
+}
+
+void
+BulletSimulation::removeBeams()
+{
+    released.clear();
+    doneBeams.clear();
+    for (auto& b : beams) {
+        if (b.beam.getPhase() == LaserBeam::DONE) {
+            doneBeams.push_back(b.handle);
+            if (b.owner) {
+                released.push_back(BulletField::Released{ b.owner, b.ownerSlot });
+            }
+        }
+    }
+    for (auto handle : doneBeams) {
+        beams.erase(handle);
+    }
+
+    //先移除再交还，弹幕释放时会对其余激光调用 disownBeam
+    for (auto& r : released) {
+        r.owner->releaseBeam(r.slot);
+    }
+    released.clear();
+}
+
+int
+BulletSimulation::cancelBullets(unsigned int ownerMask, float minX, float minY, float maxX,
+                                float maxY)
+{
+    BulletTraits traits = pickupTraits;
+    traits.ownerMask = 0;
+    traits.despawn = 0; //只按寿命回收，不会因飞出区域而丢失
+    traits.priority = BulletPriority::PLAYER;
+    if (traits.radius > maxRadius) {
+        maxRadius = traits.radius;
+    }
+
+    int cancelled = 0;
+    int count = field.size();
+    for (int i = 0; i < count; i++) {
+        float x = field.posX[i];
+        float y = field.posY[i];
+        if ((field.ownerMask[i] & ownerMask) == 0 || field.isDead(i) ||
+            (field.flags[i] & BulletField::FLAG_PICKUP) != 0 || x < minX || x > maxX ||
+            y < minY || y > maxY) {
+            continue;
+        }
+
+        auto trajectory = Trajectory::integrated(x, y, 0, PICKUP_POP_SPEED);
+        field.respawn(i, trajectory, PICKUP_LIFE, traits, BulletField::FLAG_PICKUP);
+
+        //拾取物不再属于弹幕，交还后弹幕可能随之释放
+        auto owner = field.owner[i];
+        if (owner) {
+            field.owner[i] = nullptr;
+            owner->releaseBullet(field.ownerSlot[i]);
+        }
+        cancelled++;
+    }
+
+    if (cancelled > 0) {
+        hasPickups = true;
+    }
+    return cancelled;
+}
+
+void
+BulletSimulation::attractPickups(float dt)
+{
+    if (!hasPickups || field.empty()) {
+        return;
+    }
+
+    //各块只改写自己范围内的拾取物
+    std::atomic<int> found(0);
+    float rate = std::min(1.0f, PICKUP_MAGNET_RATE * dt);
+    JobSystem::getInstance()->parallelFor(field.size(), BULLET_CULL_GRAIN, [&](int begin, int end) {
+        int n = 0;
+        for (int i = begin; i < end; i++) {
+            if ((field.flags[i] & BulletField::FLAG_PICKUP) == 0 || field.isDead(i)) {
+                continue;
+            }
+            n++;
+            if (field.age[i] < PICKUP_POP_TIME) {
+                continue;
+            }
+
+            //飞向最近的自机，速度逐渐转向
+            float x = field.posX[i];
+            float y = field.posY[i];
+            const Target* nearest = nullptr;
+            float nearestDistance = 0;
+            for (auto& target : targets) {
+                if (target.category != playerCategory) {
+                    continue;
+                }
+                float dx = target.x - x;
+                float dy = target.y - y;
+                float distance = dx * dx + dy * dy;
+                if (nullptr == nearest || distance < nearestDistance) {
+                    nearest = &target;
+                    nearestDistance = distance;
+                }
+            }
+            if (nullptr == nearest || nearestDistance == 0) {
+                continue;
+            }
+            float length = sqrtf(nearestDistance);
+            float desiredX = (nearest->x - x) / length * PICKUP_MAGNET_SPEED;
+            float desiredY = (nearest->y - y) / length * PICKUP_MAGNET_SPEED;
+            float velX = field.velX[i];
+            float velY = field.velY[i];
+            velX += (desiredX - velX) * rate;
+            velY += (desiredY - velY) * rate;
+            field.setVelocity(i, velX, velY);
+        }
+        found += n;
+    });
+    hasPickups = found.load() > 0;
+}
+
+void
+BulletSimulation::cullBullets()
+{
+    despawnStats = DespawnStats{ 0, 0, 0, 0 };
+    int count = field.size();
+    if (count == 0) {
+        return;
+    }
+    outside.resize(count);
+
+    //每种出界规则对整个子弹场做一次批量检测，只回收使用该规则的子弹
+    int policyCount = (int)despawnPolicies.size();
+    for (int p = 1; p < policyCount; p++) {
+        auto& policy = despawnPolicies[p];
+        const float* rect;
+        int* counter;
+        if (policy.rule == DespawnPolicy::AREA) {
+            rect = area;
+            counter = &despawnStats.area;
+        } else if (policy.rule == DespawnPolicy::VIEWPORT) {
+            rect = viewport;
+            counter = &despawnStats.viewport;
+        } else {
+            continue;
+        }
+
+        //各块只写自己范围内的出界标记与死亡标记，计数最后汇总
+        std::atomic<int> culled(0);
+        float minX = rect[0] - policy.margin;
+        float minY = rect[1] - policy.margin;
+        float maxX = rect[2] + policy.margin;
+        float maxY = rect[3] + policy.margin;
+        JobSystem::getInstance()->parallelFor(count, BULLET_CULL_GRAIN, [&](int begin, int end) {
+            int n = field.getKernels().cullOutside(field.posX.data() + begin,
+                                                   field.posY.data() + begin, end - begin, minX,
+                                                   minY, maxX, maxY, outside.data() + begin);
+            if (n == 0) {
+                return;
+            }
+            int killed = 0;
+            for (int i = begin; i < end; i++) {
+                if (outside[i] && field.despawn[i] == p && !field.isDead(i)) {
+                    field.kill(i);
+                    killed++;
+                }
+            }
+            culled += killed;
+        });
+        *counter += culled.load();
+    }
+
+    //余下到期的子弹按规则分别计数
+    for (int i = 0; i < count; i++) {
+        if ((field.flags[i] & BulletField::FLAG_DEAD) == 0 && field.age[i] >= field.life[i]) {
+            if (despawnPolicies[field.despawn[i]].rule == DespawnPolicy::MAX_AGE) {
+                despawnStats.maxAge++;
+            } else {
+                despawnStats.expired++;
+            }
+        }
+    }
+}
+
+void
+BulletSimulation::steerHoming(float dt)
+{
+    if (!hasHoming || field.empty()) {
+        return;
+    }
+
+    //目标每帧只收集一次，所有追踪弹共用同一份索引；有盒子的目标以盒子中心为准
+    targetIndex.clear();
+    for (auto& target : targets) {
+        if (target.hasBox) {
+            targetIndex.add((target.bounds[0] + target.bounds[2]) / 2,
+                            (target.bounds[1] + target.bounds[3]) / 2, target.category);
+        } else {
+            targetIndex.add(target.x, target.y, target.category);
+        }
+    }
+
+    //每颗追踪弹登记一次查找，编号即其在 homingBullets 中的序号
+    int count = field.size();
+    homingBullets.clear();
+    for (int i = 0; i < count; i++) {
+        if ((field.flags[i] & BulletField::FLAG_HOMING) != 0 && !field.isDead(i)) {
+            targetIndex.mark(field.posX[i], field.posY[i], field.hitMask[i]);
+            homingBullets.push_back(i);
+        }
+    }
+    hasHoming = !homingBullets.empty();
+    if (!hasHoming || targetIndex.size() == 0) {
+        return;
+    }
+    targetIndex.build();
+
+    //结果已整批求出，各块只改写自己范围内的追踪弹
+    int homing = (int)homingBullets.size();
+    JobSystem::getInstance()->parallelFor(homing, BULLET_CULL_GRAIN, [&](int begin, int end) {
+        //同一种子弹的转向速率相同，只在变化时重新求本帧可转的角度
+        float rate = -1;
+        float cosTurn = 1;
+        float sinTurn = 0;
+        for (int q = begin; q < end; q++) {
+            int t = targetIndex.getNearest(q);
+            if (t < 0) {
+                continue;
+            }
+            int i = homingBullets[q];
+            if (field.turnRate[i] != rate) {
+                rate = field.turnRate[i];
+                BulletField::getTurn(rate, dt, cosTurn, sinTurn);
+            }
+            field.steerToward(i, targetIndex.getX(t), targetIndex.getY(t), cosTurn, sinTurn);
+        }
+    });
+}
+
+void
+BulletSimulation::resolveHits()
+{
+    hits.clear();
+    grazes.clear();
+    pickups.clear();
+    if (field.empty()) {
+        return;
+    }
+
+    grid.build(field.posX.data(), field.posY.data(), field.size());
+
+    //只有带盒子的目标参与命中检测
+    int queryCount = 0;
+    int targetCount = (int)targets.size();
+    for (int t = 0; t < targetCount; t++) {
+        auto& target = targets[t];
+        if (!target.hasBox) {
+            continue;
+        }
+        if (queryCount == (int)queries.size()) {
+            queries.push_back(TargetQuery());
+        }
+        auto& query = queries[queryCount++];
+        query.target = t;
+        query.category = target.category;
+        for (int k = 0; k < 4; k++) {
+            query.bounds[k] = target.bounds[k];
+        }
+        query.graze = target.category == playerCategory && grazeRadius > 0;
+    }
+
+    //每个目标的网格查询与相交检测互不依赖，各用自己的缓冲区并行执行
+    JobSystem::getInstance()->parallelFor(queryCount, 1, [this](int begin, int end) {
+        for (int q = begin; q < end; q++) {
+            queryTarget(queries[q]);
+            if (queries[q].graze) {
+                queryGraze(queries[q]);
+            } else {
+                queries[q].grazed.clear();
+            }
+        }
+    });
+
+    //按目标顺序登记命中；先前目标已击中的子弹跳过，结果与逐个目标串行检测相同
+    for (int q = 0; q < queryCount; q++) {
+        auto& query = queries[q];
+        Pickup pickup{ query.target, 0, 0 };
+        for (int i : query.candidates) {
+            if (field.isDead(i)) {
+                continue;
+            }
+            if ((field.flags[i] & BulletField::FLAG_PICKUP) != 0) {
+                pickup.count++;
+                pickup.mana += field.damage[i];
+                removeBullet(i);
+                continue;
+            }
+            hits.push_back(Hit{ query.target, field.posX[i], field.posY[i], field.damage[i] });
+            removeBullet(i);
+        }
+
+        //命中的子弹已死亡，余下的即为擦弹
+        int grazeCount = 0;
+        for (int i : query.grazed) {
+            if (field.isDead(i) || (field.flags[i] & BulletField::FLAG_GRAZED) != 0) {
+                continue;
+            }
+            field.flags[i] |= BulletField::FLAG_GRAZED;
+            grazeCount++;
+        }
+        if (grazeCount > 0) {
+            grazes.push_back(Graze{ query.target, grazeCount });
+        }
+        if (pickup.count > 0) {
+            pickups.push_back(pickup);
+        }
+    }
+}
+
+void
+BulletSimulation::queryTarget(TargetQuery& query)
+{
+    const float* bounds = query.bounds;
+    auto& candidates = query.candidates;
+    candidates.clear();
+    grid.query(bounds[0] - maxRadius, bounds[1] - maxRadius, bounds[2] + maxRadius,
+               bounds[3] + maxRadius, candidates);
+
+    //筛掉打不中该目标的子弹，其余收集到连续数组交给内核做圆与盒子的相交检测
+    query.gatherX.clear();
+    query.gatherY.clear();
+    query.gatherRadius.clear();
+    int n = 0;
+    for (int i : candidates) {
+        if ((field.hitMask[i] & query.category) == 0 || field.isDead(i)) {
+            continue;
+        }
+        candidates[n++] = i;
+        query.gatherX.push_back(field.posX[i]);
+        query.gatherY.push_back(field.posY[i]);
+        query.gatherRadius.push_back(field.radius[i]);
+    }
+    if (n == 0) {
+        candidates.clear();
+        return;
+    }
+    query.firstHit.resize(n);
+    field.getKernels().overlapBoxes(query.gatherX.data(), query.gatherY.data(),
+                                    query.gatherRadius.data(), n, bounds, 1,
+                                    query.firstHit.data());
+
+    //只留下命中的子弹，保持原有顺序
+    int hit = 0;
+    for (int k = 0; k < n; k++) {
+        if (query.firstHit[k] >= 0) {
+            candidates[hit++] = candidates[k];
+        }
+    }
+    candidates.resize(hit);
+}
+
+void
+BulletSimulation::queryGraze(TargetQuery& query)
+{
+    //判定半径加上擦弹距离，再做一次同样的查询
+    const float* bounds = query.bounds;
+    float reach = maxRadius + grazeRadius;
+    auto& grazed = query.grazed;
+    grazed.clear();
+    grid.query(bounds[0] - reach, bounds[1] - reach, bounds[2] + reach, bounds[3] + reach,
+               grazed);
+
+    query.gatherX.clear();
+    query.gatherY.clear();
+    query.gatherRadius.clear();
+    int n = 0;
+    for (int i : grazed) {
+        if ((field.hitMask[i] & query.category) == 0 || field.isDead(i) ||
+            (field.flags[i] & (BulletField::FLAG_GRAZED | BulletField::FLAG_PICKUP)) != 0) {
+            continue;
+        }
+        grazed[n++] = i;
+        query.gatherX.push_back(field.posX[i]);
+        query.gatherY.push_back(field.posY[i]);
+        query.gatherRadius.push_back(field.radius[i] + grazeRadius);
+    }
+    if (n == 0) {
+        grazed.clear();
+        return;
+    }
+    query.firstHit.resize(n);
+    field.getKernels().overlapBoxes(query.gatherX.data(), query.gatherY.data(),
+                                    query.gatherRadius.data(), n, bounds, 1,
+                                    query.firstHit.data());
+
+    int near = 0;
+    for (int k = 0; k < n; k++) {
+        if (query.firstHit[k] >= 0) {
+            grazed[near++] = grazed[k];
+        }
+    }
+    grazed.resize(near);
+}
@@ -0,0 +1,292 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef BULLET_SIMULATION_H
+#define BULLET_SIMULATION_H
+
+#include "BulletField.h"
+#include "BulletGrid.h"
+#include "LaserBeam.h"
+#include "SlotMap.h"
+#include "TargetIndex.h"
+
+#include <cstdint>
+#include <vector>
+
+class StyleLifetime;
+
+// 弹幕默认的出界回收：离开当前区域外扩该距离后回收
+#define STYLE_DESPAWN_MARGIN 32.0f
+
+/* 子弹出界回收规则，每个弹幕一份，在寿命之外提前回收子弹 */
+struct DespawnPolicy
+{
+    enum Rule
+    {
+        NONE,     //只按寿命回收
+        AREA,     //离开当前区域（curArea）外扩 margin 后回收
+        VIEWPORT, //离开摄像机可见范围外扩 margin 后回收
+        MAX_AGE,  //寿命不超过 maxAge
+    };
+
+    Rule rule;
+    float margin;
+    float maxAge;
+
+    DespawnPolicy()
+        : rule(NONE)
+        , margin(0)
+        , maxAge(0)
+    {
+    }
+
+    static DespawnPolicy area(float margin);
+    static DespawnPolicy viewport(float margin);
+    static DespawnPolicy age(float maxAge);
+
+    bool operator==(const DespawnPolicy& other) const
+    {
+        return rule == other.rule && margin == other.margin && maxAge == other.maxAge;
+    }
+};
+
+/* 每帧各规则回收的子弹数 */
+struct DespawnStats
+{
+    int area;
+    int viewport;
+    int maxAge;
+    int expired; //没有出界规则、寿命到期的子弹
+};
+
+/* 画质档位，决定同屏子弹预算 */
+enum class QualityTier
+{
+    LOW,
+    MEDIUM,
+    HIGH,
+};
+
+/* 一帧内子弹预算的使用情况，各数组以 BulletPriority 为下标 */
+struct BulletBudgetStats
+{
+    int limit;                          //预算，0 为不限
+    int live;                           //帧末在场的子弹数
+    int refused[BULLET_PRIORITY_COUNT]; //超出预算且没有可让位的子弹，发射被拒绝
+    int evicted[BULLET_PRIORITY_COUNT]; //为优先级更高的子弹让位，提前回收
+};
+
+/* 一个目标的命中查询，并行检测时各目标互不共享缓冲区 */
+struct TargetQuery
+{
+    int target; // addTarget 返回的编号
+    unsigned int category;
+    float bounds[4];             //刚体盒子 minX, minY, maxX, maxY
+    std::vector<int> candidates; //网格候选，检测后只留下命中的子弹
+    bool graze;                  //是否检测擦弹，只对自机
+    std::vector<int> grazed;     //擦弹范围内的子弹，含命中的子弹
+    std::vector<float> gatherX;
+    std::vector<float> gatherY;
+    std::vector<float> gatherRadius;
+    std::vector<int32_t> firstHit;
+};
+
+/* 子弹模拟：子弹场每帧的推进、出界回收与命中检测，BulletLayer 与 bullet_bench、pattern_sim 共用
+ *
+ *  + 不依赖 cocos2d：目标每帧以 addTarget 给出位置、种别与刚体盒子，区域与可见范围以坐标给出，
+ *    命中、擦弹、拾取按目标编号返回，由调用者换成自己的目标（BulletLayer 换成节点后抛出事件）
+ *  + 一帧分两步：update 推进并检测，调用者处理命中后 removeDead 移除死亡子弹、交还发射方，
+ *    并结算子弹预算
+ *  + 出界回收按弹幕的 DespawnPolicy 在命中检测之前进行，出界当帧即回收
+ *  + 推进、出界检测与各目标的命中查询交给 JobSystem 分块并行，命中按目标顺序在主线程登记，
+ *    结果与线程数无关
+ *  + 擦弹是对自机的第二次网格查询，判定半径加上 grazeRadius，每颗子弹只计一次
+ *  + cancelBullets 把子弹就地改写为飞向自机的拾取物，种类与判定取自 setPickupTraits
+ *  + 追踪弹：每帧以所有目标建一次 TargetIndex，登记全部追踪弹后整批求出各自可命中的最近目标，
+ *    再按转向速率转向
+ *  + 同屏子弹数超出预算时，新子弹挤掉优先级更低的在场子弹（剩余寿命最短的先让位），没有可挤掉的
+ *    子弹时拒绝发射；每帧的拒绝与挤掉数由 getBudgetStats 取得
+ *  + 激光不进入子弹场，以 addBeam 登记：update 推进并对带盒子的目标做线段检测，每条激光对每个
+ *    目标（以 addTarget 的 key 区分）只命中一次，命中与子弹命中一并返回；消散后在 removeDead
+ *    时移除并交还发射它的弹幕。起点由发射方经 getBeam 每帧更新，不受子弹预算与消弹影响
+ */
+
+class BulletSimulation
+{
+public:
+    /* 一次命中，target 为 addTarget 返回的编号 */
+    struct Hit
+    {
+        int target;
+        float x; //子弹命中时的位置
+        float y;
+        int damage;
+    };
+
+    /* 一个目标本帧的擦弹数 */
+    struct Graze
+    {
+        int target;
+        int count;
+    };
+
+    /* 一个目标本帧拾取的拾取物 */
+    struct Pickup
+    {
+        int target;
+        int count;
+        int mana; //拾取物带来的灵力之和
+    };
+
+    /* 一条在场的激光 */
+    struct Beam
+    {
+        LaserBeam beam;
+        BulletTraits traits;             //原型、可命中的目标种别与伤害，其余不用
+        SlotHandle handle;               // addBeam 返回的句柄
+        StyleLifetime* owner;            //发射它的弹幕，弹幕已销毁时为 nullptr
+        SlotHandle ownerSlot;            //在 owner 激光表中的句柄
+        std::vector<const void*> struck; //已命中的目标的 key
+    };
+
+    BulletSimulation();
+    ~BulletSimulation();
+
+    /* 发射一颗子弹，按轨迹飞行 life 秒；age 为发射时已经过的时间，traits.despawn 由 despawn 登记后
+     * 填入。homing 为追踪弹每秒最多转过的弧度，trail 为带拖尾。子弹登记到 owner 的子弹表，离场时
+     * 交还。返回子弹场中的下标（到下一次 removeDead 前有效），超出子弹预算被拒绝时返回 -1 */
+    int addBullet(const Trajectory& trajectory, float life, BulletTraits traits,
+                  const DespawnPolicy& despawn, float homing = 0, bool trail = false,
+                  StyleLifetime* owner = nullptr, float age = 0);
+
+    /* 立即移除一颗子弹（击中目标等），条目在下一次 removeDead 时移除 */
+    void removeBullet(int index);
+
+    /* 移除所有子弹并交还发射方 */
+    void clearBullets();
+
+    /* 消弹：发射方属于 ownerMask、位于 [minX, maxX] x [minY, maxY] 内的子弹全部转为拾取物，
+     * 返回转换的子弹数
+     *
+     *  + 对子弹场只遍历一次，子弹就地换成拾取物，并交还发射它的弹幕
+     *  + 拾取物先向上弹出，随后被最近的自机吸引，碰到自机时计入 getPickups */
+    int cancelBullets(unsigned int ownerMask, float minX, float minY, float maxX, float maxY);
+
+    /* 本帧的目标：update 之前清空后逐个加入，返回其编号。box 为刚体盒子 minX, minY, maxX, maxY，
+     * 为空时只吸引拾取物、作为追踪弹的目标，不做命中检测；key 为跨帧不变的标识（游戏中为节点），
+     * 激光以它记录已命中的目标 */
+    void clearTargets();
+    int addTarget(float x, float y, unsigned int category, const float* box, const void* key);
+
+    /* 发射一条激光，traits 只取原型、hitMask 与伤害。激光登记到 owner，消散后在 removeDead 时
+     * 交还。返回的句柄在激光被移除前有效 */
+    SlotHandle addBeam(const LaserBeam& beam, const BulletTraits& traits,
+                       StyleLifetime* owner = nullptr);
+
+    /* 弹幕先于激光销毁：清空激光的发射方，激光继续到消散，不再通知 */
+    void disownBeam(SlotHandle handle);
+
+    /* 在场的激光，已移除时返回空；发射方以它更新起点、判断激光是否已结束 */
+    LaserBeam* getBeam(SlotHandle handle);
+
+    /* 推进 dt 秒：吸引拾取物、追踪弹转向、推进子弹场与激光、出界回收、命中检测 */
+    void update(float dt);
+
+    /* 移除死亡子弹并交还发射方、移除已消散的激光，结算本帧的子弹预算；在处理完本帧的命中之后调用 */
+    void removeDead();
+
+    /* 命中检测网格与追踪弹索引覆盖的区域、出界规则 AREA 的范围 */
+    void setArea(float x, float y, float width, float height);
+    void setCellSize(float cellSize);
+
+    /* 出界规则 VIEWPORT 的范围，摄像机移动时每帧更新 */
+    void setViewport(float minX, float minY, float maxX, float maxY);
+
+    /* 自机的种别：吸引拾取物，检测擦弹 */
+    void setPlayerCategory(unsigned int category) { playerCategory = category; }
+
+    /* 拾取物的种类与判定，cancelBullets 时写入子弹场 */
+    void setPickupTraits(const BulletTraits& traits) { pickupTraits = traits; }
+
+    /* 同屏子弹预算，0 为不限；setQuality 按画质档位设定 */
+    void setBudget(int budget) { this->budget = budget; }
+    int getBudget() const { return budget; }
+    void setQuality(QualityTier tier);
+
+    /* 擦弹距离：子弹判定圆与自机盒子的间距小于该值且未命中即为擦弹，0 时不检测 */
+    void setGrazeRadius(float radius) { grazeRadius = radius; }
+    float getGrazeRadius() const { return grazeRadius; }
+
+    BulletField& getField() { return field; }
+    const BulletField& getField() const { return field; }
+    const SlotMap<Beam>& getBeams() const { return beams; }
+    const std::vector<Hit>& getHits() const { return hits; }
+    const std::vector<Graze>& getGrazes() const { return grazes; }
+    const std::vector<Pickup>& getPickups() const { return pickups; }
+    const DespawnStats& getDespawnStats() const { return despawnStats; }
+    const BulletBudgetStats& getBudgetStats() const { return budgetStats; } //上一帧
+
+private:
+    struct Target
+    {
+        float x;
+        float y;
+        unsigned int category;
+        bool hasBox;
+        float bounds[4];
+        const void* key;
+    };
+
+    int getDespawnIndex(const DespawnPolicy& despawn);
+    bool admit(BulletPriority priority);
+    void collectEvictable();
+    void sweepBudget();
+    void attractPickups(float dt);
+    void steerHoming(float dt);
+    void cullBullets();
+    void resolveHits();
+    void advanceBeams(float dt);
+    void castBeams();
+    void removeBeams();
+    void queryTarget(TargetQuery& query);
+    void queryGraze(TargetQuery& query);
+    void releaseOwners();
+
+private:
+    BulletField field;
+    std::vector<BulletField::Released> released; //每帧复用的待交还列表
+    BulletTraits pickupTraits;
+    unsigned int playerCategory;
+
+    std::vector<DespawnPolicy> despawnPolicies; //已登记的回收规则，0 号为 NONE
+    std::vector<uint8_t> outside;               //每帧复用的出界标记
+    DespawnStats despawnStats;
+    float area[4];     //区域 minX, minY, maxX, maxY
+    float viewport[4]; //可见范围 minX, minY, maxX, maxY
+
+    std::vector<Target> targets;
+    BulletGrid grid;
+    float maxRadius;                  //在场子弹的最大判定半径，用于扩展查询范围
+    std::vector<TargetQuery> queries; //每帧复用，每个有盒子的目标一份
+    std::vector<Hit> hits;
+    float grazeRadius;
+    std::vector<Graze> grazes;
+    std::vector<Pickup> pickups;
+    SlotMap<Beam> beams;
+    std::vector<SlotHandle> doneBeams; //每帧复用，已消散的激光
+    bool hasPickups;                //场上可能有拾取物，没有时跳过吸引
+    TargetIndex targetIndex;        //每帧重建的目标索引，追踪弹查找最近目标
+    bool hasHoming;                 //场上可能有追踪弹，没有时跳过转向
+    std::vector<int> homingBullets; //本帧登记查找的追踪弹下标，按查找编号
+
+    int budget;
+    int pendingKills;    //上次 removeDead 之后被移除、仍占着子弹场的子弹数
+    bool evictableReady; //本帧已整理出可让位的子弹
+    std::vector<int> evictable[BULLET_PRIORITY_COUNT]; //各优先级的在场子弹，先让位的在前
+    int evictCursor[BULLET_PRIORITY_COUNT];
+    BulletBudgetStats budgetFrame; //本帧累计
+    BulletBudgetStats budgetStats; //上一帧
+};
+
+#endif // BULLET_SIMULATION_H
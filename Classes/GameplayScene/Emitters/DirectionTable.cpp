@@ -0,0 +1,33 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "DirectionTable.h"
+
+#include <cmath>
+
+void
+DirectionTable::build(int count, float start, float step)
+{
+    x.resize(count);
+    y.resize(count);
+    for (int i = 0; i < count; i++) {
+        float radians = start + i * step;
+        x[i] = cosf(radians);
+        y[i] = sinf(radians);
+    }
+}
+
+void
+DirectionTable::rotate(float radians, DirectionTable& out) const
+{
+    float c = cosf(radians);
+    float s = sinf(radians);
+    int count = size();
+    out.x.resize(count);
+    out.y.resize(count);
+    for (int i = 0; i < count; i++) {
+        out.x[i] = c * x[i] - s * y[i];
+        out.y[i] = s * x[i] + c * y[i];
+    }
+}
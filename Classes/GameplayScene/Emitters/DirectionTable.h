@@ -0,0 +1,35 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef DIRECTION_TABLE_H
+#define DIRECTION_TABLE_H
+
+#include <vector>
+
+/* 扇形、环形弹的方向表
+ *
+ *  + 保存 count 个单位向量，第 i 个的角度为 start + i * step（弧度）
+ *  + 弹幕在开始发射时建表，之后每一轮只需把整张表旋转一次，
+ *    一次 sin/cos 加每颗子弹两次乘加，代替每颗子弹各算一次三角函数
+ *  + 旋转总是从原表出发，不会累积误差
+ */
+
+class DirectionTable
+{
+public:
+    void build(int count, float start, float step);
+
+    /* 将整张表旋转 radians 后写入 out */
+    void rotate(float radians, DirectionTable& out) const;
+
+    int size() const { return (int)x.size(); }
+    float getX(int i) const { return x[i]; }
+    float getY(int i) const { return y[i]; }
+
+private:
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+#endif // DIRECTION_TABLE_H
@@ -3,11 +3,13 @@
 #endif
 
 #include "Emitter.h"
+#include "Pattern.h"
 #include "Style/EmitterStyle.h"
 #include "Style/Laser.h"
 #include "Style/OddEven.h"
 #include "Style/Parabola.h"
 #include "Style/Parallel.h"
+#include "Style/PatternStyle.h"
 #include "Style/Scatter.h"
 
 Emitter*
@@ -29,6 +31,7 @@ Emitter::Emitter(Direction* direction)
     this->isPlayer = true;
     this->direction = direction;
     this->styleTag = 1;
+    this->rng.seed(FastRandom::nextStreamSeed());
 }
 
 Emitter*
@@ -50,6 +53,20 @@ Emitter::Emitter(Node** target)
     this->isPlayer = false;
     this->target = target;
     this->styleTag = 1;
+    this->rng.seed(FastRandom::nextStreamSeed());
+}
+
+/* 子弹预算的优先级：自机的子弹最高，敌人的散弹与抛物线弹只是铺满画面，最先让位 */
+static BulletPriority
+priorityOf(StyleType st, bool isPlayer)
+{
+    if (isPlayer) {
+        return BulletPriority::PLAYER;
+    }
+    if (st == StyleType::SCATTER || st == StyleType::PARABOLA) {
+        return BulletPriority::FILLER;
+    }
+    return BulletPriority::AIMED;
 }
 
 int
@@ -105,6 +122,9 @@ Emitter::playStyle(const StyleConfig& sc)
     }
 
     style->setTag(styleTag);
+    style->setOwnerMask(isPlayer ? playerCategory : enemyCategory);
+    style->setPriority(priorityOf(sc.style, isPlayer));
+    style->seedRandom(rng.nextSeed());
     this->addChild(style);
     int trueTag = styleTag;
     styles.insert(styleTag++, style);
@@ -165,6 +185,37 @@ Emitter::playStyle(StyleType st)
     }
 
     style->setTag(styleTag);
+    style->setOwnerMask(isPlayer ? playerCategory : enemyCategory);
+    style->setPriority(priorityOf(st, isPlayer));
+    style->seedRandom(rng.nextSeed());
+    this->addChild(style);
+    int trueTag = styleTag;
+    styles.insert(styleTag++, style);
+
+    return trueTag;
+}
+
+int
+Emitter::playPattern(const std::string& patternTag)
+{
+    auto pattern = PatternLibrary::getInstance()->getPattern(patternTag);
+    if (nullptr == pattern) {
+        log("[Emitter] unknown pattern %s", patternTag.c_str());
+        return 0;
+    }
+
+    PatternStyle* style;
+    if (isPlayer) {
+        style = PatternStyle::create(pattern, direction);
+    } else {
+        style = PatternStyle::create(pattern, target);
+    }
+    style->startShoot();
+
+    style->setTag(styleTag);
+    style->setOwnerMask(isPlayer ? playerCategory : enemyCategory);
+    style->setPriority(isPlayer ? BulletPriority::PLAYER : BulletPriority::AIMED);
+    style->seedRandom(rng.nextSeed());
     this->addChild(style);
     int trueTag = styleTag;
     styles.insert(styleTag++, style);
@@ -206,29 +257,27 @@ void
 Emitter::stopStyle(int styleTag)
 {
     auto style = (EmitterStyle*)styles.at(styleTag);
-    style->stopShoot();
-    std::function<void(Ref*)> clean = [style](Ref*) {
-        style->cleanup();
-        log("[Emitter] style cleaned");
-    };
-    auto removeSelf = CallFuncN::create(clean);
-    style->runAction(Sequence::create(DelayTime::create(15), removeSelf, NULL));
+
+    //字节码弹幕启动的弹幕一并停止
+    auto patternStyle = dynamic_cast<PatternStyle*>(style);
+    if (patternStyle) {
+        for (int tag : patternStyle->getSpawnedStyles()) {
+            if (styles.at(tag)) {
+                stopStyle(tag);
+            }
+        }
+    }
+
+    //放开容器的引用后，弹幕只由父节点持有，最后一颗子弹回收时移除
     styles.erase(styleTag);
+    style->retire();
 }
 
 void
 Emitter::stopAllStyle()
 {
     for (auto s = styles.begin(); s != styles.end(); s++) {
-        auto style = (EmitterStyle*)s->second;
-        style->stopShoot();
-
-        std::function<void(Ref*)> clean = [style](Ref*) {
-            style->cleanup();
-            log("[Emitter] style cleaned");
-        };
-        auto removeSelf = CallFuncN::create(clean);
-        style->runAction(Sequence::create(DelayTime::create(15), removeSelf, NULL));
+        static_cast<EmitterStyle*>(s->second)->retire();
     }
     styles.clear();
     styleTag = 1;
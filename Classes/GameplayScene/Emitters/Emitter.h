@@ -5,6 +5,7 @@
 #ifndef EMITTER_H
 #define EMITTER_H
 
+#include "FastRandom.h"
 #include "GameplayScene/common.h"
 #include "StyleConfig.h"
 #include "cocos2d.h"
@@ -27,6 +28,9 @@ public:
     int playStyle(const StyleConfig& sc);
     int playStyle(StyleType st);
 
+    /* 按模式库中的字节码创建弹幕，模式不存在时返回 0 */
+    int playPattern(const std::string& patternTag);
+
     /* 暂停弹幕 */
     void pauseStyle(int styleTag);
     void pauseAllStyle();
@@ -35,7 +39,7 @@ public:
     void resumeStyle(int styleTag);
     void resumeAllStyle();
 
-    /* 销毁弹幕 */
+    /* 销毁弹幕：立即停止发射，在场子弹全部回收后释放 */
     void stopStyle(int styleTag);
     void stopAllStyle();
 
@@ -45,6 +49,7 @@ private:
     Node** target;          //自机目标
     Map<int, Node*> styles; //弹幕容器
     int styleTag;           //弹幕计数
+    FastRandom rng;         //为每个弹幕派生种子
 };
 
 #endif
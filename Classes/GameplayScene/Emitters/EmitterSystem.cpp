@@ -0,0 +1,100 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "EmitterSystem.h"
+#include "Style/EmitterStyle.h"
+
+EmitterSystem* EmitterSystem::_self;
+
+EmitterSystem*
+EmitterSystem::getInstance()
+{
+    if (!_self) {
+        _self = new (std::nothrow) EmitterSystem();
+    }
+    return _self;
+}
+
+EmitterSystem::EmitterSystem()
+    : holes(0)
+    , updating(false)
+    , paused(false)
+    , timeScale(1.0f)
+{
+}
+
+void
+EmitterSystem::add(EmitterStyle* style)
+{
+    if (style->systemIndex >= 0) {
+        return;
+    }
+    style->systemIndex = (int)styles.size();
+    styles.push_back(style);
+}
+
+void
+EmitterSystem::remove(EmitterStyle* style)
+{
+    int index = style->systemIndex;
+    if (index < 0 || index >= (int)styles.size() || styles[index] != style) {
+        return;
+    }
+    style->systemIndex = -1;
+
+    //推进过程中只留空位，以免打乱正在遍历的下标
+    if (updating) {
+        styles[index] = nullptr;
+        holes++;
+        return;
+    }
+    //空位在每帧推进结束时已压缩，末尾一定是有效的弹幕
+    styles[index] = styles.back();
+    styles[index]->systemIndex = index;
+    styles.pop_back();
+}
+
+void
+EmitterSystem::update(float dt)
+{
+    if (paused || styles.empty()) {
+        return;
+    }
+
+    updating = true;
+    float scaled = dt * timeScale;
+    int count = (int)styles.size(); //本帧登记的弹幕下一帧开始推进
+    for (int i = 0; i < count; i++) {
+        auto style = styles[i];
+        if (style && style->isTickable()) {
+            style->tick(scaled);
+        }
+    }
+    updating = false;
+
+    if (holes > 0) {
+        compact();
+    }
+}
+
+void
+EmitterSystem::compact()
+{
+    int n = 0;
+    for (auto style : styles) {
+        if (style) {
+            style->systemIndex = n;
+            styles[n++] = style;
+        }
+    }
+    styles.resize(n);
+    holes = 0;
+}
+
+void
+EmitterSystem::reset()
+{
+    paused = false;
+    timeScale = 1.0f;
+}
@@ -0,0 +1,56 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef EMITTER_SYSTEM_H
+#define EMITTER_SYSTEM_H
+
+#include <vector>
+
+class EmitterStyle;
+
+/* 弹幕调度：所有弹幕的发射节拍由 GameplayScene::update 每帧统一推进一次
+ *
+ *  + 单例；弹幕在 startShoot 时登记、停止发射或销毁时注销，不再各自向 cocos2d 调度器注册
+ *  + 以连续数组遍历，推进过程中注销的弹幕只留空位，本帧结束后统一压缩；
+ *    推进过程中登记的弹幕从下一帧开始推进
+ *  + 暂停的弹幕（Emitter::pauseStyle、设置界面暂停 mapLayer）与尚未进入场景的弹幕跳过
+ *  + 整体的暂停与时间缩放只影响发射节拍，不影响子弹层
+ */
+
+class EmitterSystem
+{
+public:
+    static EmitterSystem* getInstance();
+
+    void add(EmitterStyle* style);
+    void remove(EmitterStyle* style);
+
+    /* 推进所有登记的弹幕 dt 秒（乘以时间缩放） */
+    void update(float dt);
+
+    /* 暂停与时间缩放，切换场景时由 reset 恢复 */
+    void setPaused(bool paused) { this->paused = paused; }
+    bool isPaused() const { return paused; }
+    void setTimeScale(float timeScale) { this->timeScale = timeScale; }
+    float getTimeScale() const { return timeScale; }
+    void reset();
+
+    /* 登记中的弹幕数 */
+    int getActiveCount() const { return (int)styles.size() - holes; }
+
+private:
+    EmitterSystem();
+    static EmitterSystem* _self;
+
+    void compact();
+
+private:
+    std::vector<EmitterStyle*> styles;
+    int holes; //推进过程中注销留下的空位
+    bool updating;
+    bool paused;
+    float timeScale;
+};
+
+#endif // EMITTER_SYSTEM_H
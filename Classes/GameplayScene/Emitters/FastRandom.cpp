@@ -0,0 +1,120 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "FastRandom.h"
+
+// 2^-24，取高 24 位转为 [0, 1) 的浮点数
+#define FAST_RANDOM_FLOAT_UNIT (1.0f / 16777216.0f)
+// 黄金分割常数，派生种子时的步长
+#define FAST_RANDOM_GOLDEN 0x9e3779b97f4a7c15ULL
+
+uint64_t FastRandom::roundSeed = 0;
+uint64_t FastRandom::streamCount = 0;
+
+/* splitmix64：把相邻的种子打散为互不相关的状态 */
+static uint64_t
+splitMix(uint64_t& x)
+{
+    uint64_t z = (x += FAST_RANDOM_GOLDEN);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t
+rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+FastRandom::FastRandom()
+{
+    seed(0);
+}
+
+FastRandom::FastRandom(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void
+FastRandom::seed(uint64_t seed)
+{
+    uint64_t x = seed;
+    uint64_t a = splitMix(x);
+    uint64_t b = splitMix(x);
+    state[0] = (uint32_t)a;
+    state[1] = (uint32_t)(a >> 32);
+    state[2] = (uint32_t)b;
+    state[3] = (uint32_t)(b >> 32);
+    //全零状态只会输出 0
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+        state[0] = 1;
+    }
+}
+
+uint32_t
+FastRandom::next()
+{
+    uint32_t result = rotl(state[1] * 5, 7) * 9;
+    uint32_t t = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 11);
+    return result;
+}
+
+uint64_t
+FastRandom::nextSeed()
+{
+    uint64_t high = next();
+    return (high << 32) | next();
+}
+
+float
+FastRandom::nextFloat()
+{
+    return (next() >> 8) * FAST_RANDOM_FLOAT_UNIT;
+}
+
+int
+FastRandom::range(int min, int max)
+{
+    if (max <= min) {
+        return min;
+    }
+    uint64_t span = (uint64_t)((int64_t)max - min + 1);
+    return (int)(min + (int64_t)((next() * span) >> 32));
+}
+
+void
+FastRandom::fill(float* out, int count)
+{
+    for (int i = 0; i < count; i++) {
+        out[i] = (next() >> 8) * FAST_RANDOM_FLOAT_UNIT;
+    }
+}
+
+void
+FastRandom::beginRound(uint64_t seed)
+{
+    roundSeed = seed;
+    streamCount = 0;
+}
+
+uint64_t
+FastRandom::getRoundSeed()
+{
+    return roundSeed;
+}
+
+uint64_t
+FastRandom::nextStreamSeed()
+{
+    uint64_t x = roundSeed + FAST_RANDOM_GOLDEN * (++streamCount);
+    return splitMix(x);
+}
@@ -0,0 +1,50 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef FAST_RANDOM_H
+#define FAST_RANDOM_H
+
+#include <cstdint>
+
+/* 快速伪随机数（xoshiro128**）
+ *
+ *  + 每个发射器、弹幕与敌人各持有一个，互不共享状态，代替 CCRANDOM_0_1 与 cocos2d::random
+ *  + 种子由本局的种子派生：beginRound 后按创建顺序依次取 nextStreamSeed，
+ *    相同的种子与输入下两次运行的子弹场完全相同，便于基准测试与复现问题
+ *  + fill 一次生成整轮弹幕所需的均匀分布浮点数
+ *  + 不依赖 cocos2d
+ */
+
+class FastRandom
+{
+public:
+    FastRandom();
+    explicit FastRandom(uint64_t seed);
+
+    void seed(uint64_t seed);
+
+    uint32_t next();
+    /* 派生子序列的种子 */
+    uint64_t nextSeed();
+    /* [0, 1) 的均匀分布 */
+    float nextFloat();
+    /* [min, max] 的均匀分布，与 cocos2d::random(min, max) 的区间一致 */
+    int range(int min, int max);
+    /* 向 out 写入 count 个 [0, 1) 的均匀分布 */
+    void fill(float* out, int count);
+
+    /* 开始新的一局，之后创建的随机数按顺序从 seed 派生 */
+    static void beginRound(uint64_t seed);
+    static uint64_t getRoundSeed();
+    /* 本局的下一个种子 */
+    static uint64_t nextStreamSeed();
+
+private:
+    uint32_t state[4];
+
+    static uint64_t roundSeed;
+    static uint64_t streamCount;
+};
+
+#endif // FAST_RANDOM_H
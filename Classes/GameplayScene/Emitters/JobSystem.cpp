@@ -0,0 +1,188 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// 工作线程数上限，目标设备为 4 至 8 核
+#define JOB_SYSTEM_MAX_THREADS 7
+
+JobSystem* JobSystem::_self;
+
+JobSystem*
+JobSystem::getInstance()
+{
+    if (!_self) {
+        _self = new (std::nothrow) JobSystem();
+    }
+    return _self;
+}
+
+JobSystem::JobSystem()
+    : job(nullptr)
+    , queued(0)
+    , remaining(0)
+    , running(false)
+    , stopping(false)
+{
+    queues.push_back(new Queue());
+    setThreadCount(getDefaultThreadCount());
+}
+
+JobSystem::~JobSystem()
+{
+    stopWorkers();
+    for (auto queue : queues) {
+        delete queue;
+    }
+}
+
+int
+JobSystem::getDefaultThreadCount()
+{
+    int cores = (int)std::thread::hardware_concurrency(); //无法检测时为 0
+    return std::max(0, std::min(cores - 1, JOB_SYSTEM_MAX_THREADS));
+}
+
+void
+JobSystem::setThreadCount(int count)
+{
+    count = std::max(0, std::min(count, JOB_SYSTEM_MAX_THREADS));
+    if (count == (int)workers.size()) {
+        return;
+    }
+
+    stopWorkers();
+    while ((int)queues.size() > count + 1) {
+        delete queues.back();
+        queues.pop_back();
+    }
+    while ((int)queues.size() < count + 1) {
+        queues.push_back(new Queue());
+    }
+
+    stopping = false;
+    for (int i = 1; i <= count; i++) {
+        workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+    }
+}
+
+void
+JobSystem::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void
+JobSystem::parallelFor(int count, int grain, const std::function<void(int, int)>& job)
+{
+    if (count <= 0) {
+        return;
+    }
+    grain = std::max(grain, 1);
+
+    //只有一块、没有工作线程或嵌套调用时直接在当前线程执行
+    int chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || workers.empty() || running) {
+        job(0, count);
+        return;
+    }
+
+    running = true;
+    this->job = &job;
+    remaining = chunks;
+
+    //先计数再入队，上一批次中尚未睡下的工作线程取到新块时计数不会变为负数
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queued += chunks;
+    }
+
+    //按块轮流分给各线程，使每个队列的块大致相等
+    int threads = (int)queues.size();
+    for (int t = 0; t < threads; t++) {
+        std::lock_guard<std::mutex> lock(queues[t]->mutex);
+        for (int c = t; c < chunks; c += threads) {
+            queues[t]->ranges.push_back(Range{ c * grain, std::min(count, (c + 1) * grain) });
+        }
+    }
+    wake.notify_all();
+
+    Range range;
+    while (take(0, range)) {
+        run(range);
+    }
+    //队列已空，睡眠等其他线程做完手上的块；核数少于线程数时空转会抢走工作线程的时间片
+    if (remaining.load() > 0) {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [this] { return remaining.load() == 0; });
+    }
+
+    this->job = nullptr;
+    running = false;
+}
+
+bool
+JobSystem::take(int self, Range& range)
+{
+    int threads = (int)queues.size();
+    for (int k = 0; k < threads; k++) {
+        int t = (self + k) % threads;
+        Queue& queue = *queues[t];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.ranges.empty()) {
+            continue;
+        }
+        //自己的队列从头部取，其他线程的队列从尾部窃取
+        if (k == 0) {
+            range = queue.ranges.front();
+            queue.ranges.pop_front();
+        } else {
+            range = queue.ranges.back();
+            queue.ranges.pop_back();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+void
+JobSystem::run(const Range& range)
+{
+    (*job)(range.begin, range.end);
+    //先减计数再加锁通知，主线程在锁内检查计数，不会错过唤醒
+    if (--remaining == 0) {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        done.notify_one();
+    }
+}
+
+void
+JobSystem::workerLoop(int self)
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+
+        Range range;
+        while (take(self, range)) {
+            run(range);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* 任务系统：子弹场等批量计算在主线程与工作线程上分块并行
+ *
+ *  + 单例，工作线程常驻；parallelFor 把区间切块后轮流放入各线程的队列，
+ *    各线程先取自己队列的头部，取完再从其他队列的尾部窃取
+ *  + 主线程同样参与执行，取不到块时睡眠等待最后一块完成，不空转；
+ *    parallelFor 返回时所有块都已完成，调用者可直接读取结果
+ *  + 块之间只写各自的下标范围，结果与线程数、分块方式无关
+ *  + 只能在主线程调用；块内不得再调用 parallelFor，也不得访问 cocos2d 节点
+ *  + 不依赖 cocos2d
+ */
+
+class JobSystem
+{
+public:
+    static JobSystem* getInstance();
+
+    /* 工作线程数，不含主线程；0 时全部在主线程执行 */
+    void setThreadCount(int count);
+    int getThreadCount() const { return (int)workers.size(); }
+
+    /* 默认的工作线程数：CPU 核数减去主线程，不超过 JOB_SYSTEM_MAX_THREADS */
+    static int getDefaultThreadCount();
+
+    /* 把 [0, count) 按每块 grain 个切分后并行执行 job(begin, end)，全部完成后返回 */
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& job);
+
+private:
+    JobSystem();
+    ~JobSystem();
+    static JobSystem* _self;
+
+    struct Range
+    {
+        int begin;
+        int end;
+    };
+
+    /* 每个线程一个队列，下标 0 为主线程 */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    void workerLoop(int self);
+    bool take(int self, Range& range);
+    void run(const Range& range);
+    void stopWorkers();
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<Queue*> queues;
+
+    const std::function<void(int, int)>* job; //正在执行的任务，只在 parallelFor 期间有效
+    std::atomic<int> queued;                  //尚未取出的块数
+    std::atomic<int> remaining;               //尚未完成的块数
+    bool running;                             //正在 parallelFor 中
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    std::mutex doneMutex;
+    std::condition_variable done; //最后一块完成时唤醒主线程
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,114 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "LaserBeam.h"
+
+#include <cmath>
+
+// 预警阶段的宽度比例
+#define LASER_WARMUP_WIDTH 0.15f
+
+#define LASER_PI 3.14159265358979323846f
+
+LaserBeam::LaserBeam()
+    : originX(0)
+    , originY(0)
+    , angle(0)
+    , sweep(0)
+    , length(0)
+    , width(0)
+    , warmup(0)
+    , active(0)
+    , fade(0)
+    , age(0)
+{
+}
+
+void
+LaserBeam::advance(float dt)
+{
+    if (isLethal()) {
+        angle += sweep * dt;
+    }
+    age += dt;
+}
+
+LaserBeam::Phase
+LaserBeam::getPhase() const
+{
+    if (age < warmup) {
+        return WARMUP;
+    } else if (age < warmup + active) {
+        return ACTIVE;
+    } else if (age < warmup + active + fade) {
+        return FADE;
+    }
+    return DONE;
+}
+
+float
+LaserBeam::getVisibleWidth() const
+{
+    switch (getPhase()) {
+        case WARMUP:
+            return width * LASER_WARMUP_WIDTH;
+        case ACTIVE:
+            return width;
+        case FADE:
+            return width * (1.0f - (age - warmup - active) / fade);
+        default:
+            return 0;
+    }
+}
+
+void
+LaserBeam::getEnd(float& x, float& y) const
+{
+    float radians = angle * LASER_PI / 180.0f;
+    x = originX + length * cosf(radians);
+    y = originY + length * sinf(radians);
+}
+
+bool
+LaserBeam::overlapsBox(float minX, float minY, float maxX, float maxY) const
+{
+    //按半个宽度外扩盒子后做线段裁剪（Liang-Barsky），角上比精确的圆角略宽
+    float half = width / 2;
+    minX -= half;
+    minY -= half;
+    maxX += half;
+    maxY += half;
+
+    float endX, endY;
+    getEnd(endX, endY);
+    float dx = endX - originX;
+    float dy = endY - originY;
+
+    float enter = 0;
+    float leave = 1;
+    float p[4] = { -dx, dx, -dy, dy };
+    float q[4] = { originX - minX, maxX - originX, originY - minY, maxY - originY };
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] < 0) {
+                return false; //与该边平行且在外侧
+            }
+            continue;
+        }
+        float t = q[i] / p[i];
+        if (p[i] < 0) {
+            if (t > enter) {
+                enter = t;
+            }
+        } else {
+            if (t < leave) {
+                leave = t;
+            }
+        }
+        if (enter > leave) {
+            return false;
+        }
+    }
+    return true;
+}
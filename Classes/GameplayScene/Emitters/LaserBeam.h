@@ -0,0 +1,55 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef LASER_BEAM_H
+#define LASER_BEAM_H
+
+/* 激光：从起点出发、带宽度的线段，整条光束只是一个实体
+ *
+ *  + 依次经过预警（WARMUP，细而半透明，不判定）、照射（ACTIVE，按 sweep 扫动并判定）、
+ *    消散（FADE，变细，不判定）三个阶段
+ *  + 判定为线段与盒子求交，盒子按半个宽度外扩，每个目标每帧一次
+ *  + 不依赖 cocos2d，起点由 Laser 每帧写入
+ */
+
+struct LaserBeam
+{
+    enum Phase
+    {
+        WARMUP,
+        ACTIVE,
+        FADE,
+        DONE,
+    };
+
+    float originX;
+    float originY;
+    float angle;  //角度制，以 x 轴正方向为 0，逆时针为正
+    float sweep;  //照射阶段每秒转过的角度
+    float length; //长度
+    float width;  //照射阶段的宽度
+    float warmup; //各阶段时长
+    float active;
+    float fade;
+    float age;
+
+    LaserBeam();
+
+    /* 推进 dt 秒，照射阶段按 sweep 转动 */
+    void advance(float dt);
+
+    Phase getPhase() const;
+    bool isLethal() const { return getPhase() == ACTIVE; }
+
+    /* 当前显示宽度：预警时为细线，消散时逐渐变细 */
+    float getVisibleWidth() const;
+
+    /* 终点 */
+    void getEnd(float& x, float& y) const;
+
+    /* 线段是否与按 width / 2 外扩后的盒子 [minX, maxX] x [minY, maxY] 相交 */
+    bool overlapsBox(float minX, float minY, float maxX, float maxY) const;
+};
+
+#endif // LASER_BEAM_H
@@ -0,0 +1,79 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "Pattern.h"
+#include "BulletArchetype.h"
+#include "GameplayScene/common.h"
+#include "PatternCompiler.h"
+#include "cocos2d.h"
+
+using json = nlohmann::json;
+
+USING_NS_CC;
+
+PatternLibrary* PatternLibrary::_self;
+
+PatternLibrary*
+PatternLibrary::getInstance()
+{
+    if (!_self) {
+        _self = new (std::nothrow) PatternLibrary();
+    }
+    return _self;
+}
+
+/* 模式数据只读，直接从包内读取 */
+static json
+readGameData(const std::string& file)
+{
+    std::string content = FileUtils::getInstance()->getStringFromFile("gamedata/" + file);
+    if (content.empty()) {
+        return json::array();
+    }
+    try {
+        return json::parse(content);
+    } catch (std::exception& e) {
+        log("[Pattern] %s: %s", file.c_str(), e.what());
+        return json::array();
+    }
+}
+
+int
+PatternLibrary::load()
+{
+    patterns.clear();
+
+    //子弹帧名必须已在 SpriteFrameCache 中，掩码取游戏中的种别
+    PatternCompileOptions options;
+    options.frameExists = [](const std::string& name) {
+        return SpriteFrameCache::getInstance()->getSpriteFrameByName(name) != nullptr;
+    };
+    options.bulletCategory = bulletCategory;
+    options.playerCategory = playerCategory;
+    options.enemyCategory = enemyCategory;
+
+    std::vector<std::string> errors;
+    int failed = compileGameData(readGameData("patterns.json"),
+                                 readGameData("spell_cards.json"), options, patterns, errors);
+    for (auto& error : errors) {
+        log("[Pattern] %s", error.c_str());
+    }
+
+    //子弹种类登记为原型编号，PatternStyle 切换子弹时不再查表
+    for (auto& p : patterns) {
+        auto& pattern = p.second;
+        for (auto& bc : pattern.archetypes) {
+            pattern.archetypeIds.push_back(ArchetypeRegistry::getInstance()->intern(bc));
+        }
+    }
+
+    return failed;
+}
+
+const Pattern*
+PatternLibrary::getPattern(const std::string& tag) const
+{
+    auto it = patterns.find(tag);
+    return it == patterns.end() ? nullptr : &it->second;
+}
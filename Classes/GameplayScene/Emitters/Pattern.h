@@ -0,0 +1,80 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "DirectionTable.h"
+#include "StyleConfig.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/* 弹幕模式字节码
+ *
+ *  + 模式定义在 gamedata/patterns.json 与 gamedata/spell_cards.json（各符卡的 "pattern"）中，
+ *    载入时编译为定长指令，由 PatternRunner 解释，PatternStyle 在 Emitter 下发射
+ *  + 编译时完成校验与预处理：子弹帧名必须已在 SpriteFrameCache 中，
+ *    环形弹的角度间隔、起始偏移与方向表提前算好，repeat 展开为向回跳转
+ *  + 数据中的指令：ring、aim、rotate、wait、repeat（body 为循环体，省略 times 为无限循环，
+ *    循环体内必须有 wait）、bullet（切换 "bullets" 中定义的子弹）、style（启动原有弹幕类型）
+ *  + 角度为角度制，以 x 轴正方向为 0，逆时针为正
+ */
+
+enum class PatternOp : uint8_t
+{
+    SPAWN_RING, //发射一圈子弹：count，jump 方向表下标，a 角度间隔，b 起始偏移，c 速度，d 寿命
+    AIM,        //朝向目标（角色为面朝方向）
+    ROTATE,     //角度增加 a
+    WAIT,       //等待 a 秒
+    REPEAT,     //循环体执行满 count 次后继续，否则跳转到 jump；count 为 0 时无限循环
+    ARCHETYPE,  //切换子弹种类为 archetypes[index]
+    PLAY_STYLE, //以 styles[index] 启动一个原有的弹幕类型
+    END,
+};
+
+struct PatternInstruction
+{
+    PatternOp op;
+    uint16_t index; // count 或表下标，视指令而定
+    uint16_t jump;
+    float a;
+    float b;
+    float c;
+    float d;
+};
+
+struct Pattern
+{
+    std::string tag;
+    int manaCost; //作为符卡使用时消耗的灵力，非符卡为 0
+    std::vector<PatternInstruction> code;
+    std::vector<BulletConfig> archetypes;
+    std::vector<uint16_t> archetypeIds; // archetypes 在 ArchetypeRegistry 中的编号
+    std::vector<StyleConfig> styles;
+    std::vector<DirectionTable> rings; //各 SPAWN_RING 相对当前角度的方向表
+};
+
+/* 模式库：单例，GameplayScene 载入子弹素材后调用 load */
+class PatternLibrary
+{
+public:
+    static PatternLibrary* getInstance();
+
+    /* 读取并编译全部模式，重复调用会重新载入；返回编译失败的模式数 */
+    int load();
+
+    /* 不存在时返回 nullptr */
+    const Pattern* getPattern(const std::string& tag) const;
+
+private:
+    PatternLibrary() {}
+    static PatternLibrary* _self;
+
+    std::map<std::string, Pattern> patterns;
+};
+
+#endif // PATTERN_H
@@ -0,0 +1,279 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "PatternCompiler.h"
+
+using json = nlohmann::json;
+
+#include <cfloat>
+#include <stdexcept>
+
+// 单个环形弹的子弹数上限
+#define PATTERN_RING_MAX 512
+// 循环嵌套深度上限
+#define PATTERN_DEPTH_MAX 8
+
+#define PATTERN_PI 3.14159265358979323846f
+#define PATTERN_RADIANS(__DEGREES__) ((__DEGREES__)*PATTERN_PI / 180.0f)
+
+/* 编译过程中的状态，错误信息以异常抛出，由 compilePattern 统一捕获 */
+struct PatternCompileContext
+{
+    const PatternCompileOptions* options;
+    Pattern* pattern;
+    std::map<std::string, int> archetypeIndex; // "bullets" 中的名字 -> archetypes 下标
+};
+
+static void
+compileAssert(bool condition, const std::string& message)
+{
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+// pattern["bullets"][name] -> BulletConfig
+static BulletConfig
+compileArchetype(const PatternCompileContext& ctx, const json& j)
+{
+    const PatternCompileOptions& options = *ctx.options;
+    BulletConfig bc;
+    bc.name = j.at("name").get<std::string>();
+    compileAssert(!options.frameExists || options.frameExists(bc.name),
+                  "unknown sprite frame " + bc.name);
+    bc.length = j.value("length", 10);
+    bc.width = j.value("width", 10);
+    bc.harm = j.value("harm", 10);
+
+    // hits 指定子弹可命中的一方，与原先手写的三个掩码一一对应
+    std::string hits = j.value("hits", std::string("none"));
+    if (hits == "enemy") {
+        bc._categoryBitmask = options.bulletCategory;
+        bc._collisionBitmask = options.enemyCategory;
+        bc._contactTestBitmask = options.enemyCategory;
+    } else if (hits == "player") {
+        bc._categoryBitmask = options.bulletCategory;
+        bc._collisionBitmask = options.playerCategory;
+        bc._contactTestBitmask = options.playerCategory;
+    } else {
+        compileAssert(hits == "none", "unknown hits value " + hits);
+        bc._categoryBitmask = 0;
+        bc._collisionBitmask = 0;
+        bc._contactTestBitmask = 0;
+    }
+
+    // homing 为追踪的转向速率（度/秒），只对直线飞行的子弹生效
+    bc.homing = j.value("homing", 0);
+    compileAssert(bc.homing >= 0, "negative homing rate");
+
+    // trail 为 true 时子弹带拖尾（残影），由 BulletRenderer 按图集合批绘制
+    bc.trail = j.value("trail", false);
+    return bc;
+}
+
+static int
+findArchetype(const PatternCompileContext& ctx, const std::string& name)
+{
+    auto it = ctx.archetypeIndex.find(name);
+    compileAssert(it != ctx.archetypeIndex.end(), "unknown bullet " + name);
+    return it->second;
+}
+
+static StyleType
+compileStyleType(const std::string& name)
+{
+    if (name == "LASER") {
+        return StyleType::LASER;
+    } else if (name == "ODDEVEN") {
+        return StyleType::ODDEVEN;
+    } else if (name == "PARABOLA") {
+        return StyleType::PARABOLA;
+    } else if (name == "PARALLEL") {
+        return StyleType::PARALLEL;
+    } else if (name == "SCATTER") {
+        return StyleType::SCATTER;
+    }
+    throw std::runtime_error("unknown style " + name);
+}
+
+// {"op": "style", ...} -> StyleConfig，未给出的参数为 0，持续时间与次数默认不限
+static StyleConfig
+compileStyle(const PatternCompileContext& ctx, const json& j)
+{
+    StyleConfig sc = StyleConfig();
+    sc.style = compileStyleType(j.at("type").get<std::string>());
+    sc.frequency = j.value("frequency", 0.0f);
+    sc.bulletDuration = j.at("bulletDuration").get<float>();
+    sc.number = j.at("number").get<unsigned int>();
+    sc.countThenChangePos = j.value("countThenChangePos", 0u);
+    sc.totalDuration = j.value("totalDuration", FLT_MAX);
+    sc.cycleTimes = (unsigned int)j.value("cycleTimes", -1);
+    sc.height = j.value("height", 0);
+    sc.distance = j.value("distance", 0);
+    sc.interval = j.value("interval", 0.0f);
+    sc.startAngle = j.value("startAngle", 0);
+    sc.endAngle = j.value("endAngle", 0);
+    sc.deltaAngle = j.value("deltaAngle", 0);
+    sc.bc = ctx.pattern->archetypes[findArchetype(ctx, j.at("bullet").get<std::string>())];
+
+    compileAssert(sc.bulletDuration > 0, "style bulletDuration must be positive");
+    compileAssert(sc.number > 0, "style number must be positive");
+    return sc;
+}
+
+static bool
+blockWaits(const Pattern& pattern, size_t begin)
+{
+    for (size_t pc = begin; pc < pattern.code.size(); pc++) {
+        if (pattern.code[pc].op == PatternOp::WAIT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+emit(Pattern& pattern, const PatternInstruction& instruction)
+{
+    compileAssert(pattern.code.size() < UINT16_MAX, "program too long");
+    pattern.code.push_back(instruction);
+}
+
+static void
+compileBlock(PatternCompileContext& ctx, const json& block, int depth)
+{
+    compileAssert(block.is_array(), "program must be an array");
+    compileAssert(depth < PATTERN_DEPTH_MAX, "repeat nested too deep");
+    Pattern& pattern = *ctx.pattern;
+
+    for (auto& j : block) {
+        std::string op = j.at("op").get<std::string>();
+        PatternInstruction ins = PatternInstruction();
+
+        if (op == "ring") {
+            int count = j.at("count").get<int>();
+            float spread = j.value("spread", 360.0f);
+            compileAssert(count > 0 && count <= PATTERN_RING_MAX, "ring count out of range");
+            compileAssert(!pattern.archetypes.empty(), "ring without bullets");
+            ins.op = PatternOp::SPAWN_RING;
+            ins.index = (uint16_t)count;
+            //整圈时首尾不重合，扇形时首尾落在 ±spread/2 上
+            if (spread >= 360.0f) {
+                ins.a = 360.0f / count;
+                ins.b = 0;
+            } else {
+                ins.a = count > 1 ? spread / (count - 1) : 0;
+                ins.b = count > 1 ? -spread / 2 : 0;
+            }
+            ins.c = j.at("speed").get<float>();
+            ins.d = j.at("life").get<float>();
+            compileAssert(ins.c > 0 && ins.d > 0, "ring speed and life must be positive");
+            compileAssert(pattern.rings.size() < UINT16_MAX, "too many rings");
+            ins.jump = (uint16_t)pattern.rings.size();
+            pattern.rings.emplace_back();
+            pattern.rings.back().build(count, PATTERN_RADIANS(ins.b), PATTERN_RADIANS(ins.a));
+        } else if (op == "aim") {
+            ins.op = PatternOp::AIM;
+        } else if (op == "rotate") {
+            ins.op = PatternOp::ROTATE;
+            ins.a = j.at("angle").get<float>();
+        } else if (op == "wait") {
+            ins.op = PatternOp::WAIT;
+            ins.a = j.at("time").get<float>();
+            compileAssert(ins.a > 0, "wait time must be positive");
+        } else if (op == "repeat") {
+            int times = j.value("times", 0);
+            compileAssert(times >= 0 && times < UINT16_MAX, "repeat times out of range");
+            size_t begin = pattern.code.size();
+            compileBlock(ctx, j.at("body"), depth + 1);
+            compileAssert(pattern.code.size() > begin, "empty repeat body");
+            compileAssert(times != 0 || blockWaits(pattern, begin), "endless repeat without wait");
+            ins.op = PatternOp::REPEAT;
+            ins.index = (uint16_t)times;
+            ins.jump = (uint16_t)begin;
+        } else if (op == "bullet") {
+            ins.op = PatternOp::ARCHETYPE;
+            ins.index = (uint16_t)findArchetype(ctx, j.at("name").get<std::string>());
+        } else if (op == "style") {
+            pattern.styles.push_back(compileStyle(ctx, j));
+            ins.op = PatternOp::PLAY_STYLE;
+            ins.index = (uint16_t)(pattern.styles.size() - 1);
+        } else {
+            throw std::runtime_error("unknown op " + op);
+        }
+
+        emit(pattern, ins);
+    }
+}
+
+bool
+compilePattern(const std::string& tag, const json& j, const PatternCompileOptions& options,
+               Pattern& pattern, std::string& error)
+{
+    pattern.tag = tag;
+    pattern.manaCost = 0;
+    pattern.code.clear();
+    pattern.archetypes.clear();
+    pattern.archetypeIds.clear();
+    pattern.styles.clear();
+    pattern.rings.clear();
+
+    try {
+        PatternCompileContext ctx;
+        ctx.options = &options;
+        ctx.pattern = &pattern;
+        pattern.manaCost = j.value("mana", 0);
+
+        if (j.count("bullets")) {
+            for (auto it = j.at("bullets").begin(); it != j.at("bullets").end(); ++it) {
+                ctx.archetypeIndex[it.key()] = (int)pattern.archetypes.size();
+                pattern.archetypes.push_back(compileArchetype(ctx, it.value()));
+            }
+        }
+
+        compileBlock(ctx, j.at("program"), 0);
+
+        PatternInstruction end = PatternInstruction();
+        end.op = PatternOp::END;
+        emit(pattern, end);
+    } catch (std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    return true;
+}
+
+int
+compileGameData(const json& patterns, const json& spellCards,
+                const PatternCompileOptions& options, std::map<std::string, Pattern>& out,
+                std::vector<std::string>& errors)
+{
+    int failed = 0;
+    std::string error;
+
+    // patterns.json: [{"tag": ..., "bullets": {...}, "program": [...]}, ...]
+    for (auto& j : patterns) {
+        std::string tag = j.value("tag", std::string());
+        if (!compilePattern(tag, j, options, out[tag], error)) {
+            out.erase(tag);
+            errors.push_back(tag + ": " + error);
+            failed++;
+        }
+    }
+
+    // spell_cards.json: 带有 "pattern" 的符卡，以符卡标签作为模式标签
+    for (auto& card : spellCards) {
+        if (!card.count("pattern")) {
+            continue;
+        }
+        std::string tag = card.value("tag", std::string());
+        if (!compilePattern(tag, card.at("pattern"), options, out[tag], error)) {
+            out.erase(tag);
+            errors.push_back(tag + ": " + error);
+            failed++;
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,41 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef PATTERN_COMPILER_H
+#define PATTERN_COMPILER_H
+
+#include "Pattern.h"
+
+#include "external/json.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/* 模式编译器：把 JSON 定义编译为 Pattern 的字节码（见 Pattern.h）
+ *
+ *  + 不依赖 cocos2d，游戏内由 PatternLibrary 调用，离线工具（tools/pattern_sim）直接链接
+ *  + 纹理帧校验与种别掩码由调用者给出，编译结果不含原型编号（archetypeIds 为空）
+ */
+
+struct PatternCompileOptions
+{
+    std::function<bool(const std::string&)> frameExists; //子弹帧名是否存在，为空时不校验
+    int bulletCategory; // "hits" 不为 none 时子弹自身的种别
+    int playerCategory; // "hits": "player"
+    int enemyCategory;  // "hits": "enemy"
+};
+
+/* 编译一个模式，失败时返回 false，原因写入 error */
+bool compilePattern(const std::string& tag, const nlohmann::json& j,
+                    const PatternCompileOptions& options, Pattern& pattern, std::string& error);
+
+/* 编译 patterns.json 与 spell_cards.json（带 "pattern" 的符卡，以符卡标签作为模式标签）中的
+ * 全部模式，写入 out；返回编译失败的模式数，各自的原因以 "tag: 原因" 追加到 errors */
+int compileGameData(const nlohmann::json& patterns, const nlohmann::json& spellCards,
+                    const PatternCompileOptions& options, std::map<std::string, Pattern>& out,
+                    std::vector<std::string>& errors);
+
+#endif // PATTERN_COMPILER_H
@@ -0,0 +1,81 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "PatternRunner.h"
+
+// 掉帧时最多补执行的时间，超出部分丢弃
+#define PATTERN_MAX_LAG 0.25f
+// 每次最多执行的指令数，防止数据错误导致死循环
+#define PATTERN_MAX_STEPS 4096
+
+PatternRunner::PatternRunner(const Pattern* pattern)
+    : pattern(pattern)
+    , pc(0)
+    , wait(0)
+    , angle(0)
+    , finished(false)
+{
+    counters.assign(pattern->code.size(), 0);
+}
+
+void
+PatternRunner::step(float dt, PatternHost& host)
+{
+    if (finished) {
+        return;
+    }
+    wait -= dt;
+    if (wait < -PATTERN_MAX_LAG) {
+        wait = -PATTERN_MAX_LAG;
+    }
+
+    //执行到下一次等待为止，wait 的余数留到下一次；此时 -wait 即指令在本次内已经过的时间
+    int steps = 0;
+    while (wait <= 0 && !finished && steps++ < PATTERN_MAX_STEPS) {
+        unsigned int at = pc++;
+        const PatternInstruction& ins = pattern->code[at];
+
+        switch (ins.op) {
+            case PatternOp::SPAWN_RING:
+                host.spawnRing(ins, angle, -wait);
+                break;
+            case PatternOp::AIM:
+                angle = host.aimAngle();
+                break;
+            case PatternOp::ROTATE:
+                angle += ins.a;
+                break;
+            case PatternOp::WAIT:
+                wait += ins.a;
+                break;
+            case PatternOp::REPEAT:
+                if (ins.index == 0 || ++counters[at] < ins.index) {
+                    pc = ins.jump;
+                } else {
+                    counters[at] = 0;
+                }
+                break;
+            case PatternOp::ARCHETYPE:
+                host.setArchetype(ins.index);
+                break;
+            case PatternOp::PLAY_STYLE:
+                host.playStyle(pattern->styles[ins.index]);
+                break;
+            case PatternOp::END:
+                finished = true;
+                break;
+        }
+    }
+}
+
+Trajectory
+PatternRunner::ringBullet(const PatternInstruction& ring, const DirectionTable& directions, int i,
+                          float angle, float x, float y)
+{
+    float degrees = angle + ring.b + i * ring.a;
+    auto trajectory =
+        Trajectory::linear(x, y, ring.c * directions.getX(i), ring.c * directions.getY(i));
+    trajectory.rotation = 90.0f - degrees;
+    return trajectory;
+}
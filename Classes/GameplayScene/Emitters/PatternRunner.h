@@ -0,0 +1,68 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef PATTERN_RUNNER_H
+#define PATTERN_RUNNER_H
+
+#include "Pattern.h"
+#include "Trajectory.h"
+
+#include <cstdint>
+#include <vector>
+
+/* 字节码解释器：PatternStyle 与 pattern_sim 的 HeadlessPattern 共用
+ *
+ *  + 只维护指令位置、等待时间、当前角度与各 repeat 的计数，发射、瞄准、启动弹幕交给 PatternHost
+ *  + 每次 step 执行到下一次等待为止，等待的余数留到下一次；掉帧时最多补执行 0.25 秒，
+ *    每次最多执行 4096 条指令，防止数据错误导致死循环
+ *  + 不依赖 cocos2d
+ */
+
+/* 解释器执行指令时的回调 */
+class PatternHost
+{
+public:
+    virtual ~PatternHost() {}
+
+    /* 以 angle 为当前角度发射一圈，offset 为该指令在本次 step 内已经过的时间 */
+    virtual void spawnRing(const PatternInstruction& ring, float angle, float offset) = 0;
+
+    /* aim 指令：返回朝向目标的角度 */
+    virtual float aimAngle() = 0;
+
+    /* 切换子弹种类为 archetypes[index] */
+    virtual void setArchetype(unsigned int index) = 0;
+
+    /* 启动一个原有的弹幕类型 */
+    virtual void playStyle(const StyleConfig& sc) = 0;
+};
+
+class PatternRunner
+{
+public:
+    explicit PatternRunner(const Pattern* pattern);
+
+    /* 推进 dt 秒，按顺序执行到期的指令 */
+    void step(float dt, PatternHost& host);
+
+    /* 已执行到 END */
+    bool isFinished() const { return finished; }
+
+    float getAngle() const { return angle; }
+
+    /* 一圈中第 i 颗子弹的轨迹：directions 为 rings[ring.jump] 转过 angle 度后的方向表，
+     * 子弹从 (x, y) 出发，素材朝上，朝向与 Node::setRotation 一致 */
+    static Trajectory ringBullet(const PatternInstruction& ring, const DirectionTable& directions,
+                                 int i, float angle, float x, float y);
+
+private:
+    const Pattern* pattern;
+    unsigned int pc;                //下一条指令
+    float wait;                     //距离执行下一条指令的时间，小于 0 为本次已超出的时间
+    float angle;                    //当前角度
+    std::vector<uint16_t> counters; //各 repeat 指令已执行的次数
+    bool finished;
+};
+
+#endif // PATTERN_RUNNER_H
@@ -0,0 +1,159 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstdint>
+#include <vector>
+
+/* 带代数的句柄，index 为槽位，generation 为 0 时无效 */
+struct SlotHandle
+{
+    uint32_t index;
+    uint32_t generation;
+
+    SlotHandle()
+        : index(0)
+        , generation(0)
+    {
+    }
+    SlotHandle(uint32_t index, uint32_t generation)
+        : index(index)
+        , generation(generation)
+    {
+    }
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const SlotHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/* 槽位表：弹幕登记在场子弹用
+ *
+ *  + 插入返回句柄，插入与删除都是 O(1)，元素在 values 中连续存放，遍历与 std::vector 相同
+ *  + 删除时以末尾元素填补空位，元素顺序会改变；遍历过程中不得删除
+ *  + 槽位复用时代数加一，已删除元素的旧句柄不会指向新元素，可安全地留在回调中
+ *  + 不持有元素的引用，也不依赖 cocos2d
+ */
+
+template <typename T>
+class SlotMap
+{
+public:
+    SlotMap()
+        : freeHead(NO_SLOT)
+    {
+    }
+
+    SlotHandle insert(const T& value)
+    {
+        uint32_t index;
+        if (freeHead != NO_SLOT) {
+            index = freeHead;
+            freeHead = slots[index].dense;
+        } else {
+            index = (uint32_t)slots.size();
+            slots.push_back(Slot{ 0, 1 });
+        }
+        slots[index].dense = (uint32_t)values.size();
+        values.push_back(value);
+        owners.push_back(index);
+        return SlotHandle(index, slots[index].generation);
+    }
+
+    /* 句柄已失效时返回 false */
+    bool erase(SlotHandle handle)
+    {
+        if (!contains(handle)) {
+            return false;
+        }
+        uint32_t dense = slots[handle.index].dense;
+        uint32_t last = (uint32_t)values.size() - 1;
+        if (dense != last) {
+            values[dense] = values[last];
+            owners[dense] = owners[last];
+            slots[owners[dense]].dense = dense;
+        }
+        values.pop_back();
+        owners.pop_back();
+        freeSlot(handle.index);
+        return true;
+    }
+
+    /* 句柄已失效时返回 nullptr */
+    T* get(SlotHandle handle)
+    {
+        return contains(handle) ? &values[slots[handle.index].dense] : nullptr;
+    }
+    const T* get(SlotHandle handle) const
+    {
+        return contains(handle) ? &values[slots[handle.index].dense] : nullptr;
+    }
+
+    bool contains(SlotHandle handle) const
+    {
+        return handle.isValid() && handle.index < slots.size() &&
+               slots[handle.index].generation == handle.generation;
+    }
+
+    void clear()
+    {
+        for (auto index : owners) {
+            freeSlot(index);
+        }
+        values.clear();
+        owners.clear();
+    }
+
+    void reserve(int capacity)
+    {
+        values.reserve(capacity);
+        owners.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    int size() const { return (int)values.size(); }
+    bool empty() const { return values.empty(); }
+
+    /* 按存放顺序访问，i 不是句柄 */
+    T& operator[](int i) { return values[i]; }
+    const T& operator[](int i) const { return values[i]; }
+
+    typename std::vector<T>::iterator begin() { return values.begin(); }
+    typename std::vector<T>::iterator end() { return values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return values.end(); }
+
+private:
+    static const uint32_t NO_SLOT = 0xffffffffu;
+
+    struct Slot
+    {
+        uint32_t dense;      //占用时为 values 下标，空闲时为下一个空闲槽位
+        uint32_t generation; //每次释放加一，跳过 0
+    };
+
+    void freeSlot(uint32_t index)
+    {
+        Slot& slot = slots[index];
+        slot.generation++;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.dense = freeHead;
+        freeHead = index;
+    }
+
+private:
+    std::vector<T> values;
+    std::vector<uint32_t> owners; // values 下标 -> 槽位
+    std::vector<Slot> slots;
+    uint32_t freeHead;
+};
+
+#endif // SLOT_MAP_H
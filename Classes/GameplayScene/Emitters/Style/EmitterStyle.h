@@ -5,26 +5,73 @@
 #ifndef EMITTER_STYLE_H
 #define EMITTER_STYLE_H
 
-#include "GameplayScene/Emitters/Bullet.h"
+#include "GameplayScene/Emitters/BulletLayer.h"
+#include "GameplayScene/Emitters/EmitterSystem.h"
+#include "GameplayScene/Emitters/FastRandom.h"
+#include "GameplayScene/Emitters/SlotMap.h"
 #include "GameplayScene/Emitters/StyleConfig.h"
+#include "GameplayScene/Emitters/StyleLifetime.h"
 #include "GameplayScene/common.h"
 #include "cocos2d.h"
 
 USING_NS_CC;
 
-class EmitterStyle : public Node
+/* 发射时用到的节点：弹幕挂在 角色（或发射台）-> Emitter -> 弹幕 之下，角色挂在 mapLayer 下。
+ * 进入场景时取一次，发射时不再逐颗子弹向上查找父节点和子弹层 */
+struct SpawnContext
+{
+    Node* character;
+    Node* mapLayer;
+    BulletLayer* bulletLayer;
+};
+
+/* 弹幕的基类：节点只用于挂在发射器下并随角色暂停、移除，发射的子弹不是节点，
+ * 在场子弹表与释放时机由 StyleLifetime 管理 */
+class EmitterStyle
+    : public Node
+    , public StyleLifetime
 {
 public:
-    void removeBullet(Node* pNode)
+    EmitterStyle()
+        : ownerMask(0)
+        , priority(BulletPriority::AIMED)
+        , despawn(DespawnPolicy::area(STYLE_DESPAWN_MARGIN))
+        , spawnOffset(0)
+        , archetype(0)
+        , context(SpawnContext{ nullptr, nullptr, nullptr })
+        , suspended(false)
+        , systemIndex(-1)
     {
-        if (NULL == pNode) {
-            return;
-        }
-        pNode->removeFromParent();
-        bullets.eraseObject(pNode);
     }
 
-    Vector<Node*>& getBullets() { return bullets; }
+    ~EmitterStyle()
+    {
+        //在场子弹继续飞行，由 StyleLifetime 的析构断开与子弹场的联系
+        EmitterSystem::getInstance()->remove(this);
+    }
+
+    /* 停止发射并交由在场子弹决定生命周期：没有在场子弹时立即从发射器移除，
+     * 否则在最后一颗子弹离场时移除。调用者需已放开自己持有的引用 */
+    virtual void retire() override
+    {
+        stopShoot();
+        StyleLifetime::retire();
+    }
+
+    /* 发射方种别掩码，写入子弹场 */
+    void setOwnerMask(unsigned int mask) { ownerMask = mask; }
+    unsigned int getOwnerMask() const { return ownerMask; }
+
+    /* 子弹预算的优先级，写入子弹场 */
+    void setPriority(BulletPriority priority) { this->priority = priority; }
+    BulletPriority getPriority() const { return priority; }
+
+    /* 子弹出界回收规则 */
+    void setDespawnPolicy(const DespawnPolicy& despawn) { this->despawn = despawn; }
+    const DespawnPolicy& getDespawnPolicy() const { return despawn; }
+
+    /* 随机参数的种子，由发射器在创建弹幕时派生 */
+    void seedRandom(uint64_t seed) { rng.seed(seed); }
 
     virtual void startShoot() = 0;
     virtual void stopShoot() = 0;
@@ -32,9 +79,69 @@ public:
 
     virtual void spawnBullet() = 0;
 
+    /* 由 EmitterSystem 每帧调用，默认只推进发射节拍 */
+    virtual void tick(float dt) { shootBullet(dt); }
+
+    /* 已进入场景、未暂停时才推进 */
+    bool isTickable() const { return _running && !suspended && context.bulletLayer; }
+
+    virtual void onEnter() override
+    {
+        Node::onEnter();
+        auto emitter = this->getParent();
+        context.character = emitter ? emitter->getParent() : nullptr;
+        context.mapLayer = context.character ? context.character->getParent() : nullptr;
+        context.bulletLayer =
+            context.mapLayer ? BulletLayer::getLayerOf(context.mapLayer) : nullptr;
+        archetype = ArchetypeRegistry::getInstance()->intern(sc.bc);
+    }
+
+    /* 暂停与恢复同时影响 EmitterSystem 的推进，onExit、onEnter 也会调用 */
+    virtual void pause() override
+    {
+        Node::pause();
+        suspended = true;
+    }
+    virtual void resume() override
+    {
+        Node::resume();
+        suspended = false;
+    }
+
+protected:
+    /* 开始、停止由 EmitterSystem 推进发射节拍，代替各自向调度器注册 shootBullet */
+    void startTicking() { EmitterSystem::getInstance()->add(this); }
+    void stopTicking() { EmitterSystem::getInstance()->remove(this); }
+
+    /* 最后一颗子弹离场，弹幕随之释放，此后不得再访问成员 */
+    virtual void releaseStyle() override { this->removeFromParent(); }
+
+    /* 将子弹写入子弹场，按给定轨迹飞行 life 秒后回收；超出子弹预算被拒绝时不发射 */
+    void launchBullet(const Trajectory& trajectory, float life, float scale = 1.0f)
+    {
+        auto layer = context.bulletLayer;
+        int index = layer->addBullet(archetype, trajectory, life, this, ownerMask, despawn,
+                                     spawnOffset, priority);
+        if (index >= 0) {
+            layer->getField().scale[index] = scale;
+        }
+    }
+
 protected:
-    StyleConfig sc;        // Style参数
-    Vector<Node*> bullets; //子弹容器
+    StyleConfig sc;           // Style参数
+    unsigned int ownerMask;   //发射方种别掩码
+    BulletPriority priority;  //子弹预算的优先级
+    DespawnPolicy despawn;    //出界回收规则
+    float spawnOffset;        //正在发射的一轮在本帧内已经过的时间
+    FastRandom rng;           //本弹幕的随机参数
+    unsigned short archetype; // sc.bc 登记的原型编号，修改 sc.bc 后需一并更新
+    SpawnContext context;     //进入场景时取得的发射节点
+
+private:
+    friend class EmitterSystem;
+
+    bool suspended;  //已暂停，EmitterSystem 跳过
+    int systemIndex; //在 EmitterSystem 中的下标，未登记为 -1
 };
 
 /* 无自机默认弹幕 */
@@ -4,77 +4,91 @@
 
 #include "Laser.h"
 
-Laser::Laser(Node** target)
+StyleConfig
+Laser::defaultConfig(bool player)
 {
-    this->sc.totalDuration = FLT_MAX;
-    this->sc.cycleTimes = -1;
-
-    this->isPlayer = false;
-    this->target = target;
+    auto sc = VolleyRunner::defaultConfig(StyleType::LASER, player);
+    sc.bc._categoryBitmask = bulletCategory;
+    sc.bc._collisionBitmask = player ? enemyCategory : playerCategory;
+    sc.bc._contactTestBitmask = player ? enemyCategory : playerCategory;
+    return sc;
+}
 
-    this->counter = 0;
-    this->spawnBulletCycleTimes = 0;
-    this->timeAccumulation = 0;
-    this->elapsed = 0;
+Laser::Laser(Node** target)
+    : VolleyStyle(defaultConfig(false), target)
+    , shooting(false)
+{
 }
 
 Laser::Laser(const StyleConfig& sc, Node** target)
+    : VolleyStyle(sc, target)
+    , shooting(false)
 {
-    this->isPlayer = false;
-    this->sc = sc;
-    this->target = target;
-
-    this->counter = 0;
-    this->spawnBulletCycleTimes = 0;
-    this->timeAccumulation = 0;
-    this->elapsed = 0;
 }
 
 Laser::Laser(Direction* direction)
+    : VolleyStyle(defaultConfig(true), direction)
+    , shooting(false)
 {
-    this->sc.totalDuration = FLT_MAX;
-    this->sc.cycleTimes = -1;
-
-    this->isPlayer = true;
-    this->direction = direction;
-
-    this->counter = 0;
-    this->spawnBulletCycleTimes = 0;
-    this->timeAccumulation = 0;
-    this->elapsed = 0;
 }
 
 Laser::Laser(const StyleConfig& sc, Direction* direction)
+    : VolleyStyle(sc, direction)
+    , shooting(false)
 {
-    this->isPlayer = true;
-    this->direction = direction;
-    this->sc = sc;
-
-    this->counter = 0;
-    this->spawnBulletCycleTimes = 0;
-    this->timeAccumulation = 0;
-    this->elapsed = 0;
 }
 
 void
 Laser::startShoot()
 {
-    this->schedule(schedule_selector(Laser::shootBullet), sc.frequency);
+    shooting = true;
+    VolleyStyle::startShoot();
 }
 
 void
 Laser::stopShoot()
 {
-    this->unschedule(schedule_selector(Laser::shootBullet));
+    //停止发射后仍留在 EmitterSystem 中推进光束，光束全部消散后注销
+    shooting = false;
+}
+
+void
+Laser::tick(float dt)
+{
+    if (shooting) {
+        shootBullet(dt);
+    }
+    trackBeams();
 }
 
 void
-Laser::shootBullet(float dt)
+Laser::fireBeam(const LaserBeam& beam)
 {
-    spawnBullet();
+    //光束由子弹层推进、检测与绘制，与子弹相同登记到本弹幕，在场时弹幕不释放
+    beams.push_back(context.bulletLayer->addBeam(archetype, beam, this, ownerMask));
 }
 
 void
-Laser::spawnBullet()
+Laser::trackBeams()
 {
+    auto& simulation = context.bulletLayer->getSimulation();
+    auto pos = context.character->getPosition();
+
+    //消散的光束已由子弹层移除并交还，这里只去掉句柄
+    for (auto it = beams.begin(); it != beams.end();) {
+        auto beam = simulation.getBeam(*it);
+        if (nullptr == beam) {
+            it = beams.erase(it);
+            continue;
+        }
+
+        //起点跟随角色
+        beam->originX = pos.x;
+        beam->originY = pos.y;
+        ++it;
+    }
+
+    if (!shooting && beams.empty()) {
+        stopTicking();
+    }
 }
@@ -1,48 +1,60 @@
-﻿#ifdef WIN32
-#pragma execution_character_set("utf-8")
-#endif
-
-#ifndef LASER_H
-#define LASER_H
-
-#include "EmitterStyle.h"
-
-/*  激光型弹幕：预警后射出攻击光线
-    特点：玩家，敌人，自机 */
-
-class Laser : public EmitterStyle
-{
-public:
-    /* 自机默认弹幕 */
-    APP_CREATE_STYLE2(Laser);
-    Laser(Node** target);
-
-    /* 自机定制弹幕 */
-    APP_CREATE_STYLE3(Laser);
-    Laser(const StyleConfig& sc, Node** target);
-
-    /* 角色默认弹幕 */
-    APP_CREATE_STYLE4(Laser);
-    Laser(Direction* direction);
-
-    /* 角色定制弹幕 */
-    APP_CREATE_STYLE5(Laser);
-    Laser(const StyleConfig& sc, Direction* direction);
-
-    /* 调度器 */
-    void startShoot();
-    void stopShoot();
-    void shootBullet(float dt);
-    void spawnBullet();
-
-private:
-    bool isPlayer;
-    Node** target;
-    Direction* direction;
-    int counter;
-
-    float timeAccumulation;
-    float elapsed;
-    unsigned int spawnBulletCycleTimes; //发射函数循环次数
-};
-#endif // !LASER_H
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef LASER_H
+#define LASER_H
+
+#include "VolleyStyle.h"
+
+#include <vector>
+
+/*  激光型弹幕：预警后射出攻击光线
+    特点：玩家，敌人，自机
+
+    每轮发射 number 条光束，以目标方向（角色为面朝方向）为中心在 endAngle - startAngle 度内展开；
+    预警 LASER_WARMUP 秒后照射 bulletDuration 秒，照射时每秒转过 deltaAngle 度，再经 LASER_FADE 秒消散。
+    长度为 distance，为 0 时取窗口对角线；宽度为 bc.width，bc.name 的纹理帧沿光束拉伸。
+    光束登记到子弹层的模拟中，不是节点，由 BulletRenderer 绘制；每帧对每个目标做一次线段检测，
+    每个目标只命中一次。弹幕随角色移除后，已射出的光束停在原处直到消散 */
+
+class Laser : public VolleyStyle
+{
+public:
+    /* 自机默认弹幕 */
+    APP_CREATE_STYLE2(Laser);
+    Laser(Node** target);
+
+    /* 自机定制弹幕 */
+    APP_CREATE_STYLE3(Laser);
+    Laser(const StyleConfig& sc, Node** target);
+
+    /* 角色默认弹幕 */
+    APP_CREATE_STYLE4(Laser);
+    Laser(Direction* direction);
+
+    /* 角色定制弹幕 */
+    APP_CREATE_STYLE5(Laser);
+    Laser(const StyleConfig& sc, Direction* direction);
+
+    /* 调度器 */
+    virtual void startShoot() override;
+    virtual void stopShoot() override;
+
+    /* 发射并推进光束，停止发射后仍继续到光束全部消散 */
+    virtual void tick(float dt) override;
+
+    /* VolleyRunner 求出的光束：登记到子弹层，光束在场时弹幕不释放 */
+    virtual void fireBeam(const LaserBeam& beam) override;
+
+private:
+    void trackBeams();
+
+    /* 默认参数附带的种别掩码 */
+    static StyleConfig defaultConfig(bool player);
+
+private:
+    std::vector<SlotHandle> beams; //子弹层中的光束
+    bool shooting; //未停止发射；停止后等光束消散
+};
+#endif // !LASER_H
@@ -5,12 +5,12 @@
 #ifndef ODDEVEN_H
 #define ODDEVEN_H
 
-#include "EmitterStyle.h"
+#include "VolleyStyle.h"
 
 /* 奇偶数自机狙型弹幕
    特点：敌人，自机  */
 
-class OddEven : public EmitterStyle
+class OddEven : public VolleyStyle
 {
 public:
     /* 自机默认弹幕 */
@@ -20,22 +20,6 @@ public:
     /* 自机定制弹幕 */
     APP_CREATE_STYLE3(OddEven);
     OddEven(const StyleConfig& sc, Node** target);
-
-    /* 调度器 */
-    void startShoot();
-    void stopShoot();
-    void shootBullet(float dt);
-    void spawnBullet();
-
-private:
-    Node** target;
-    Vec2 targetPos;    //角色位置
-    float angle;       //夹角
-    int counterInside; //计数器
-
-    float timeAccumulation;
-    float elapsed;
-    unsigned int spawnBulletCycleTimes; //发射函数循环次数
 };
 
 #endif // !ODDEVEN_H
@@ -5,12 +5,12 @@
 #ifndef PARABOLA_H
 #define PARABOLA_H
 
-#include "EmitterStyle.h"
+#include "VolleyStyle.h"
 
 /* 抛物线型弹幕
    特点：玩家，无自机 */
 
-class Parabola : public EmitterStyle
+class Parabola : public VolleyStyle
 {
 public:
     /* 角色默认弹幕 */
@@ -20,20 +20,6 @@ public:
     /* 角色定制弹幕 */
     APP_CREATE_STYLE5(Parabola);
     Parabola(const StyleConfig& sc, Direction* direction);
-
-    /* 调度器 */
-    void startShoot();
-    void stopShoot();
-    void shootBullet(float dt);
-    void spawnBullet();
-
-private:
-    Direction* direction;
-    unsigned int counterInside; //计数器
-
-    float timeAccumulation;
-    float elapsed;
-    unsigned int spawnBulletCycleTimes; //发射函数循环次数
 };
 
 #endif // !PARABOLA_H
@@ -5,12 +5,12 @@
 #ifndef PARALLEL_H
 #define PARALLEL_H
 
-#include "EmitterStyle.h"
+#include "VolleyStyle.h"
 
 /* 相对自身固定：指定方向平行弹幕
 特点：玩家无自机，敌人自机 */
 
-class Parallel : public EmitterStyle
+class Parallel : public VolleyStyle
 {
 public:
     /* 自机默认弹幕 */
@@ -28,24 +28,6 @@ public:
     /* 角色定制弹幕 */
     APP_CREATE_STYLE5(Parallel);
     Parallel(const StyleConfig& sc, Direction* direction);
-
-    /* 调度器 */
-    void startShoot();
-    void stopShoot();
-    void shootBullet(float dt);
-
-    void spawnBullet();
-
-private:
-    bool isPlayer;
-    Direction* direction; //玩家方向
-    Node** target;
-    Vec2 targetPos;             //角色位置
-    unsigned int counterInside; //计数器
-
-    float timeAccumulation;
-    float elapsed;
-    unsigned int spawnBulletCycleTimes; //发射函数循环次数
 };
 
 #endif
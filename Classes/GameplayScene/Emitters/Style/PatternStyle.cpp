@@ -0,0 +1,134 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "PatternStyle.h"
+#include "GameplayScene/Emitters/Emitter.h"
+
+PatternStyle*
+PatternStyle::create(const Pattern* pattern, Node** target)
+{
+    PatternStyle* pRet = new (std::nothrow) PatternStyle(pattern, target);
+    if (pRet && pRet->init()) {
+        pRet->autorelease();
+        return pRet;
+    } else {
+        delete pRet;
+        pRet = nullptr;
+        return nullptr;
+    }
+}
+
+PatternStyle::PatternStyle(const Pattern* pattern, Node** target)
+    : runner(pattern)
+{
+    this->pattern = pattern;
+    this->isPlayer = false;
+    this->target = target;
+    this->direction = nullptr;
+
+    this->ring = nullptr;
+    this->ringAngle = 0;
+    if (!pattern->archetypes.empty()) {
+        this->sc.bc = pattern->archetypes[0];
+    }
+}
+
+PatternStyle*
+PatternStyle::create(const Pattern* pattern, Direction* direction)
+{
+    PatternStyle* pRet = new (std::nothrow) PatternStyle(pattern, direction);
+    if (pRet && pRet->init()) {
+        pRet->autorelease();
+        return pRet;
+    } else {
+        delete pRet;
+        pRet = nullptr;
+        return nullptr;
+    }
+}
+
+PatternStyle::PatternStyle(const Pattern* pattern, Direction* direction)
+    : runner(pattern)
+{
+    this->pattern = pattern;
+    this->isPlayer = true;
+    this->target = nullptr;
+    this->direction = direction;
+
+    this->ring = nullptr;
+    this->ringAngle = 0;
+    if (!pattern->archetypes.empty()) {
+        this->sc.bc = pattern->archetypes[0];
+    }
+}
+
+void
+PatternStyle::startShoot()
+{
+    startTicking();
+}
+
+void
+PatternStyle::stopShoot()
+{
+    stopTicking();
+}
+
+void
+PatternStyle::shootBullet(float dt)
+{
+    runner.step(dt, *this);
+    spawnOffset = 0;
+    if (runner.isFinished()) {
+        stopShoot();
+    }
+}
+
+void
+PatternStyle::spawnRing(const PatternInstruction& ring, float angle, float offset)
+{
+    this->ring = &ring;
+    this->ringAngle = angle;
+    spawnOffset = offset;
+    spawnBullet();
+}
+
+void
+PatternStyle::spawnBullet()
+{
+    auto character = context.character;
+    auto pos = character->getPosition();
+
+    //编译好的方向表整体转到当前角度，每圈只求一次 sin/cos
+    pattern->rings[ring->jump].rotate(CC_DEGREES_TO_RADIANS(ringAngle), directions);
+
+    for (int i = 0; i < ring->index; i++) {
+        launchBullet(PatternRunner::ringBullet(*ring, directions, i, ringAngle, pos.x, pos.y),
+                     ring->d);
+    }
+}
+
+float
+PatternStyle::aimAngle()
+{
+    if (isPlayer) {
+        return (*direction) == Direction::LEFT ? 180.0f : 0.0f;
+    }
+    auto dis = (*target)->getPosition() - context.character->getPosition();
+    return CC_RADIANS_TO_DEGREES(dis.getAngle());
+}
+
+void
+PatternStyle::setArchetype(unsigned int index)
+{
+    sc.bc = pattern->archetypes[index];
+    archetype = pattern->archetypeIds[index];
+}
+
+void
+PatternStyle::playStyle(const StyleConfig& config)
+{
+    auto emitter = static_cast<Emitter*>(this->getParent());
+    spawnedStyles.push_back(emitter->playStyle(config));
+}
@@ -0,0 +1,54 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef PATTERN_STYLE_H
+#define PATTERN_STYLE_H
+
+#include "EmitterStyle.h"
+#include "GameplayScene/Emitters/Pattern.h"
+#include "GameplayScene/Emitters/PatternRunner.h"
+
+/* 字节码弹幕：以 PatternRunner 解释执行 PatternLibrary 中编译好的模式
+   特点：玩家，敌人，自机（aim 对角色为面朝方向） */
+
+class PatternStyle : public EmitterStyle, public PatternHost
+{
+public:
+    /* 敌人弹幕 */
+    static PatternStyle* create(const Pattern* pattern, Node** target);
+    PatternStyle(const Pattern* pattern, Node** target);
+
+    /* 角色弹幕 */
+    static PatternStyle* create(const Pattern* pattern, Direction* direction);
+    PatternStyle(const Pattern* pattern, Direction* direction);
+
+    /* 调度器 */
+    void startShoot();
+    void stopShoot();
+    void shootBullet(float dt);
+    void spawnBullet();
+
+    /* 由 style 指令启动的弹幕标签，停止本弹幕时一并停止 */
+    const std::vector<int>& getSpawnedStyles() const { return spawnedStyles; }
+
+    /* PatternRunner 的回调 */
+    virtual void spawnRing(const PatternInstruction& ring, float angle, float offset) override;
+    virtual float aimAngle() override;
+    virtual void setArchetype(unsigned int index) override;
+    virtual void playStyle(const StyleConfig& config) override;
+
+private:
+    const Pattern* pattern;
+    bool isPlayer;
+    Node** target;
+    Direction* direction; //玩家方向
+
+    PatternRunner runner;
+    const PatternInstruction* ring; //正在发射的环形弹指令
+    float ringAngle;                //发射时的角度
+    DirectionTable directions;      //转到当前角度后的方向表
+    std::vector<int> spawnedStyles;
+};
+
+#endif // PATTERN_STYLE_H
@@ -0,0 +1,82 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "VolleyStyle.h"
+
+VolleyStyle::VolleyStyle(const StyleConfig& sc, Node** target)
+{
+    this->sc = sc;
+    this->despawn = VolleyRunner::defaultDespawn(sc);
+    this->isPlayer = false;
+    this->target = target;
+    this->direction = nullptr;
+}
+
+VolleyStyle::VolleyStyle(const StyleConfig& sc, Direction* direction)
+{
+    this->sc = sc;
+    this->despawn = VolleyRunner::defaultDespawn(sc);
+    this->isPlayer = true;
+    this->target = nullptr;
+    this->direction = direction;
+}
+
+void
+VolleyStyle::startShoot()
+{
+    auto winSize = Director::getInstance()->getWinSize();
+    runner.start(sc, isPlayer, winSize.width, winSize.height, *this);
+    startTicking();
+}
+
+void
+VolleyStyle::stopShoot()
+{
+    stopTicking();
+}
+
+void
+VolleyStyle::shootBullet(float dt)
+{
+    runner.step(dt, *this, rng);
+    spawnOffset = 0;
+    if (runner.isStopped()) {
+        stopShoot();
+    }
+}
+
+void
+VolleyStyle::spawnBullet()
+{
+    runner.fire(*this, rng, spawnOffset);
+}
+
+void
+VolleyStyle::getOrigin(float& x, float& y)
+{
+    auto pos = context.character->getPosition();
+    x = pos.x;
+    y = pos.y;
+}
+
+void
+VolleyStyle::getTarget(float& x, float& y)
+{
+    auto pos = (*target)->getPosition();
+    x = pos.x;
+    y = pos.y;
+}
+
+bool
+VolleyStyle::isFacingLeft()
+{
+    return direction && (*direction) == Direction::LEFT;
+}
+
+void
+VolleyStyle::fireBullet(const Trajectory& trajectory, float life, float scale, float offset)
+{
+    spawnOffset = offset;
+    launchBullet(trajectory, life, scale);
+}
@@ -0,0 +1,53 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef VOLLEY_STYLE_H
+#define VOLLEY_STYLE_H
+
+#include "EmitterStyle.h"
+#include "GameplayScene/Emitters/VolleyRunner.h"
+
+/* 原有弹幕类型的公共部分：节拍与发射几何交给 VolleyRunner，与 bullet_bench、pattern_sim 共用
+ *
+ *  + 本类只提供发射者位置、目标与角色朝向，把 VolleyRunner 求出的子弹写入子弹层
+ *  + 敌人弹幕以 target 瞄准，角色弹幕以 direction 决定朝向；派生类只设定默认参数与纹理
+ *  + 激光由 Laser 重写 fireBeam 登记到子弹层
+ */
+
+class VolleyStyle
+    : public EmitterStyle
+    , public VolleyHost
+{
+public:
+    /* 敌人弹幕，不瞄准的弹幕 target 可以为空 */
+    VolleyStyle(const StyleConfig& sc, Node** target);
+
+    /* 角色弹幕 */
+    VolleyStyle(const StyleConfig& sc, Direction* direction);
+
+    /* 掉帧后每帧最多补发的轮数，startShoot 之前设定 */
+    void setMaxCatchUp(int maxCatchUp) { runner.setMaxCatchUp(maxCatchUp); }
+
+    /* 调度器 */
+    virtual void startShoot() override;
+    virtual void stopShoot() override;
+    virtual void shootBullet(float dt) override;
+    virtual void spawnBullet() override;
+
+    /* VolleyRunner 的回调 */
+    virtual void getOrigin(float& x, float& y) override;
+    virtual void getTarget(float& x, float& y) override;
+    virtual bool isFacingLeft() override;
+    virtual void fireBullet(const Trajectory& trajectory, float life, float scale,
+                            float offset) override;
+    virtual void fireBeam(const LaserBeam& beam) override {}
+
+protected:
+    bool isPlayer;
+    Node** target;        //瞄准的目标
+    Direction* direction; //玩家方向
+    VolleyRunner runner;
+};
+
+#endif // VOLLEY_STYLE_H
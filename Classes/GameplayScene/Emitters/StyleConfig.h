@@ -27,6 +27,8 @@ struct BulletConfig
     int _categoryBitmask;
     int _collisionBitmask;
     int _contactTestBitmask;
+    int homing; //追踪弹每秒最多转过的角度，0 为直飞
+    bool trail; //是否带拖尾（残影）
 };
 
 struct StyleConfig
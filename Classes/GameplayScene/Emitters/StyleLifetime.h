@@ -0,0 +1,139 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef STYLE_LIFETIME_H
+#define STYLE_LIFETIME_H
+
+#include "BulletField.h"
+#include "BulletSimulation.h"
+#include "SlotMap.h"
+
+/* 弹幕的生命周期：在场子弹表、存活计数与停止后的释放时机
+ *
+ *  + 不依赖 cocos2d，游戏内是 EmitterStyle 的基类，bullet_bench 的切换测试（--churn）也以它为基类
+ *  + 子弹写入子弹场时以 attachBullet 登记下标，子弹场记下返回的句柄；子弹在子弹场中移动时以
+ *    relocateBullet 更新下标，离场时以 releaseBullet 交还，三者都是 O(1)
+ *  + 激光同样登记在这里（attachBeam），消散后由 BulletSimulation 在 removeDead 时以
+ *    releaseBeam 交还
+ *  + 停止发射（retire）后仍有子弹或激光在场时不释放，最后一个离场时调用 releaseStyle，
+ *    由派生类决定如何释放（EmitterStyle 从发射器移除），此后不得再访问成员
+ *  + 先于在场子弹与激光销毁时把它们的发射方清空，子弹与激光继续飞行，结束后不再通知
+ *  + 每个实例在构造、析构时增减全局的存活数，切换攻击方式后存活数应回到原值
+ */
+
+class StyleLifetime
+{
+public:
+    StyleLifetime()
+        : field(nullptr)
+        , simulation(nullptr)
+        , retired(false)
+    {
+        liveCount()++;
+    }
+    virtual ~StyleLifetime()
+    {
+        //在场子弹继续飞行，到期后由子弹场直接移除
+        if (field) {
+            for (int index : bullets) {
+                field->owner[index] = nullptr;
+            }
+        }
+        if (simulation) {
+            for (auto beam : beams) {
+                simulation->disownBeam(beam);
+            }
+        }
+        liveCount()--;
+    }
+
+    StyleLifetime(const StyleLifetime&) = delete;
+    StyleLifetime& operator=(const StyleLifetime&) = delete;
+
+    /* 子弹写入子弹场 field 的下标 index，返回记在子弹场中的句柄 */
+    SlotHandle attachBullet(BulletField* field, int index)
+    {
+        this->field = field;
+        return bullets.insert(index);
+    }
+
+    /* 子弹在子弹场中移到下标 index */
+    void relocateBullet(SlotHandle slot, int index)
+    {
+        int* tracked = bullets.get(slot);
+        if (tracked) {
+            *tracked = index;
+        }
+    }
+
+    /* 子弹离场（到期、出界、命中或转为拾取物）；已停止发射且这是最后一个在场的子弹或激光时
+     * 调用 releaseStyle，此后不得再访问成员 */
+    void releaseBullet(SlotHandle slot)
+    {
+        bullets.erase(slot);
+        releaseIfIdle();
+    }
+
+    /* 子弹场先于弹幕清空，只删除登记，不释放弹幕 */
+    void detachBullet(SlotHandle slot) { bullets.erase(slot); }
+
+    /* 激光登记到 simulation 中的句柄 beam，返回记在模拟中的句柄 */
+    SlotHandle attachBeam(BulletSimulation* simulation, SlotHandle beam)
+    {
+        this->simulation = simulation;
+        return beams.insert(beam);
+    }
+
+    /* 激光消散；与 releaseBullet 相同，最后一个离场时调用 releaseStyle */
+    void releaseBeam(SlotHandle slot)
+    {
+        beams.erase(slot);
+        releaseIfIdle();
+    }
+
+    /* 模拟先于弹幕销毁，只删除登记，不释放弹幕 */
+    void detachBeam(SlotHandle slot) { beams.erase(slot); }
+
+    /* 停止发射；没有在场的子弹与激光时立即调用 releaseStyle，否则在最后一个离场时调用 */
+    virtual void retire()
+    {
+        retired = true;
+        releaseIfIdle();
+    }
+
+    bool isRetired() const { return retired; }
+
+    /* 在场的子弹与激光数 */
+    int inFlight() const { return bullets.size() + beams.size(); }
+    const SlotMap<int>& getBullets() const { return bullets; }
+
+    /* 当前存活的弹幕数，包括已停止但仍有子弹在场的弹幕 */
+    static int getLiveCount() { return liveCount(); }
+
+protected:
+    /* 已停止发射、最后一个子弹或激光离场时调用，派生类在这里释放自己 */
+    virtual void releaseStyle() = 0;
+
+private:
+    void releaseIfIdle()
+    {
+        if (retired && inFlight() == 0) {
+            releaseStyle();
+        }
+    }
+
+    static int& liveCount()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    SlotMap<int> bullets;         //在场子弹在子弹场中的下标
+    BulletField* field;           //子弹所在的子弹场，销毁时清空其中的发射方
+    SlotMap<SlotHandle> beams;    //在场激光在模拟中的句柄
+    BulletSimulation* simulation; //激光所在的模拟，销毁时清空其中的发射方
+    bool retired;
+};
+
+#endif // STYLE_LIFETIME_H
@@ -0,0 +1,296 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "TargetIndex.h"
+#include "BulletKernels.h"
+
+#include <cmath>
+
+// 种别不是单独一位的目标归为一类，不做剪枝
+#define TARGET_INDEX_MIXED 32
+// 剪枝时放宽的比例，避免浮点误差剪掉距离几乎相等的目标
+#define TARGET_INDEX_SLACK 1.001f
+// 估计开销，以比较一对查找与目标为 1：为一个格子挑选时每个目标、每次查找（分组与比较候选）
+#define TARGET_INDEX_CELL_COST 10
+#define TARGET_INDEX_FIND_COST 40
+
+TargetIndex::TargetIndex()
+{
+    setBounds(0, 0, 1, 1, 128);
+}
+
+void
+TargetIndex::setBounds(float x, float y, float width, float height, float cellSize)
+{
+    this->originX = x;
+    this->originY = y;
+    this->cellSize = cellSize > 1 ? cellSize : 1;
+    this->invCellSize = 1.0f / this->cellSize;
+    this->columns = (int)ceilf(width * invCellSize);
+    this->rows = (int)ceilf(height * invCellSize);
+    if (columns < 1) {
+        columns = 1;
+    }
+    if (rows < 1) {
+        rows = 1;
+    }
+    cellSlot.assign(columns * rows, -1);
+    clear();
+}
+
+void
+TargetIndex::clear()
+{
+    for (int cell : marked) {
+        cellSlot[cell] = -1;
+    }
+    marked.clear();
+    useTable = false;
+    candidates.clear();
+    candidateX.clear();
+    candidateY.clear();
+    candidateCategory.clear();
+    xs.clear();
+    ys.clear();
+    categories.clear();
+    kinds.clear();
+    queryX.clear();
+    queryY.clear();
+    queryMask.clear();
+    nearest.clear();
+}
+
+void
+TargetIndex::add(float x, float y, uint32_t category)
+{
+    uint8_t kind = TARGET_INDEX_MIXED;
+    if (category != 0 && (category & (category - 1)) == 0) {
+        kind = 0;
+        while ((category >> kind) != 1) {
+            kind++;
+        }
+    }
+
+    xs.push_back(x);
+    ys.push_back(y);
+    categories.push_back(category);
+    kinds.push_back(kind);
+}
+
+int
+TargetIndex::cellOf(float x, float y) const
+{
+    //范围内的值非负，截断即向下取整；floorf 在没有 SSE4.1 的目标上是一次函数调用
+    float fx = (x - originX) * invCellSize;
+    float fy = (y - originY) * invCellSize;
+    if (!(fx >= 0 && fy >= 0 && fx < columns && fy < rows)) {
+        return -1;
+    }
+    return (int)fy * columns + (int)fx;
+}
+
+int
+TargetIndex::mark(float x, float y, uint32_t mask)
+{
+    queryX.push_back(x);
+    queryY.push_back(y);
+    queryMask.push_back(mask);
+    return (int)queryX.size() - 1;
+}
+
+/* 各段 [lo, lo + size) 到 values 中各点的最近与最远距离的平方，段 * 点数 */
+static void
+spanDistances(const std::vector<float>& values, float origin, float size, int spans,
+              std::vector<float>& nearest, std::vector<float>& farthest)
+{
+    int count = (int)values.size();
+    nearest.resize(spans * count);
+    farthest.resize(spans * count);
+    for (int s = 0; s < spans; s++) {
+        float lo = origin + s * size;
+        float hi = lo + size;
+        float* near = &nearest[s * count];
+        float* far = &farthest[s * count];
+        for (int i = 0; i < count; i++) {
+            float v = values[i];
+            float n = v < lo ? lo - v : (v > hi ? v - hi : 0);
+            float f = v - lo > hi - v ? v - lo : hi - v;
+            near[i] = n * n;
+            far[i] = f * f;
+        }
+    }
+}
+
+void
+TargetIndex::build()
+{
+    int count = size();
+    int queries = getQueryCount();
+    nearest.resize(queries);
+    useTable = false;
+    if (count == 0 || queries == 0) {
+        nearest.assign(queries, -1);
+        return;
+    }
+
+    //建表时每次查找的开销已不低于与全部目标比较，目标不多时不必再分格子
+    if (count > TARGET_INDEX_FIND_COST) {
+        queryCell.resize(queries);
+        for (int q = 0; q < queries; q++) {
+            int cell = cellOf(queryX[q], queryY[q]);
+            if (cell >= 0 && cellSlot[cell] < 0) {
+                cellSlot[cell] = (int)marked.size();
+                marked.push_back(cell);
+            }
+            queryCell[q] = cell;
+        }
+    }
+
+    //建表的开销与格子数成正比，全部比较的开销与查找数、目标数之积成正比
+    int slots = (int)marked.size();
+    long long tableCost = (long long)slots * count * TARGET_INDEX_CELL_COST +
+                          (long long)queries * TARGET_INDEX_FIND_COST;
+    useTable = slots > 0 && tableCost < (long long)queries * count;
+    if (!useTable) {
+        groupBest.resize(queries);
+        getBulletKernels().nearestTargets(queryX.data(), queryY.data(), queryMask.data(), queries,
+                                          xs.data(), ys.data(), categories.data(), nullptr,
+                                          count, groupBest.data(), nearest.data());
+        return;
+    }
+
+    //格子到目标的距离按行、列分开算好，每个格子只需相加
+    spanDistances(xs, originX, cellSize, columns, columnNear, columnFar);
+    spanDistances(ys, originY, cellSize, rows, rowNear, rowFar);
+    slotStart.resize(slots);
+    slotEnd.resize(slots);
+    for (int slot = 0; slot < slots; slot++) {
+        buildCell(slot);
+    }
+
+    //查找按格子计数排序，范围外的归入最后一组（序号 slots）
+    slotQueries.assign(slots + 3, 0);
+    for (int q = 0; q < queries; q++) {
+        int cell = queryCell[q];
+        slotQueries[(cell < 0 ? slots : cellSlot[cell]) + 2]++;
+    }
+    for (int s = 2; s < slots + 3; s++) {
+        slotQueries[s] += slotQueries[s - 1];
+    }
+    order.resize(queries);
+    for (int q = 0; q < queries; q++) {
+        int cell = queryCell[q];
+        order[slotQueries[(cell < 0 ? slots : cellSlot[cell]) + 1]++] = q;
+    }
+
+    for (int slot = 0; slot <= slots; slot++) {
+        resolveSlot(slot);
+    }
+}
+
+void
+TargetIndex::buildCell(int slot)
+{
+    int cell = marked[slot];
+    int count = size();
+    const float* nearX = &columnNear[(cell % columns) * count];
+    const float* farX = &columnFar[(cell % columns) * count];
+    const float* nearY = &rowNear[(cell / columns) * count];
+    const float* farY = &rowFar[(cell / columns) * count];
+
+    //各种别目标到格子最远距离的最小值
+    float reach[TARGET_INDEX_MIXED + 1];
+    for (int k = 0; k <= TARGET_INDEX_MIXED; k++) {
+        reach[k] = INFINITY;
+    }
+    for (int i = 0; i < count; i++) {
+        float far = farX[i] + farY[i];
+        reach[kinds[i]] = far < reach[kinds[i]] ? far : reach[kinds[i]];
+    }
+    for (int k = 0; k <= TARGET_INDEX_MIXED; k++) {
+        reach[k] *= TARGET_INDEX_SLACK;
+    }
+    reach[TARGET_INDEX_MIXED] = INFINITY;
+
+    //混合种别的目标无法与同种别比较，总是保留；候选的坐标与种别连续存放，比较时不再间接访问
+    int first = (int)candidates.size();
+    candidates.resize(first + count);
+    int end = first;
+    for (int i = 0; i < count; i++) {
+        candidates[end] = i;
+        end += nearX[i] + nearY[i] <= reach[kinds[i]] ? 1 : 0;
+    }
+    candidates.resize(end);
+    candidateX.resize(end);
+    candidateY.resize(end);
+    candidateCategory.resize(end);
+    for (int k = first; k < end; k++) {
+        candidateX[k] = xs[candidates[k]];
+        candidateY[k] = ys[candidates[k]];
+        candidateCategory[k] = categories[candidates[k]];
+    }
+    slotStart[slot] = first;
+    slotEnd[slot] = end;
+}
+
+void
+TargetIndex::resolveSlot(int slot)
+{
+    int begin = slotQueries[slot];
+    int end = slotQueries[slot + 1];
+    int queries = end - begin;
+    if (queries == 0) {
+        return;
+    }
+
+    //同一格的查找取到连续的数组中，与该格的候选（范围外时为全部目标）整批比较
+    groupX.resize(queries);
+    groupY.resize(queries);
+    groupMask.resize(queries);
+    groupBest.resize(queries);
+    groupNearest.resize(queries);
+    for (int k = 0; k < queries; k++) {
+        int q = order[begin + k];
+        groupX[k] = queryX[q];
+        groupY[k] = queryY[q];
+        groupMask[k] = queryMask[q];
+    }
+
+    const BulletKernels& kernels = getBulletKernels();
+    if (slot < (int)marked.size()) {
+        int first = slotStart[slot];
+        kernels.nearestTargets(groupX.data(), groupY.data(), groupMask.data(), queries,
+                               candidateX.data() + first, candidateY.data() + first,
+                               candidateCategory.data() + first, candidates.data() + first,
+                               slotEnd[slot] - first, groupBest.data(), groupNearest.data());
+    } else {
+        kernels.nearestTargets(groupX.data(), groupY.data(), groupMask.data(), queries, xs.data(),
+                               ys.data(), categories.data(), nullptr, size(), groupBest.data(),
+                               groupNearest.data());
+    }
+
+    for (int k = 0; k < queries; k++) {
+        nearest[order[begin + k]] = groupNearest[k];
+    }
+}
+
+int
+TargetIndex::findNearest(float x, float y, uint32_t mask) const
+{
+    float best;
+    int32_t result = -1;
+    const BulletKernels& kernels = getBulletKernels();
+    int cell = useTable ? cellOf(x, y) : -1;
+    int slot = cell >= 0 ? cellSlot[cell] : -1;
+    if (slot < 0) {
+        kernels.nearestTargets(&x, &y, &mask, 1, xs.data(), ys.data(), categories.data(), nullptr,
+                               size(), &best, &result);
+    } else {
+        int first = slotStart[slot];
+        kernels.nearestTargets(&x, &y, &mask, 1, candidateX.data() + first,
+                               candidateY.data() + first, candidateCategory.data() + first,
+                               candidates.data() + first, slotEnd[slot] - first, &best, &result);
+    }
+    return result;
+}
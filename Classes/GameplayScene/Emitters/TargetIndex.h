@@ -0,0 +1,101 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef TARGET_INDEX_H
+#define TARGET_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+/* 目标索引：追踪弹整批查找最近的目标
+ *
+ *  + 每帧加入所有角色，再由 mark 登记各追踪弹的查找，build 整批求出结果，之后以 getNearest 读取
+ *  + 比较由 BulletKernels::nearestTargets 完成：查找放在 SIMD 各通道中，每次广播一个目标，
+ *    不分支地保留最近者，不像逐颗查找那样每次比较都要等上一次的结果
+ *  + 目标多时 build 只为有查找的格子各挑一次候选：到格子的最近距离超过某个同种别目标到格子的
+ *    最远距离的目标，不可能是格内任何一点的最近目标；同一格的查找只与该格的候选比较
+ *  + 挑选候选的开销与格子数、目标数之积成正比，build 按估计开销决定是否挑选，
+ *    不挑选时所有查找直接与全部目标整批比较
+ *  + 候选按加入顺序排列，距离相同时取先加入的目标，两种方式的结果与逐个遍历全部目标相同
+ *  + 覆盖范围外的查找与全部目标比较
+ *  + findNearest 单独查找任意一点，build 之后只读，可在 JobSystem 的各块中同时调用
+ *  + 不依赖 cocos2d
+ */
+
+class TargetIndex
+{
+public:
+    TargetIndex();
+
+    /* 设置覆盖范围与格子边长 */
+    void setBounds(float x, float y, float width, float height, float cellSize);
+
+    /* 清空目标、查找与上一帧的候选，之后逐个加入目标、登记查找，最后调用 build */
+    void clear();
+    void add(float x, float y, uint32_t category);
+    /* 登记一次查找，返回其编号（从 0 起依次递增），build 之后以 getNearest 取结果 */
+    int mark(float x, float y, uint32_t mask);
+    void build();
+
+    /* mark 登记的查找的结果：种别属于 mask、离该点最近的目标下标，没有时为 -1 */
+    int getNearest(int query) const { return nearest[query]; }
+    int getQueryCount() const { return (int)queryX.size(); }
+
+    /* 返回种别属于 mask、离 (x, y) 最近的目标下标，没有时返回 -1 */
+    int findNearest(float x, float y, uint32_t mask) const;
+
+    int size() const { return (int)xs.size(); }
+    float getX(int i) const { return xs[i]; }
+    float getY(int i) const { return ys[i]; }
+
+private:
+    int cellOf(float x, float y) const;
+    void buildCell(int slot);
+    void resolveSlot(int slot);
+
+private:
+    float originX;
+    float originY;
+    float cellSize;
+    float invCellSize;
+    int columns;
+    int rows;
+
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<uint32_t> categories;
+    std::vector<uint8_t> kinds; //单一种别为其位序号，其余为 TARGET_INDEX_MIXED
+
+    std::vector<float> queryX; //本帧登记的查找，按编号
+    std::vector<float> queryY;
+    std::vector<uint32_t> queryMask;
+    std::vector<int> queryCell; //所在格子，范围外为 -1，build 需要分格子时才算
+    std::vector<int32_t> nearest; //各查找的结果
+
+    std::vector<int> cellSlot;  //每个格子在 marked 中的序号，-1 为本帧没有查找
+    std::vector<int> marked;    //本帧有查找的格子，clear 时只重置这些格子
+    std::vector<int> slotStart; //各格子的候选在 candidates 中的范围，按 marked 的序号
+    std::vector<int> slotEnd;
+    std::vector<int> slotQueries; //各格子的查找在 order 中的起点，末尾多一项
+    std::vector<int> order;       //按格子排列的查找编号，范围外的排在最后
+    bool useTable;                //本帧是否建了候选表
+
+    std::vector<int32_t> candidates; //候选的目标下标，与下面三列一一对应
+    std::vector<float> candidateX;
+    std::vector<float> candidateY;
+    std::vector<uint32_t> candidateCategory;
+
+    std::vector<float> groupX; //正在比较的一组查找，连续存放
+    std::vector<float> groupY;
+    std::vector<uint32_t> groupMask;
+    std::vector<float> groupBest;
+    std::vector<int32_t> groupNearest;
+
+    std::vector<float> columnNear; //各列到各目标 x 方向的最近、最远距离的平方，列 * 目标数
+    std::vector<float> columnFar;
+    std::vector<float> rowNear;
+    std::vector<float> rowFar;
+};
+
+#endif // TARGET_INDEX_H
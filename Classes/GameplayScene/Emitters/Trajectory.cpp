@@ -0,0 +1,125 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "Trajectory.h"
+
+#include <cmath>
+
+float
+easeValue(EasingType easing, float rate, float t)
+{
+    switch (easing) {
+        case EasingType::IN:
+            return powf(t, rate);
+        case EasingType::OUT:
+            return powf(t, 1.0f / rate);
+        case EasingType::IN_OUT:
+            t *= 2;
+            if (t < 1) {
+                return 0.5f * powf(t, rate);
+            }
+            return 1.0f - 0.5f * powf(2 - t, rate);
+        default:
+            return t;
+    }
+}
+
+void
+TrajectoryCurve::evaluate(TrajectoryType type, float age, float& dx, float& dy) const
+{
+    float t = duration > 0 ? age / duration : 1.0f;
+    if (t > 1.0f) {
+        t = 1.0f;
+    }
+    t = easeValue(easing, rate, t);
+
+    if (type == TrajectoryType::EASED) {
+        dx = endX * t;
+        dy = endY * t;
+        return;
+    }
+
+    //与 cocos2d 的 bezierat 相同的展开式，起点为 0
+    float u = 1.0f - t;
+    float b1 = 3.0f * t * u * u;
+    float b2 = 3.0f * t * t * u;
+    float b3 = t * t * t;
+    dx = b1 * c1x + b2 * c2x + b3 * endX;
+    dy = b1 * c1y + b2 * c2y + b3 * endY;
+}
+
+Trajectory
+Trajectory::linear(float x, float y, float vx, float vy)
+{
+    Trajectory t = {};
+    t.type = TrajectoryType::LINEAR;
+    t.originX = x;
+    t.originY = y;
+    t.velX = vx;
+    t.velY = vy;
+    return t;
+}
+
+Trajectory
+Trajectory::integrated(float x, float y, float vx, float vy)
+{
+    Trajectory t = linear(x, y, vx, vy);
+    t.type = TrajectoryType::INTEGRATED;
+    return t;
+}
+
+Trajectory
+Trajectory::eased(float x, float y, float dx, float dy, float duration, EasingType easing,
+                  float rate)
+{
+    Trajectory t = {};
+    t.type = TrajectoryType::EASED;
+    t.originX = x;
+    t.originY = y;
+    t.curve.easing = easing;
+    t.curve.rate = rate;
+    t.curve.duration = duration;
+    t.curve.endX = dx;
+    t.curve.endY = dy;
+    return t;
+}
+
+Trajectory
+Trajectory::bezier(float x, float y, float c1x, float c1y, float c2x, float c2y, float endX,
+                   float endY, float duration)
+{
+    Trajectory t = {};
+    t.type = TrajectoryType::BEZIER;
+    t.originX = x;
+    t.originY = y;
+    t.curve.easing = EasingType::NONE;
+    t.curve.rate = 1.0f;
+    t.curve.duration = duration;
+    t.curve.c1x = c1x - x;
+    t.curve.c1y = c1y - y;
+    t.curve.c2x = c2x - x;
+    t.curve.c2y = c2y - y;
+    t.curve.endX = endX - x;
+    t.curve.endY = endY - y;
+    return t;
+}
+
+void
+Trajectory::evaluate(float age, float& x, float& y) const
+{
+    switch (type) {
+        case TrajectoryType::EASED:
+        case TrajectoryType::BEZIER: {
+            float dx, dy;
+            curve.evaluate(type, age, dx, dy);
+            x = originX + dx;
+            y = originY + dy;
+            break;
+        }
+        default:
+            x = originX + velX * age;
+            y = originY + velY * age;
+            break;
+    }
+}
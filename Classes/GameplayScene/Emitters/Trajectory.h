@@ -0,0 +1,80 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <cstdint>
+
+/* 子弹轨迹：由发射时刻的参数描述整条轨迹，按存活时间解析求值，不再为每颗子弹创建动作
+ *
+ *  + LINEAR     匀速直线，原先 EaseInOut(MoveBy, 1.0) 的等价形式
+ *  + EASED      带缓动的位移，对应 EaseIn / EaseOut / EaseInOut 包装的 MoveBy
+ *  + BEZIER     三阶贝塞尔曲线，与 BezierTo 的取值一致
+ *  + INTEGRATED 逐段匀速，供转向等无法解析求值的运动使用，改变速度时须经
+ *               BulletField::setVelocity 以当前位置重设起点
+ */
+
+enum class TrajectoryType : uint8_t
+{
+    LINEAR,
+    EASED,
+    BEZIER,
+    INTEGRATED,
+};
+
+enum class EasingType : uint8_t
+{
+    NONE,
+    IN,
+    OUT,
+    IN_OUT,
+};
+
+/* 曲线部分参数，所有点均相对于起点，缓动作用于曲线参数 t */
+struct TrajectoryCurve
+{
+    EasingType easing;
+    float rate;     //缓动速率
+    float duration; //曲线时长，超过后停在终点
+    float c1x, c1y; //贝塞尔控制点1
+    float c2x, c2y; //贝塞尔控制点2
+    float endX, endY;
+
+    /* 求 age 时刻相对起点的偏移，type 为 EASED 或 BEZIER */
+    void evaluate(TrajectoryType type, float age, float& dx, float& dy) const;
+};
+
+struct Trajectory
+{
+    TrajectoryType type;
+    float originX, originY;
+    float velX, velY; // LINEAR、INTEGRATED 使用
+    float rotation;   //初始角度，角度制
+    float spin;       //每秒旋转角度
+    TrajectoryCurve curve;
+
+    /* 匀速直线 */
+    static Trajectory linear(float x, float y, float vx, float vy);
+
+    /* 初速度为 (vx, vy) 的逐段匀速运动，之后由 BulletField::setVelocity 改变速度 */
+    static Trajectory integrated(float x, float y, float vx, float vy);
+
+    /* duration 秒内带缓动地位移 (dx, dy) */
+    static Trajectory eased(float x, float y, float dx, float dy, float duration, EasingType easing,
+                            float rate);
+
+    /* 从 (x, y) 出发、duration 秒到达终点的三阶贝塞尔曲线，参数为绝对坐标 */
+    static Trajectory bezier(float x, float y, float c1x, float c1y, float c2x, float c2y,
+                             float endX, float endY, float duration);
+
+    /* 求 age 时刻的位置与角度 */
+    void evaluate(float age, float& x, float& y) const;
+    float rotationAt(float age) const { return rotation + spin * age; }
+};
+
+/* 与 cocos2d 的 EaseIn / EaseOut / EaseInOut 同一公式，t 取 [0, 1] */
+float easeValue(EasingType easing, float rate, float t);
+
+#endif // TRAJECTORY_H
@@ -0,0 +1,408 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "VolleyRunner.h"
+
+#include <cfloat>
+#include <cmath>
+
+// 默认每次 step 最多补发的轮数
+#define STYLE_MAX_CATCH_UP 4
+// 奇偶数自机狙相邻子弹的夹角
+#define ODDEVEN_ANGLE 10.0f
+// PARABOLA 每颗子弹的随机参数个数：终点 x、y，高度，角度，缩放，自转
+#define PARABOLA_RANDOMS_PER_BULLET 6
+// 激光的预警、消散时长
+#define LASER_WARMUP 0.6f
+#define LASER_FADE 0.2f
+// 与 CC_DEGREES_TO_RADIANS、CC_RADIANS_TO_DEGREES 相同的换算
+#define VOLLEY_RADIANS(__DEGREES__) ((__DEGREES__)*0.01745329252f)
+#define VOLLEY_DEGREES(__RADIANS__) ((__RADIANS__)*57.29577951f)
+
+StyleConfig
+VolleyRunner::defaultConfig(StyleType style, bool player)
+{
+    StyleConfig sc = StyleConfig();
+    sc.style = style;
+    sc.totalDuration = FLT_MAX;
+    sc.cycleTimes = -1;
+    sc.bc.length = 20;
+    sc.bc.width = 10;
+    sc.bc.harm = 10;
+
+    switch (style) {
+        case StyleType::LASER:
+            sc.frequency = player ? 1.5f : 3.0f;
+            sc.bulletDuration = player ? 0.5f : 1.0f;
+            sc.number = 1;
+            sc.bc.name = "b5_1.png";
+            sc.bc.length = 0;
+            sc.bc.width = 16;
+            sc.bc.harm = 20;
+            break;
+        case StyleType::ODDEVEN:
+            sc.frequency = 0.5f;
+            sc.bulletDuration = 3.0f;
+            sc.countThenChangePos = 3;
+            sc.number = 5;
+            sc.bc.name = "b2_2_1.png";
+            sc.bc.length = 10;
+            sc.bc.width = 20;
+            break;
+        case StyleType::PARABOLA:
+            sc.frequency = 0.2f;
+            sc.bulletDuration = 1.5f;
+            sc.number = 5;
+            sc.countThenChangePos = 3;
+            sc.height = 100;
+            sc.distance = 500;
+            sc.startAngle = 15;
+            sc.endAngle = 70;
+            sc.bc.name = "b3_1_3.png";
+            sc.bc.harm = 15;
+            break;
+        case StyleType::PARALLEL:
+            if (player) {
+                sc.frequency = 1.0f;
+                sc.bulletDuration = 3.0f;
+                sc.countThenChangePos = 0;
+                sc.number = 2;
+                sc.interval = 2;
+                sc.bc.name = "b1_3_3.png";
+            } else {
+                sc.frequency = 0.5f;
+                sc.bulletDuration = 6.0f;
+                sc.countThenChangePos = 1;
+                sc.number = 4;
+                sc.interval = 1.5f;
+                sc.bc.name = "b2_2_1.png";
+            }
+            break;
+        case StyleType::SCATTER:
+            sc.bc.name = "b1_3_3.png";
+            if (player) {
+                sc.frequency = 0.2f;
+                sc.bulletDuration = 3.0f;
+                sc.number = 2;
+                sc.startAngle = 269;
+                sc.endAngle = 271;
+                sc.deltaAngle = 5;
+            } else {
+                sc.frequency = 0.5f;
+                sc.bulletDuration = 6.0f;
+                sc.number = 13;
+                sc.startAngle = 90;
+                sc.endAngle = 180;
+                sc.deltaAngle = 5;
+            }
+            break;
+    }
+    return sc;
+}
+
+DespawnPolicy
+VolleyRunner::defaultDespawn(const StyleConfig& sc)
+{
+    if (sc.style == StyleType::PARABOLA) {
+        return DespawnPolicy::age(sc.bulletDuration);
+    }
+    return DespawnPolicy::area(STYLE_DESPAWN_MARGIN);
+}
+
+VolleyRunner::VolleyRunner()
+    : sc(StyleConfig())
+    , player(false)
+    , areaHeight(0)
+    , distance(0)
+    , targetX(0)
+    , targetY(0)
+    , counterInside(0)
+    , timeAccumulation(0)
+    , elapsed(0)
+    , offset(0)
+    , volleys(0)
+    , maxCatchUp(STYLE_MAX_CATCH_UP)
+    , stopped(true)
+    , fanAngle(0)
+    , fanStep(0)
+{
+}
+
+void
+VolleyRunner::start(const StyleConfig& sc, bool player, float areaWidth, float areaHeight,
+                    VolleyHost& host)
+{
+    this->sc = sc;
+    this->player = player;
+    this->areaHeight = areaHeight;
+    distance = sqrtf(areaWidth * areaWidth + areaHeight * areaHeight);
+    counterInside = 0;
+    timeAccumulation = 0;
+    elapsed = 0;
+    volleys = 0;
+    stopped = false;
+
+    if (!player && (sc.style == StyleType::ODDEVEN || sc.style == StyleType::PARALLEL)) {
+        host.getTarget(targetX, targetY);
+    }
+
+    if (sc.style == StyleType::ODDEVEN) {
+        //扇形相对基准方向的偏移只与条数、夹角有关，每轮只需整体转到基准方向
+        fan.build(sc.number, VOLLEY_RADIANS(-((int)sc.number - 1) * (ODDEVEN_ANGLE / 2)),
+                  VOLLEY_RADIANS(ODDEVEN_ANGLE));
+    } else if (sc.style == StyleType::SCATTER) {
+        //方向表按当前起始角建立，之后的旋转都从这张表出发
+        fanStep = VOLLEY_RADIANS(sc.endAngle - sc.startAngle) / (sc.number - 1);
+        fanAngle = sc.startAngle;
+        fan.build(sc.number, VOLLEY_RADIANS(sc.startAngle + 90), fanStep);
+        fan.rotate(0, directions);
+    }
+}
+
+int
+VolleyRunner::dueVolleys(float dt)
+{
+    timeAccumulation += dt;
+    if (sc.frequency <= 0) { //没有间隔时每次一轮
+        timeAccumulation = sc.frequency;
+        return 1;
+    }
+    int due = (int)(timeAccumulation / sc.frequency);
+    if (due > maxCatchUp) {
+        timeAccumulation -= (due - maxCatchUp) * sc.frequency;
+        due = maxCatchUp;
+    }
+    return due;
+}
+
+void
+VolleyRunner::step(float dt, VolleyHost& host, FastRandom& rng)
+{
+    if (stopped) {
+        return;
+    }
+
+    elapsed += dt;
+    int due = dueVolleys(dt);
+    for (int i = 0; i < due; i++) {
+        timeAccumulation -= sc.frequency;
+        fire(host, rng, timeAccumulation);
+        volleys++;
+        if (volleys >= sc.cycleTimes) {
+            stopped = true;
+            break;
+        }
+    }
+    if (elapsed >= sc.totalDuration) {
+        stopped = true;
+    }
+}
+
+void
+VolleyRunner::fire(VolleyHost& host, FastRandom& rng, float offset)
+{
+    this->offset = offset;
+    switch (sc.style) {
+        case StyleType::LASER:
+            fireLaser(host);
+            break;
+        case StyleType::ODDEVEN:
+            fireOddEven(host);
+            break;
+        case StyleType::PARABOLA:
+            fireParabola(host, rng);
+            break;
+        case StyleType::PARALLEL:
+            fireParallel(host);
+            break;
+        case StyleType::SCATTER:
+            fireScatter(host);
+            break;
+    }
+}
+
+void
+VolleyRunner::fireOddEven(VolleyHost& host)
+{
+    if (counterInside == sc.countThenChangePos) {
+        counterInside = 0;
+        host.getTarget(targetX, targetY); //更新目标位置
+    }
+
+    float x, y;
+    host.getOrigin(x, y);
+    float datum = VOLLEY_DEGREES(atan2f(targetX - x, targetY - y));   //基础偏转角
+    float startAngle = datum + (sc.number - 1) * (ODDEVEN_ANGLE / 2); //起始偏转角
+    fan.rotate(VOLLEY_RADIANS(90.0f - datum), directions);
+
+    for (int i = 0; i < (int)sc.number; i++) {
+        float actualAngle = startAngle - i * ODDEVEN_ANGLE; //实际偏转角
+        auto trajectory =
+            Trajectory::linear(x, y, distance * directions.getX(i) / sc.bulletDuration,
+                               distance * directions.getY(i) / sc.bulletDuration);
+        trajectory.rotation = actualAngle;
+        host.fireBullet(trajectory, sc.bulletDuration, 1.0f, offset);
+    }
+    counterInside++;
+}
+
+void
+VolleyRunner::fireScatter(VolleyHost& host)
+{
+    sc.startAngle += sc.deltaAngle;
+    sc.endAngle += sc.deltaAngle;
+    if (sc.deltaAngle != 0) {
+        fan.rotate(VOLLEY_RADIANS(sc.startAngle - fanAngle), directions);
+    }
+
+    //强烈建议角色使用中心对称型子弹，面朝左时速度取反，朝向不变
+    float x, y;
+    host.getOrigin(x, y);
+    float mirror = player && host.isFacingLeft() ? -1.0f : 1.0f;
+    for (int i = 0; i < (int)sc.number; i++) {
+        float vx = mirror * distance * directions.getX(i) / sc.bulletDuration;
+        float vy = mirror * distance * directions.getY(i) / sc.bulletDuration;
+        auto trajectory = Trajectory::linear(x, y, vx, vy);
+        trajectory.rotation = -sc.startAngle - i * fanStep;
+        host.fireBullet(trajectory, sc.bulletDuration, 1.0f, offset);
+    }
+}
+
+void
+VolleyRunner::fireParallel(VolleyHost& host)
+{
+    if (sc.countThenChangePos != 0) {
+        if (counterInside == sc.countThenChangePos) {
+            counterInside = 0;
+            if (!player) {
+                host.getTarget(targetX, targetY); //更新目标位置
+            }
+        } else {
+            counterInside++;
+        }
+    }
+
+    float x, y; //基准位置
+    host.getOrigin(x, y);
+    float intervalDis = areaHeight / 36.0f; //子弹间距
+    float startX, startY;
+    float deltaX, deltaY; //位移
+    float angle = 0;      //自机夹角
+    float intervalX = 0;
+    float intervalY = intervalDis;
+
+    if (!player) {
+        float disX = targetX - x; //基准向量
+        float disY = targetY - y;
+        angle = VOLLEY_DEGREES(atan2f(disX, disY)); //基础偏转角
+
+        //基准向量的单位向量即 (sin(angle), cos(angle))，间距与位移都由它得出，不再求三角函数
+        float length = sqrtf(disX * disX + disY * disY);
+        float unitX = length > 0 ? disX / length : 0;
+        float unitY = length > 0 ? disY / length : 1;
+        intervalX = -intervalDis * unitY; // cos(angle - 180)
+        intervalY = -intervalDis * unitX; // sin(angle - 180)
+
+        startX = x - (sc.number - 1) * (intervalX / 2);
+        startY = y + (sc.number - 1) * (intervalX / 2);
+        deltaX = unitX * distance;
+        deltaY = unitY * distance;
+    } else {
+        startX = x;
+        startY = y + (sc.number - 1) * (intervalDis / 2.0f);
+        deltaX = distance;
+        deltaY = 0;
+    }
+
+    //建议角色使用中心对称型子弹，面朝左时速度取反
+    float mirror = player && host.isFacingLeft() ? -1.0f : 1.0f;
+    float vx = mirror * deltaX / sc.bulletDuration;
+    float vy = mirror * deltaY / sc.bulletDuration;
+    for (int i = 0; i < (int)sc.number; i++) {
+        auto trajectory =
+            Trajectory::linear(startX + i * intervalX, startY - i * intervalY, vx, vy);
+        trajectory.rotation = angle;
+        host.fireBullet(trajectory, sc.bulletDuration, 1.0f, offset);
+    }
+}
+
+void
+VolleyRunner::fireParabola(VolleyHost& host, FastRandom& rng)
+{
+    //与原先的 for (i = 0; i < 2 * number * CCRANDOM_0_1(); i++) 相同，每次判断重新取随机数：
+    //number 为 5 时平均每轮约 3.6 颗，只取一次则变为约 5.5 颗
+    int count = 0;
+    while (count < 2 * sc.number * rng.nextFloat()) {
+        count++;
+    }
+
+    //每颗子弹 6 个随机参数，整轮一次生成
+    uniforms.resize(count * PARABOLA_RANDOMS_PER_BULLET);
+    rng.fill(uniforms.data(), (int)uniforms.size());
+
+    float x, y;
+    host.getOrigin(x, y);
+    float side = host.isFacingLeft() ? -1.0f : 1.0f;
+    for (int i = 0; i < count; i++) {
+        const float* u = &uniforms[i * PARABOLA_RANDOMS_PER_BULLET];
+
+        //构造贝塞尔结构参数
+        float endX = x + side * (sc.distance + 100.0f * u[0]);
+        float endY = y + 50.0f - 100.0f * u[1];
+
+        float height = sc.height + 50.0f * u[2];
+        float angle = sc.startAngle + (sc.endAngle - sc.startAngle) * u[3];
+
+        float q1x = x + (endX - x) / 4.0f;
+        float c1y = height + y + cosf(VOLLEY_RADIANS(angle) * q1x);
+        float q2x = x + (endX - x) / 2.0f;
+        float c2y = height + y + cosf(VOLLEY_RADIANS(angle) * q2x);
+
+        //与原 BezierTo + RotateBy 等价的解析轨迹
+        auto trajectory = Trajectory::bezier(x, y, q1x, c1y, q2x, c2y, endX, endY,
+                                             sc.bulletDuration);
+        trajectory.spin = (u[5] - 0.5f) * 720 / sc.bulletDuration;
+        host.fireBullet(trajectory, sc.bulletDuration, 0.3f + 0.5f * u[4], offset);
+    }
+}
+
+void
+VolleyRunner::fireLaser(VolleyHost& host)
+{
+    float x, y;
+    host.getOrigin(x, y);
+
+    //中心方向：角色为面朝方向，敌人朝向目标
+    float center;
+    float sweep = (float)sc.deltaAngle;
+    if (player) {
+        bool left = host.isFacingLeft();
+        center = left ? 180.0f : 0.0f;
+        if (left) {
+            sweep = -sweep; //扫动方向随朝向镜像
+        }
+    } else {
+        host.getTarget(targetX, targetY);
+        center = VOLLEY_DEGREES(atan2f(targetY - y, targetX - x));
+    }
+
+    float spread = sc.number > 1 ? (float)(sc.endAngle - sc.startAngle) : 0.0f;
+    float spacing = sc.number > 1 ? spread / (sc.number - 1) : 0.0f;
+    float length = sc.distance > 0 ? (float)sc.distance : distance;
+
+    for (int i = 0; i < (int)sc.number; i++) {
+        LaserBeam beam;
+        beam.originX = x;
+        beam.originY = y;
+        beam.angle = center - spread / 2 + i * spacing;
+        beam.sweep = sweep;
+        beam.length = length;
+        beam.width = (float)sc.bc.width;
+        beam.warmup = LASER_WARMUP;
+        beam.active = sc.bulletDuration;
+        beam.fade = LASER_FADE;
+        beam.age = offset;
+        host.fireBeam(beam);
+    }
+}
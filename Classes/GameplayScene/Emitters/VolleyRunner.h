@@ -0,0 +1,116 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef VOLLEY_RUNNER_H
+#define VOLLEY_RUNNER_H
+
+#include "BulletSimulation.h"
+#include "DirectionTable.h"
+#include "FastRandom.h"
+#include "LaserBeam.h"
+#include "StyleConfig.h"
+#include "Trajectory.h"
+
+#include <vector>
+
+/* 原有弹幕类型（StyleType）的发射节拍与几何：游戏中的 VolleyStyle 与 bullet_bench、pattern_sim 共用
+ *
+ *  + 固定步长节拍：step 累积 dt，每到一轮从累积量减去 sc.frequency，余数留到下一次，
+ *    减去后的余数即该轮在本次 step 内已经过的时间，随子弹交给 VolleyHost 使子弹预先推进；
+ *    到期轮数超过 maxCatchUp 时丢弃最早的几轮，避免掉帧后越补越卡
+ *  + 每轮的方向、速度、轨迹与激光参数在这里求出，位置、目标、朝向由 VolleyHost 提供，
+ *    子弹与激光交给 VolleyHost 写入子弹场或显示
+ *  + 达到 totalDuration 或 cycleTimes 后停止，不再发射
+ *  + 不依赖 cocos2d
+ */
+
+/* 发射时的回调 */
+class VolleyHost
+{
+public:
+    virtual ~VolleyHost() {}
+
+    /* 发射者当前的位置 */
+    virtual void getOrigin(float& x, float& y) = 0;
+
+    /* 敌人弹幕瞄准的目标位置 */
+    virtual void getTarget(float& x, float& y) = 0;
+
+    /* 角色弹幕：角色面朝左，发射方向随之镜像 */
+    virtual bool isFacingLeft() = 0;
+
+    /* 发射一颗子弹，按轨迹飞行 life 秒；scale 为显示的缩放，offset 为该轮已经过的时间 */
+    virtual void fireBullet(const Trajectory& trajectory, float life, float scale,
+                            float offset) = 0;
+
+    /* 发射一条激光，beam.age 已是该轮已经过的时间 */
+    virtual void fireBeam(const LaserBeam& beam) = 0;
+};
+
+class VolleyRunner
+{
+public:
+    VolleyRunner();
+
+    /* 以 sc 开始发射，player 为角色弹幕；areaWidth、areaHeight 为窗口大小，决定飞行距离与
+     * 平行弹的间距。瞄准的弹幕在这里取一次目标位置 */
+    void start(const StyleConfig& sc, bool player, float areaWidth, float areaHeight,
+               VolleyHost& host);
+
+    /* 推进 dt 秒，发射到期的轮次；rng 用于 PARABOLA 的随机参数 */
+    void step(float dt, VolleyHost& host, FastRandom& rng);
+
+    /* 立即发射一轮，offset 为该轮已经过的时间 */
+    void fire(VolleyHost& host, FastRandom& rng, float offset);
+
+    /* 已达到 totalDuration 或 cycleTimes */
+    bool isStopped() const { return stopped; }
+
+    /* 掉帧后每次 step 最多补发的轮数 */
+    void setMaxCatchUp(int maxCatchUp) { this->maxCatchUp = maxCatchUp; }
+
+    /* 已发射的轮数 */
+    unsigned int getVolleys() const { return volleys; }
+
+    /* 发射中的参数，SCATTER 每轮转过 deltaAngle 后的起止角度也在这里 */
+    const StyleConfig& getConfig() const { return sc; }
+
+    /* 各弹幕类型的默认参数：子弹的纹理帧、尺寸与伤害，节拍与几何；不含种别掩码 */
+    static StyleConfig defaultConfig(StyleType style, bool player);
+
+    /* 各弹幕类型默认的出界回收：PARABOLA 会越过区域上沿再落回，只按飞行时间回收 */
+    static DespawnPolicy defaultDespawn(const StyleConfig& sc);
+
+private:
+    int dueVolleys(float dt);
+    void fireOddEven(VolleyHost& host);
+    void fireParabola(VolleyHost& host, FastRandom& rng);
+    void fireParallel(VolleyHost& host);
+    void fireScatter(VolleyHost& host);
+    void fireLaser(VolleyHost& host);
+
+private:
+    StyleConfig sc;
+    bool player;
+    float areaHeight;
+    float distance; //飞行距离，窗口对角线
+    float targetX;  //瞄准的目标位置，每 countThenChangePos 轮更新
+    float targetY;
+    unsigned int counterInside; //计数器
+    float timeAccumulation;
+    float elapsed;
+    float offset;         //正在发射的一轮已经过的时间
+    unsigned int volleys; //发射函数循环次数
+    int maxCatchUp;
+    bool stopped;
+
+    DirectionTable fan;        //start 时建立的扇形方向表
+    DirectionTable directions; //本轮转过之后的方向表
+    int fanAngle;              //建表时的起始角度
+    float fanStep;             //子弹间夹角（弧度）
+
+    std::vector<float> uniforms; //每轮复用的随机参数
+};
+
+#endif // VOLLEY_RUNNER_H
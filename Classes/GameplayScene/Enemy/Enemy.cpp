@@ -3,6 +3,7 @@
 #endif
 
 #include "GameplayScene/Enemy/Enemy.h"
+#include "GameplayScene/ContactDispatcher.h"
 #include "GameplayScene/Enemy/Frog.h"
 #include "GameplayScene/Enemy/Opossum.h"
 #include "GameplayScene/Enemy/Sakuya.h"
@@ -25,6 +26,9 @@ Enemy::create(const std::string& tag)
         pRet = new (std::nothrow) Udonge();
     }
 
+    if (pRet) {
+        pRet->rng.seed(FastRandom::nextStreamSeed());
+    }
     if (pRet && pRet->init(tag)) {
         pRet->autorelease();
         return pRet;
@@ -41,6 +45,22 @@ Enemy::resetJump()
     this->_canJump = true;
 }
 
+void
+Enemy::registerContacts(ContactDispatcher* contacts)
+{
+    //折线刚体可以从下方穿过，冲量方向向上时才站在上面
+    contacts->onBegin(enemyCategory, groundCategory, [](const ContactPair& pair) {
+        if (pair.nodeB->getTag() != polylineCategoryTag) {
+            return true;
+        }
+        if (pair.contact.getContactData()->normal.y > 0) {
+            static_cast<Enemy*>(pair.nodeA)->resetJump();
+            return true;
+        }
+        return false;
+    });
+}
+
 void
 Enemy::setTarget(Player*& player)
 {
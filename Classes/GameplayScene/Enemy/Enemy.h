@@ -7,11 +7,14 @@
 
 #include "GameplayScene/Player/Player.h"
 #include "GameplayScene/State.h"
+#include "GameplayScene/Emitters/FastRandom.h"
 #include "GameplayScene/common.h"
 
 #include "cocos2d.h"
 using namespace cocos2d;
 
+class ContactDispatcher;
+
 class Enemy : public Node
 {
 public:
@@ -28,6 +31,9 @@ public:
     virtual void setEmitter();
     virtual void resetJump();
 
+    //登记敌人与地面的接触处理
+    static void registerContacts(ContactDispatcher* contacts);
+
 public:
     std::string enemyTag;
     std::string face;
@@ -48,6 +54,8 @@ public:
 
     StateMachine<Enemy>* stateMachine;
 
+    FastRandom rng; // AI 的随机决策，种子由本局种子派生
+
 protected:
     PhysicsBody* body;
 
@@ -93,7 +93,7 @@ Frog::Patrol::Enter(Enemy* enemy)
     frog->schedule(
         [frog](float dt) {
             int scale;
-            int weight = random(0, 100);
+            int weight = frog->rng.range(0, 100);
             if (weight >= 50) {
                 scale = 1;
                 frog->enemyDirection = Direction::LEFT;
@@ -143,7 +143,7 @@ Frog::Alert::Enter(Enemy* enemy)
 
     frog->schedule(
         [frog](float dt) {
-            int weight = random(0, 100);
+            int weight = frog->rng.range(0, 100);
             if (weight >= 80) {
                 if (frog->_canJump) {
                     frog->stateMachine->changeState(Frog::Jump::getInstance());
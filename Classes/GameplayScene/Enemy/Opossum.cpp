@@ -134,7 +134,7 @@ Opossum::Patrol::Enter(Enemy* enemy)
 
     enemy->schedule(
         [enemy](float dt) {
-            int weight = random(0, 100);
+            int weight = enemy->rng.range(0, 100);
             if (weight >= 60) {
                 if (enemy->isScheduled(CC_SCHEDULE_SELECTOR(Opossum::horizontallyAccelerate))) {
                     enemy->unschedule(CC_SCHEDULE_SELECTOR(Opossum::horizontallyAccelerate));
@@ -122,6 +122,10 @@ Sakuya::decreaseHp(int damage)
     if (damageAccumulation >= 400) {
         this->stateMachine->changeState(Sakuya::Hit::getInstance());
         damageAccumulation = 0;
+
+        //转入受击阶段时清屏
+        EventCustom event("boss_phase_change");
+        _eventDispatcher->dispatchEvent(&event);
     }
 
     Hp_Mp_Change hpChange;
@@ -170,7 +174,7 @@ Sakuya::StandAndChooseAction::Enter(Enemy* enemy)
 
     sakuya->schedule(
         [sakuya](float dt) {
-            int weight = random(0, 100);
+            int weight = sakuya->rng.range(0, 100);
             if (sakuya->CurrentHp <= sakuya->BaseHp * 0.5 && weight >= 60) {
                 sakuya->stateMachine->changeState(Sakuya::UseSpellCard::getInstance());
             } else if (weight >= 60) {
@@ -378,23 +382,7 @@ Sakuya::ShootA::Enter(Enemy* enemy)
     auto actionDone =
         CallFuncN::create(CC_CALLBACK_0(Sakuya::ShootA::defaultChangeState, this, sakuya));
     std::function<void(Ref*)> shoot = [sakuya](Ref*) {
-        StyleConfig sc1;
-        sc1.style = StyleType::PARALLEL;
-        sc1.frequency = 0.0f;
-        sc1.bulletDuration = 4.0f;
-        sc1.number = 5;
-        sc1.countThenChangePos = 1;
-        sc1.interval = 2.0f;
-        sc1.cycleTimes = 1;
-        sc1.totalDuration = 1.0;
-        sc1.bc.name = "b2_2_1.png";
-        sc1.bc.length = 10;
-        sc1.bc.width = 10;
-        sc1.bc.harm = 10;
-        sc1.bc._categoryBitmask = 0;
-        sc1.bc._collisionBitmask = 0;
-        sc1.bc._contactTestBitmask = 0;
-        sakuya->emitter->playStyle(sc1);
+        sakuya->emitter->playPattern("sakuya_shoot_a");
     };
     sakuya->currentAnimateAction =
         Sequence::create(animate1, CallFuncN::create(shoot), animate2, actionDone, NULL);
@@ -430,24 +418,7 @@ Sakuya::ShootB::Enter(Enemy* enemy)
     auto actionDone =
         CallFuncN::create(CC_CALLBACK_0(Sakuya::ShootB::defaultChangeState, this, sakuya));
     std::function<void(Ref*)> shoot = [sakuya](Ref*) {
-        StyleConfig sc;
-
-        sc.style = StyleType::ODDEVEN;
-        sc.frequency = 0.0f;
-        sc.bulletDuration = 5.0;
-        sc.number = 7;
-        sc.countThenChangePos = 1;
-        sc.totalDuration = 1.0;
-        sc.cycleTimes = 1;
-        sc.bc.name = "b2_2_1.png";
-        sc.bc.length = 10;
-        sc.bc.width = 20;
-        sc.bc.harm = 10;
-        sc.bc._categoryBitmask = 0;
-        sc.bc._collisionBitmask = 0;
-        sc.bc._contactTestBitmask = 0;
-
-        sakuya->emitter->playStyle(sc);
+        sakuya->emitter->playPattern("sakuya_shoot_b");
     };
     sakuya->currentAnimateAction =
         Sequence::create(animate1, CallFuncN::create(shoot), animate2, actionDone, NULL);
@@ -500,22 +471,7 @@ Sakuya::UseSpellCard::Enter(Enemy* enemy)
         Animate::create(AnimationCache::getInstance()->getAnimation("sakuyaAttackB_2"));
 
     std::function<void(Ref*)> shoot = [sakuya](Ref*) {
-        StyleConfig sc;
-        sc.style = StyleType::ODDEVEN;
-        sc.frequency = 0.1f;
-        sc.bulletDuration = 4.0;
-        sc.number = 15;
-        sc.countThenChangePos = 5;
-        sc.totalDuration = 1.0;
-        sc.cycleTimes = 5;
-        sc.bc.name = "b2_2_1.png";
-        sc.bc.length = 10;
-        sc.bc.width = 20;
-        sc.bc.harm = 10;
-        sc.bc._categoryBitmask = 0;
-        sc.bc._collisionBitmask = 0;
-        sc.bc._contactTestBitmask = 0;
-        sakuya->emitter->playStyle(sc);
+        sakuya->emitter->playPattern("sakuya_spell_card");
     };
 
     auto actionDone =
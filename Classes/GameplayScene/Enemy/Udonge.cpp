@@ -122,6 +122,10 @@ Udonge::decreaseHp(int damage)
     if (damageAccumulation >= 400) {
         this->stateMachine->changeState(Udonge::Hit::getInstance());
         damageAccumulation = 0;
+
+        //转入受击阶段时清屏
+        EventCustom event("boss_phase_change");
+        _eventDispatcher->dispatchEvent(&event);
     }
 
     Hp_Mp_Change hpChange;
@@ -170,7 +174,7 @@ Udonge::StandAndChooseAction::Enter(Enemy* enemy)
 
     udonge->schedule(
         [udonge](float dt) {
-            int weight = random(0, 100);
+            int weight = udonge->rng.range(0, 100);
             if (udonge->CurrentHp <= udonge->BaseHp * 0.4 && weight >= 70) {
                 udonge->stateMachine->changeState(Udonge::UseSpellCard::getInstance());
             } else if (weight >= 60) {
@@ -267,7 +271,7 @@ Udonge::Jump::Enter(Enemy* enemy)
         [udonge](float dt) {
             Vec2 velocity = udonge->body->getVelocity();
             if (velocity.y < 10) {
-                int weight = random(0, 100);
+                int weight = udonge->rng.range(0, 100);
                 if (weight >= 50) {
                     udonge->stateMachine->changeState(Udonge::ShootFromAir::getInstance());
                 } else {
@@ -378,30 +382,14 @@ Udonge::Shoot::Enter(Enemy* enemy)
     auto actionDone =
         CallFuncN::create(CC_CALLBACK_0(Udonge::Shoot::defaultChangeState, this, udonge));
 
-    int weight = random(0, 100);
+    int weight = udonge->rng.range(0, 100);
     if (weight >= 50) {
         auto animateAa1 =
             Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackAa_1"));
         auto animateAa2 =
             Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackAa_2"));
         std::function<void(Ref*)> shoot = [udonge](Ref*) {
-            StyleConfig sc1;
-            sc1.style = StyleType::PARALLEL;
-            sc1.frequency = 0.1f;
-            sc1.bulletDuration = 2.0f;
-            sc1.number = 1;
-            sc1.countThenChangePos = 1;
-            sc1.interval = 2.0f;
-            sc1.cycleTimes = 2;
-            sc1.totalDuration = 1.0;
-            sc1.bc.name = "b1_7_2.png";
-            sc1.bc.length = 5;
-            sc1.bc.width = 5;
-            sc1.bc.harm = 10;
-            sc1.bc._categoryBitmask = 0;
-            sc1.bc._collisionBitmask = 0;
-            sc1.bc._contactTestBitmask = 0;
-            udonge->emitter->playStyle(sc1);
+            udonge->emitter->playPattern("udonge_shoot_a");
         };
         udonge->currentAnimateAction =
             Sequence::create(animateAa1, CallFuncN::create(shoot), animateAa2, actionDone, NULL);
@@ -411,23 +399,7 @@ Udonge::Shoot::Enter(Enemy* enemy)
         auto animateBa2 =
             Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackBa_2"));
         std::function<void(Ref*)> shoot = [udonge](Ref*) {
-            StyleConfig sc1;
-            sc1.style = StyleType::PARALLEL;
-            sc1.frequency = 0.1f;
-            sc1.bulletDuration = 2.0f;
-            sc1.number = 1;
-            sc1.countThenChangePos = 1;
-            sc1.interval = 2.0f;
-            sc1.cycleTimes = 1;
-            sc1.totalDuration = 1.0;
-            sc1.bc.name = "b1_7_2.png";
-            sc1.bc.length = 5;
-            sc1.bc.width = 5;
-            sc1.bc.harm = 10;
-            sc1.bc._categoryBitmask = 0;
-            sc1.bc._collisionBitmask = 0;
-            sc1.bc._contactTestBitmask = 0;
-            udonge->emitter->playStyle(sc1);
+            udonge->emitter->playPattern("udonge_shoot_b");
         };
         udonge->currentAnimateAction =
             Sequence::create(animateBa1, CallFuncN::create(shoot), animateBa2, actionDone, NULL);
@@ -466,27 +438,12 @@ Udonge::ShootFromAir::Enter(Enemy* enemy)
     auto actionDone =
         CallFuncN::create(CC_CALLBACK_0(Udonge::ShootFromAir::defaultChangeState, this, udonge));
 
-    int weight = random(0, 100);
+    int weight = udonge->rng.range(0, 100);
     if (weight >= 50) {
         auto animateAd =
             Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackAd_1"));
         std::function<void(Ref*)> shoot = [udonge](Ref*) {
-            StyleConfig sc;
-            sc.style = StyleType::ODDEVEN;
-            sc.frequency = 0.0f;
-            sc.bulletDuration = 5.0;
-            sc.number = 7;
-            sc.countThenChangePos = 1;
-            sc.totalDuration = 1.0;
-            sc.cycleTimes = 1;
-            sc.bc.name = "b1_7_2.png";
-            sc.bc.length = 10;
-            sc.bc.width = 20;
-            sc.bc.harm = 10;
-            sc.bc._categoryBitmask = 0;
-            sc.bc._collisionBitmask = 0;
-            sc.bc._contactTestBitmask = 0;
-            udonge->emitter->playStyle(sc);
+            udonge->emitter->playPattern("udonge_shoot_air");
         };
         udonge->currentAnimateAction =
             Sequence::create(animateAd, CallFuncN::create(shoot), actionDone, NULL);
@@ -496,22 +453,7 @@ Udonge::ShootFromAir::Enter(Enemy* enemy)
         auto animateBd_2 =
             Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackBd_2"));
         std::function<void(Ref*)> shoot = [udonge](Ref*) {
-            StyleConfig sc;
-            sc.style = StyleType::ODDEVEN;
-            sc.frequency = 0.0f;
-            sc.bulletDuration = 5.0;
-            sc.number = 7;
-            sc.countThenChangePos = 1;
-            sc.totalDuration = 1.0;
-            sc.cycleTimes = 1;
-            sc.bc.name = "b1_7_2.png";
-            sc.bc.length = 10;
-            sc.bc.width = 20;
-            sc.bc.harm = 10;
-            sc.bc._categoryBitmask = 0;
-            sc.bc._collisionBitmask = 0;
-            sc.bc._contactTestBitmask = 0;
-            udonge->emitter->playStyle(sc);
+            udonge->emitter->playPattern("udonge_shoot_air");
         };
         udonge->currentAnimateAction =
             Sequence::create(animateBd_1, CallFuncN::create(shoot), animateBd_2, actionDone, NULL);
@@ -570,41 +512,11 @@ Udonge::UseSpellCard::Enter(Enemy* enemy)
         Animate::create(AnimationCache::getInstance()->getAnimation("udongeAttackBa_2"));
 
     std::function<void(Ref*)> shootA = [udonge](Ref*) {
-        StyleConfig sc;
-        sc.style = StyleType::ODDEVEN;
-        sc.frequency = 0.1f;
-        sc.bulletDuration = 3.5;
-        sc.number = 12;
-        sc.countThenChangePos = 1;
-        sc.totalDuration = 1.0;
-        sc.cycleTimes = 2;
-        sc.bc.name = "b1_7_2.png";
-        sc.bc.length = 5;
-        sc.bc.width = 5;
-        sc.bc.harm = 10;
-        sc.bc._categoryBitmask = 0;
-        sc.bc._collisionBitmask = 0;
-        sc.bc._contactTestBitmask = 0;
-        udonge->emitter->playStyle(sc);
+        udonge->emitter->playPattern("udonge_spell_card_a");
     };
 
     std::function<void(Ref*)> shootB = [udonge](Ref*) {
-        StyleConfig sc;
-        sc.style = StyleType::ODDEVEN;
-        sc.frequency = 0.05f;
-        sc.bulletDuration = 2.5;
-        sc.number = 2;
-        sc.countThenChangePos = 1;
-        sc.totalDuration = 5.0;
-        sc.cycleTimes = 20;
-        sc.bc.name = "b1_7_2.png";
-        sc.bc.length = 5;
-        sc.bc.width = 5;
-        sc.bc.harm = 10;
-        sc.bc._categoryBitmask = 0;
-        sc.bc._collisionBitmask = 0;
-        sc.bc._contactTestBitmask = 0;
-        udonge->emitter->playStyle(sc);
+        udonge->emitter->playPattern("udonge_spell_card_b");
     };
 
     auto actionDone =
@@ -4,9 +4,13 @@
 
 #include "GameplayScene/GameplayScene.h"
 #include "GameplayScene/CtrlPanel/CtrlPanelLayer.h"
+#include "GameplayScene/ContactDispatcher.h"
 #include "GameplayScene/Elevator.h"
-#include "GameplayScene/Emitters/Bullet.h"
+#include "GameplayScene/Emitters/BulletLayer.h"
 #include "GameplayScene/Emitters/Emitter.h"
+#include "GameplayScene/Emitters/EmitterSystem.h"
+#include "GameplayScene/Emitters/FastRandom.h"
+#include "GameplayScene/Emitters/Pattern.h"
 #include "GameplayScene/Enemy/Enemy.h"
 #include "GameplayScene/EventFilterManager.h"
 #include "GameplayScene/EventScriptHanding.h"
@@ -18,6 +22,8 @@
 
 #include "AudioController.h"
 
+#include <ctime>
+
 #define PTM_RATIO 1
 
 #define BACK_PARALLAX_ZORDER -10
@@ -32,6 +38,17 @@
 #define MAP_LAYER_ENEMY_ZORDER 1
 #define MAP_LAYER_CAMERA_ZORDER -1
 #define MAP_LAYER_OTHER_ZORDER 2
+#define MAP_LAYER_BULLET_ZORDER 0
+
+// 本局随机种子，0 时取当前时间；复现问题时填入日志中的种子
+#define GAMEPLAY_RANDOM_SEED 0
+
+// 画质档位，决定同屏子弹预算；移动设备取中档
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+#define GAMEPLAY_QUALITY_TIER QualityTier::MEDIUM
+#else
+#define GAMEPLAY_QUALITY_TIER QualityTier::HIGH
+#endif
 
 const std::string GameplayScene::TAG{ "GameplayScene" };
 
@@ -111,6 +128,17 @@ GameplayScene::init()
 
     _eventScriptHanding = new EventScriptHanding(this);
 
+    //发射器与敌人按创建顺序从本局种子派生各自的随机数
+    uint64_t seed = GAMEPLAY_RANDOM_SEED;
+    if (seed == 0) {
+        seed = (uint64_t)time(nullptr);
+    }
+    FastRandom::beginRound(seed);
+    log("[GameplayScene] random seed %llu", (unsigned long long)seed);
+
+    //上一局的暂停与时间缩放不带入本局
+    EmitterSystem::getInstance()->reset();
+
     return true;
 }
 
@@ -162,6 +190,11 @@ GameplayScene::initMap()
     mapLayer->setName("mapLayer");
     this->addChild(mapLayer, MAP_LAYER_ZORDER);
 
+    //子弹层，所有弹幕的子弹都由它统一推进
+    auto bulletLayer = BulletLayer::create();
+    bulletLayer->setQuality(GAMEPLAY_QUALITY_TIER);
+    mapLayer->addChild(bulletLayer, MAP_LAYER_BULLET_ZORDER);
+
     //创建静态刚体墙
     createPhysical(1);
 }
@@ -295,6 +328,8 @@ GameplayScene::initAnimationCache()
     SpriteFrameCache::getInstance()->addSpriteFramesWithFile("emitter/bullets/bullet2.plist");
     SpriteFrameCache::getInstance()->addSpriteFramesWithFile("emitter/bullets/bullet3.plist");
     SpriteFrameCache::getInstance()->addSpriteFramesWithFile("emitter/bullets/laser1.plist");
+    //编译弹幕模式，需要在子弹素材载入之后
+    PatternLibrary::getInstance()->load();
 
     auto characterTags = GameData::getInstance()->getOnStageCharacterTagList();
 
@@ -574,6 +609,9 @@ GameplayScene::initArea()
         float height = dict["height"].asFloat();
         curArea.setRect(x, y, width, height);
         if (curArea.containsPoint(playerPos)) {
+            //子弹命中检测网格覆盖当前区域
+            BulletLayer::getLayerOf(mapLayer)->setArea(curArea);
+
             //替换背景图片
             backgroundParallaxPicture->setTexture(dict["background"].asString());
             auto width = backgroundParallaxPicture->getContentSize().width;
@@ -793,243 +831,29 @@ GameplayScene::initEvent()
     }
 }
 
-bool
-GameplayScene::contactBegin(const PhysicsContact& contact)
-{
-    auto shapeA = contact.getShapeA();
-    auto shapeB = contact.getShapeB();
-    auto nodeA = contact.getShapeA()->getBody()->getNode();
-    auto nodeB = contact.getShapeB()->getBody()->getNode();
-    if (nodeA && nodeB) {
-        auto tagA = nodeA->getTag();
-        auto tagB = nodeB->getTag();
-        // entityA和entityB对nodeA和nodeB进行映射
-        Node* entityA;
-        Node* entityB;
-        PhysicsShape* entityA_shape;
-        PhysicsShape* entityB_shape;
-
-        // enemy相关
-        if (tagA == enemyCategoryTag || tagB == enemyCategoryTag) {
-            if (tagA == enemyCategoryTag) {
-                entityA = nodeA;
-                entityB = nodeB;
-                entityA_shape = shapeA;
-                entityB_shape = shapeB;
-            } else if (tagB == enemyCategoryTag) {
-                entityA = nodeB;
-                entityB = nodeA;
-                entityA_shape = shapeB;
-                entityB_shape = shapeA;
-            }
-
-            // 当enemy碰到了折线刚体
-            if (entityB->getTag() == polylineCategoryTag) {
-                //当冲量方向向上时可以穿过折线刚体
-                if (contact.getContactData()->normal.y > 0) {
-                    auto _enemy = (Enemy*)entityA;
-                    _enemy->resetJump();
-                    return true;
-                } else {
-                    return false;
-                }
-            }
-            // 当enemy碰到了地面刚体
-            else if (entityB->getTag() == groundCategoryTag) {
-                //什么也不做
-            }
-            // 当enemy碰到了子弹
-            else if (entityB->getTag() == bulletCategoryTag) {
-                ParticleSystem* _ps = ParticleExplosion::createWithTotalParticles(5);
-                _ps->setTexture(Director::getInstance()->getTextureCache()->addImage(
-                    "gameplayscene/smallOrb000.png"));
-
-                // cocos2dx的粒子系统有三种位置类型
-                mapLayer->addChild(_ps, MAP_LAYER_OTHER_ZORDER);
-                _ps->setPositionType(ParticleSystem::PositionType::RELATIVE);
-                _ps->setPosition(entityA->getPosition());
-                _ps->setLife(1.2);
-                _ps->setLifeVar(0.3);
-                _ps->setEndSize(0.0f);
-                _ps->setAutoRemoveOnFinish(true);
-
-                auto _enemy = (Enemy*)entityA;
-                auto _bullet = (Bullet*)entityB;
-
-                DamageInfo _damageInfo;
-                _damageInfo.damage = _bullet->getDamage();
-                _damageInfo.target = _enemy;
-                EventCustom event("bullet_hit_enemy");
-                event.setUserData((void*)&_damageInfo);
-                _eventDispatcher->dispatchEvent(&event);
-
-                entityB->removeFromParentAndCleanup(true); //移除子弹
-            }
-            // 当enemy站在电梯上
-            else if (entityB->getTag() == elevatorCategoryTag) {
-                if (contact.getContactData()->normal.y > 0) {
-                    auto _enemy = (Enemy*)entityA;
-                    auto _elevator = (Elevator*)entityB;
-                    _enemy->resetJump();
-                    _elevator->addPassenger(_enemy);
-                    return true;
-                } else {
-                    return false;
-                }
-            }
-
-            //其他
-        }
-        // player相关
-        if (tagA == playerCategoryTag || tagB == playerCategoryTag) {
-            if (nodeA->getTag() == playerCategoryTag) {
-                entityA = nodeA;
-                entityB = nodeB;
-                entityA_shape = shapeA;
-                entityB_shape = shapeB;
-            } else if (nodeB->getTag() == playerCategoryTag) {
-                entityA = nodeB;
-                entityB = nodeA;
-                entityA_shape = shapeB;
-                entityB_shape = shapeA;
-            }
-
-            //当player碰到了折线刚体
-            if (entityB->getTag() == polylineCategoryTag) {
-                if (contact.getContactData()->normal.y > 0) {
-                    auto _player = (Player*)entityA;
-                    _player->resetJump();
-                    return true;
-                } else {
-                    return false;
-                }
-            }
-            // 当player碰到了地面刚体
-            else if (entityB->getTag() == groundCategoryTag) {
-                // do nothing
-            }
-            // 当player碰到了敌人或索敌框
-            else if (entityB->getTag() == enemyCategoryTag) {
-                // 当player碰到了敌人的索敌框
-                if (entityB_shape->getTag() == lockCategoryTag) {
-                    auto _enemy = (Enemy*)entityB;
-                    _enemy->stateMachine->autoChangeState();
-                }
-                // 当player碰到了敌人本身
-                else {
-                    DamageInfo _damageInfo;
-                    _damageInfo.damage = 10;      //碰撞伤害
-                    _damageInfo.target = entityA; //受损目标
-                    EventCustom event("bullet_hit_player");
-                    event.setUserData((void*)&_damageInfo);
-                    _eventDispatcher->dispatchEvent(&event);
-                }
-
-            }
-            // 当player碰到了事件点或者宝箱
-            else if (entityB->getTag() == eventCategoryTag) {
-                //抛出event的tag
-                EventCustom event("trigger_event");
-                event.setUserData((void*)entityB->getName().c_str());
-                _eventDispatcher->dispatchEvent(&event);
-                entityB->removeFromParent();
-            }
-            // 当player站在电梯上
-            else if (entityB->getTag() == elevatorCategoryTag) {
-
-                if (contact.getContactData()->normal.y > 0) {
-                    auto _player = (Player*)entityA;
-                    auto _elevator = (Elevator*)entityB;
-                    _player->resetJump();
-                    _elevator->addPassenger(curPlayer);
-                    return true;
-                } else {
-                    return false;
-                }
-            }
-            //其他
-        }
-
-        //飞行扫把
-        if (tagA == elevatorCategoryTag || tagB == elevatorCategoryTag) {
-            if (nodeA->getTag() == elevatorCategoryTag) {
-                entityA = nodeA;
-                entityB = nodeB;
-                entityA_shape = shapeA;
-                entityB_shape = shapeB;
-            } else if (nodeB->getTag() == elevatorCategoryTag) {
-                entityA = nodeB;
-                entityB = nodeA;
-                entityA_shape = shapeB;
-                entityB_shape = shapeA;
-            }
-
-            //当拖把碰到了地形
-            if (entityB->getTag() == groundCategoryTag) {
-                entityA->removeFromParent();
-            }
-        }
-
-        //其他
-    }
-    return true;
-}
-
-bool
-GameplayScene::contactSeparate(const PhysicsContact& contact)
-{
-    auto nodeA = contact.getShapeA()->getBody()->getNode();
-    auto nodeB = contact.getShapeB()->getBody()->getNode();
-    if (nodeA && nodeB) {
-        auto tagA = nodeA->getTag();
-        auto tagB = nodeB->getTag();
-        Node* entityA;
-        Node* entityB;
-
-        // enemy相关
-        if (tagA == enemyCategoryTag || tagB == enemyCategoryTag) {
-            if (tagA == enemyCategoryTag) {
-                entityA = nodeA;
-                entityB = nodeB;
-            } else if (tagB == enemyCategoryTag) {
-                entityA = nodeB;
-                entityB = nodeA;
-            }
-
-            if (entityB->getTag() == elevatorCategoryTag) {
-                auto _enemy = (Enemy*)entityA;
-                auto _elevator = (Elevator*)entityB;
-                _elevator->removePassenger(_enemy);
-            }
-            //其他
-        }
-        // player相关
-        if (tagA == playerCategoryTag || tagB == playerCategoryTag) {
-            if (nodeA->getTag() == playerCategoryTag) {
-                entityA = nodeA;
-                entityB = nodeB;
-            } else if (nodeB->getTag() == playerCategoryTag) {
-                entityA = nodeB;
-                entityB = nodeA;
-            }
-
-            if (entityB->getTag() == elevatorCategoryTag) {
-                auto _elevator = (Elevator*)entityB;
-                _elevator->removePassenger(curPlayer);
-            }
-            //其他
-        }
-    }
-    return true;
-}
-
 //初始化监听器，手动指定优先级
 void
 GameplayScene::initPhysicsContactListener()
 {
+    //各类刚体自行登记关心的接触，未登记的接触按默认处理
+    auto contacts = ContactDispatcher::getInstance();
+    contacts->reset();
+    Player::registerContacts(contacts);
+    Enemy::registerContacts(contacts);
+    Elevator::registerContacts(contacts);
+
+    //碰到事件点或者宝箱时抛出事件点的名字
+    contacts->onBegin(playerCategory, eventCategory, [this](const ContactPair& pair) {
+        EventCustom event("trigger_event");
+        event.setUserData((void*)pair.nodeB->getName().c_str());
+        _eventDispatcher->dispatchEvent(&event);
+        pair.nodeB->removeFromParent();
+        return true;
+    });
+
     auto filter = EventListenerPhysicsContact::create();
-    filter->onContactBegin = CC_CALLBACK_1(GameplayScene::contactBegin, this);
-    filter->onContactSeparate = CC_CALLBACK_1(GameplayScene::contactSeparate, this);
+    filter->onContactBegin = CC_CALLBACK_1(ContactDispatcher::contactBegin, contacts);
+    filter->onContactSeparate = CC_CALLBACK_1(ContactDispatcher::contactSeparate, contacts);
     _eventDispatcher->addEventListenerWithFixedPriority(filter, 50);
 }
 
@@ -1060,6 +884,60 @@ GameplayScene::initCustomEventListener()
     _eventDispatcher->addCustomEventListener(
         "settings_key_pressed", [this](EventCustom* e) { this->onEventSettingsKeyPressed(e); });
 
+    // BulletLayer每帧整批抛出的命中记录
+    _eventDispatcher->addCustomEventListener("bullet_hits", [this](EventCustom* e) {
+        auto hits = (std::vector<BulletHit>*)e->getUserData();
+        for (auto& hit : *hits) {
+            DamageInfo _damageInfo;
+            _damageInfo.damage = hit.damage;
+            _damageInfo.target = hit.target;
+
+            if (hit.category == enemyCategory) {
+                ParticleSystem* _ps = ParticleExplosion::createWithTotalParticles(5);
+                _ps->setTexture(Director::getInstance()->getTextureCache()->addImage(
+                    "gameplayscene/smallOrb000.png"));
+
+                // cocos2dx的粒子系统有三种位置类型
+                mapLayer->addChild(_ps, MAP_LAYER_OTHER_ZORDER);
+                _ps->setPositionType(ParticleSystem::PositionType::RELATIVE);
+                _ps->setPosition(hit.target->getPosition());
+                _ps->setLife(1.2);
+                _ps->setLifeVar(0.3);
+                _ps->setEndSize(0.0f);
+                _ps->setAutoRemoveOnFinish(true);
+
+                EventCustom event("bullet_hit_enemy");
+                event.setUserData((void*)&_damageInfo);
+                _eventDispatcher->dispatchEvent(&event);
+            } else if (hit.category == playerCategory) {
+                EventCustom event("bullet_hit_player");
+                event.setUserData((void*)&_damageInfo);
+                _eventDispatcher->dispatchEvent(&event);
+            }
+        }
+    });
+
+    // 清屏后的拾取物碰到自机，按个数恢复灵力
+    _eventDispatcher->addCustomEventListener("bullet_pickups", [this](EventCustom* e) {
+        auto pickups = (std::vector<BulletPickup>*)e->getUserData();
+        for (auto& pickup : *pickups) {
+            auto _player = (Player*)pickup.target;
+            int gain = std::min(pickup.mana, _player->baseMana - _player->currentMana);
+            if (gain <= 0) {
+                continue;
+            }
+
+            Hp_Mp_Change mpChange;
+            mpChange.tag = _player->playerTag;
+            mpChange.value = gain;
+
+            EventCustom event("mana_change");
+            event.setUserData((void*)&mpChange);
+            _eventDispatcher->dispatchEvent(&event);
+            _player->currentMana += gain;
+        }
+    });
+
     _eventDispatcher->addCustomEventListener("bullet_hit_enemy", [this](EventCustom* e) {
         auto _damageInfo = (DamageInfo*)e->getUserData();
         auto _enemy = (Enemy*)_damageInfo->target;
@@ -1170,29 +1048,12 @@ GameplayScene::initCustomEventListener()
     _eventDispatcher->addCustomEventListener("use_spell_card", [this](EventCustom* e) {
         string spellTag = (char*)e->getUserData();
         Hp_Mp_Change mpChange;
-        if (spellTag == "C1") {
+        //符卡的弹幕与灵力消耗见 gamedata/spell_cards.json 中的 pattern
+        auto pattern = PatternLibrary::getInstance()->getPattern(spellTag);
+        if (pattern) {
             mpChange.tag = curPlayer->playerTag;
-            mpChange.value = -20;
-
-            auto& sc = curPlayer->spellCardStyleConfig;
-            sc.style = StyleType::PARABOLA;
-            sc.frequency = 0.06f;
-            sc.bulletDuration = 2.5;
-            sc.number = 10;
-            sc.countThenChangePos = 4;
-            sc.cycleTimes = -1;
-            sc.totalDuration = 0.8;
-            sc.height = 30;
-            sc.distance = 600;
-            sc.startAngle = 10;
-            sc.endAngle = 50;
-            sc.bc.name = "b3_1_3.png";
-            sc.bc.length = 25;
-            sc.bc.width = 25;
-            sc.bc.harm = 5;
-            sc.bc._categoryBitmask = bulletCategory;
-            sc.bc._collisionBitmask = enemyCategory;
-            sc.bc._contactTestBitmask = enemyCategory;
+            mpChange.value = -pattern->manaCost;
+            curPlayer->spellCardPattern = spellTag;
 
             EventCustom event("mana_change");
             event.setUserData((void*)&mpChange);
@@ -1203,80 +1064,26 @@ GameplayScene::initCustomEventListener()
             }
 
             this->curPlayer->stateMachine->changeState(Player::UseSpellCard::getInstance());
-        } else if (spellTag == "C2") {
-            mpChange.tag = curPlayer->playerTag;
-            mpChange.value = -30;
-
-            auto& sc = curPlayer->spellCardStyleConfig; //引用
-            sc.style = StyleType::PARALLEL;
-
-            sc.frequency = 0.2f;
-            sc.bulletDuration = 2.4f;
-            sc.countThenChangePos = 1;
-            sc.interval = 1.2f;
-            sc.number = 5;
-            sc.cycleTimes = -1;
-            sc.totalDuration = 2.0;
-
-            sc.bc.name = "b3_2_1.png";
-            sc.bc.length = 15;
-            sc.bc.width = 15;
-            sc.bc.harm = 5;
-            sc.bc._categoryBitmask = bulletCategory;
-            sc.bc._collisionBitmask = enemyCategory;
-            sc.bc._contactTestBitmask = enemyCategory;
-
-            EventCustom event("mana_change");
-            event.setUserData((void*)&mpChange);
-            _eventDispatcher->dispatchEvent(&event);
-            curPlayer->currentMana -= mpChange.value;
-            if (curPlayer->currentMana < 0) {
-                curPlayer->currentMana = 0;
-            }
-
-            this->curPlayer->stateMachine->changeState(Player::UseSpellCard::getInstance());
-        } else if (spellTag == "C3") {
-            mpChange.tag = curPlayer->playerTag;
-            mpChange.value = -30;
-
-            auto& sc = curPlayer->spellCardStyleConfig; //引用
 
-            sc.style = StyleType::SCATTER;
-
-            sc.frequency = 0.10f;
-            sc.bulletDuration = 3.0;
-            sc.number = 5;
-            sc.bc.name = "b1_3_3.png";
-            sc.startAngle = 260;
-            sc.endAngle = 280;
-            sc.deltaAngle = 0;
-
-            sc.cycleTimes = -1;
-            sc.totalDuration = 2.0;
-
-            sc.bc.name = "b3_2_1.png";
-            sc.bc.length = 15;
-            sc.bc.width = 15;
-            sc.bc.harm = 5;
-            sc.bc._categoryBitmask = bulletCategory;
-            sc.bc._collisionBitmask = enemyCategory;
-            sc.bc._contactTestBitmask = enemyCategory;
-
-            EventCustom event("mana_change");
-            event.setUserData((void*)&mpChange);
-            _eventDispatcher->dispatchEvent(&event);
-            curPlayer->currentMana -= mpChange.value;
-            if (curPlayer->currentMana < 0) {
-                curPlayer->currentMana = 0;
-            }
-
-            this->curPlayer->stateMachine->changeState(Player::UseSpellCard::getInstance());
+            //放符卡时清屏，敌方子弹变为灵力拾取物
+            auto bulletLayer = BulletLayer::getLayerOf(mapLayer);
+            bulletLayer->cancelBullets(enemyCategory, bulletLayer->getArea());
         }
 
         AudioController::getInstance()->playEffect("se/use_spell_card.wav");
     });
 
+    _eventDispatcher->addCustomEventListener("boss_phase_change", [this](EventCustom* e) {
+        //boss 累计受到一定伤害、转入受击阶段时清屏
+        auto bulletLayer = BulletLayer::getLayerOf(mapLayer);
+        bulletLayer->cancelBullets(enemyCategory, bulletLayer->getArea());
+    });
+
     _eventDispatcher->addCustomEventListener("kill_boss", [this](EventCustom* e) {
+        //击破 boss 时清屏
+        auto bulletLayer = BulletLayer::getLayerOf(mapLayer);
+        bulletLayer->cancelBullets(enemyCategory, bulletLayer->getArea());
+
         _bosses--;
         if (_bosses == 0) {
             auto ctrlLayer = (CtrlPanelLayer*)controlPanel;
@@ -1423,6 +1230,9 @@ GameplayScene::onEventSettingsKeyPressed(EventCustom*)
 void
 GameplayScene::update(float dt)
 {
+    //所有弹幕每帧在此统一发射一次
+    EmitterSystem::getInstance()->update(dt);
+
     Vec2 poi = curPlayer->getPosition();
     camera->setPosition(poi.x + 100, poi.y + 70); //移动摄像机
 
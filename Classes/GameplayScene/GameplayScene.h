@@ -48,10 +48,6 @@ public:
     void initElevator();
     /*临时项*/
 
-    //对碰撞进行处理
-    bool contactBegin(const PhysicsContact& contact);
-    bool contactSeparate(const PhysicsContact& contact);
-
     void endGame();
 
 public:
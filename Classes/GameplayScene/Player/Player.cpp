@@ -3,7 +3,9 @@
 #endif
 
 #include "GameplayScene/Player/Player.h"
+#include "GameplayScene/ContactDispatcher.h"
 #include "GameplayScene/Emitters/Emitter.h"
+#include "GameplayScene/Enemy/Enemy.h"
 #include "GameplayScene/Player/Alice.h"
 #include "GameplayScene/Player/Marisa.h"
 #include "GameplayScene/Player/Reimu.h"
@@ -14,6 +16,9 @@
 
 #include "GameData/GameData.h"
 
+// 角色碰到敌人本身时受到的伤害
+#define PLAYER_CONTACT_DAMAGE 10
+
 Player*
 Player::create(const std::string& tag)
 {
@@ -39,54 +44,11 @@ Player::create(const std::string& tag)
 void
 Player::changeAttackType(const std::string& startType)
 {
+    //弹幕参数见 gamedata/patterns.json
     if (startType == this->type1.tag) {
-        // this->emitter->playStyle(sc1);//传入弹幕参数
-
-        /*临时代码*/
-        StyleConfig sc1;
-        sc1.style = StyleType::PARABOLA;
-        sc1.frequency = 0.15f;
-        sc1.bulletDuration = 1.5;
-        sc1.number = 13;
-        sc1.countThenChangePos = 4;
-        sc1.cycleTimes = -1;
-        sc1.totalDuration = FLT_MAX;
-        sc1.height = 50;
-        sc1.distance = 345;
-        sc1.startAngle = -13;
-        sc1.endAngle = 53;
-        sc1.bc.name = "b3_1_3.png";
-        sc1.bc.length = 30;
-        sc1.bc.width = 30;
-        sc1.bc.harm = 5;
-        sc1.bc._categoryBitmask = bulletCategory;
-        sc1.bc._collisionBitmask = enemyCategory;
-        sc1.bc._contactTestBitmask = enemyCategory;
-        emitter->playStyle(sc1);
-        /*临时代码*/
+        emitter->playPattern("player_attack_1");
     } else {
-        // this->emitter->playStyle(sc2);//传入弹幕参数
-
-        /*临时代码*/
-        StyleConfig sc2;
-        sc2.style = StyleType::SCATTER;
-        sc2.frequency = 0.15f;
-        sc2.bulletDuration = 2;
-        sc2.number = 2;
-        sc2.countThenChangePos = 4;
-        sc2.cycleTimes = -1;
-        sc2.totalDuration = FLT_MAX;
-        sc2.startAngle = 269;
-        sc2.endAngle = 271;
-        sc2.deltaAngle = 0;
-        sc2.bc.name = "b1_3_3.png";
-        sc2.bc.length = 30;
-        sc2.bc.width = 30;
-        sc2.bc.harm = 5;
-        sc2.bc._categoryBitmask = bulletCategory;
-        sc2.bc._collisionBitmask = enemyCategory;
-        sc2.bc._contactTestBitmask = enemyCategory;
-        emitter->playStyle(sc2);
+        emitter->playPattern("player_attack_2");
     }
     this->currentAttackType = startType;
 }
@@ -352,7 +314,7 @@ Player::UseSpellCard::Enter(Player* player)
     portrait->scheduleOnce([portrait](float dt) { portrait->removeFromParent(); }, 1.5, "remove");
 
     std::function<void(Ref*)> shoot = [player](Ref*) {
-        player->emitter->playStyle(player->spellCardStyleConfig);
+        player->emitter->playPattern(player->spellCardPattern);
     };
 
     auto actionDone =
@@ -374,3 +336,36 @@ Player::UseSpellCard::defaultChangeState(Player* player)
 {
     player->stateMachine->changeState(Player::Stand::getInstance());
 }
+
+void
+Player::registerContacts(ContactDispatcher* contacts)
+{
+    //折线刚体可以从下方穿过，冲量方向向上时才站在上面
+    contacts->onBegin(playerCategory, groundCategory, [](const ContactPair& pair) {
+        if (pair.nodeB->getTag() != polylineCategoryTag) {
+            return true;
+        }
+        if (pair.contact.getContactData()->normal.y > 0) {
+            static_cast<Player*>(pair.nodeA)->resetJump();
+            return true;
+        }
+        return false;
+    });
+
+    //碰到敌人本身
+    contacts->onBegin(playerCategory, enemyCategory, [](const ContactPair& pair) {
+        DamageInfo damageInfo;
+        damageInfo.damage = PLAYER_CONTACT_DAMAGE;
+        damageInfo.target = pair.nodeA;
+        EventCustom event("bullet_hit_player");
+        event.setUserData((void*)&damageInfo);
+        Director::getInstance()->getEventDispatcher()->dispatchEvent(&event);
+        return true;
+    });
+
+    //碰到敌人的索敌框，索敌框是敌人刚体上种别为 lockCategory 的形状
+    contacts->onBegin(playerCategory, lockCategory, [](const ContactPair& pair) {
+        static_cast<Enemy*>(pair.nodeB)->stateMachine->autoChangeState();
+        return true;
+    });
+}
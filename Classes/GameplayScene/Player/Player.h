@@ -15,6 +15,7 @@
 
 #include "GameplayScene/State.h"
 
+class ContactDispatcher;
 class Emitter;
 class EventFilterManager;
 
@@ -46,6 +47,9 @@ public:
 
     virtual void getHit(DamageInfo*, EventFilterManager*);
 
+    //登记角色与地面、敌人、索敌框的接触处理
+    static void registerContacts(ContactDispatcher* contacts);
+
 public:
     std::string playerTag;
     Sprite* playerSprite;
@@ -56,7 +60,7 @@ public:
 
     //绑定发射器
     Emitter* emitter;
-    StyleConfig spellCardStyleConfig;
+    std::string spellCardPattern; //正在使用的符卡对应的弹幕模式
 
     //生命值
     int baseHP;
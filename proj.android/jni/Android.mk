@@ -43,6 +43,9 @@ endef
 LOCAL_SRC_FILES  := $(MY_SRC_LIST)
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes
 
+# 子弹内核与子弹场的求值不做乘加融合，NEON 与标量实现的结果才能逐位一致（见 BulletKernels.cpp）
+LOCAL_CFLAGS += -ffp-contract=off
+
 #################### CUSTOMIZATION END ####################
 
 # LOCAL_SRC_FILES := hellocpp/main.cpp \
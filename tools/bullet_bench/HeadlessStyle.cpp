@@ -0,0 +1,99 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "HeadlessStyle.h"
+
+float HeadlessStyle::areaWidth = 1280;
+float HeadlessStyle::areaHeight = 720;
+
+HeadlessStyle::HeadlessStyle(const StyleConfig& sc, float x, float y, bool player,
+                             uint64_t seed)
+    : sc(sc)
+    , x(x)
+    , y(y)
+    , player(player)
+    , started(false)
+    , targetX(0)
+    , targetY(0)
+    , despawn(VolleyRunner::defaultDespawn(sc))
+    , spawned(0)
+    , owner(nullptr)
+    , simulation(nullptr)
+    , rng(seed)
+{
+    traits.archetype = 0;
+    traits.ownerMask = player ? BENCH_PLAYER_CATEGORY : BENCH_ENEMY_CATEGORY;
+    //与 BulletLayer 相同取 sc.bc 的掩码；各类型的默认参数不含掩码，按发射方命中对方
+    traits.hitMask = sc.bc._contactTestBitmask;
+    if (traits.hitMask == 0) {
+        traits.hitMask = player ? BENCH_ENEMY_CATEGORY : BENCH_PLAYER_CATEGORY;
+    }
+    traits.radius = (sc.bc.length + sc.bc.width) / 4.0f;
+    traits.damage = sc.bc.harm;
+    traits.despawn = 0;
+    traits.priority = player ? BulletPriority::PLAYER : BulletPriority::AIMED;
+}
+
+void
+HeadlessStyle::update(float dt, BulletSimulation& simulation, float targetX, float targetY)
+{
+    this->simulation = &simulation;
+    this->targetX = targetX;
+    this->targetY = targetY;
+
+    // VolleyStyle::startShoot
+    if (!started) {
+        runner.start(sc, player, areaWidth, areaHeight, *this);
+        started = true;
+    }
+
+    // Laser::tick：先发射，再去掉已消散的光束；发射者不动，不需要更新起点
+    runner.step(dt, *this, rng);
+    for (auto it = beams.begin(); it != beams.end();) {
+        if (nullptr == simulation.getBeam(*it)) {
+            it = beams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+HeadlessStyle::getOrigin(float& x, float& y)
+{
+    x = this->x;
+    y = this->y;
+}
+
+void
+HeadlessStyle::getTarget(float& x, float& y)
+{
+    x = targetX;
+    y = targetY;
+}
+
+bool
+HeadlessStyle::isFacingLeft()
+{
+    return targetX < x;
+}
+
+// EmitterStyle::launchBullet
+void
+HeadlessStyle::fireBullet(const Trajectory& trajectory, float life, float scale, float offset)
+{
+    int index = simulation->addBullet(trajectory, life, traits, despawn, sc.bc.homing,
+                                      sc.bc.trail, owner, offset);
+    if (index >= 0) {
+        simulation->getField().scale[index] = scale;
+        spawned++;
+    }
+}
+
+void
+HeadlessStyle::fireBeam(const LaserBeam& beam)
+{
+    beams.push_back(simulation->addBeam(beam, traits, owner));
+    spawned++;
+}
@@ -0,0 +1,77 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef HEADLESS_STYLE_H
+#define HEADLESS_STYLE_H
+
+#include "BulletSimulation.h"
+#include "FastRandom.h"
+#include "LaserBeam.h"
+#include "VolleyRunner.h"
+
+#include <vector>
+
+/* 无窗口环境下的弹幕：与游戏中的 VolleyStyle 共用 VolleyRunner 的节拍与发射几何
+ *
+ *  + 游戏中的 Style 是 cocos2d 节点，依赖调度器与精灵，无法脱离 GL 环境运行；
+ *    这里只实现 VolleyHost 的回调，发射者位置固定，子弹直接写入 BulletSimulation
+ *  + 第一次 update 时开始发射，与 startShoot 相同在开始时取一次目标位置
+ *  + LASER 的光束与游戏中的 Laser 相同以 addBeam 登记到 BulletSimulation，命中随子弹命中一并取得
+ */
+
+// 种别掩码
+#define BENCH_PLAYER_CATEGORY 0x1
+#define BENCH_ENEMY_CATEGORY 0x2
+
+class HeadlessStyle : public VolleyHost
+{
+public:
+    /* 以 (x, y) 为发射者位置，player 为角色弹幕；seed 用于 PARABOLA 的随机参数 */
+    HeadlessStyle(const StyleConfig& sc, float x, float y, bool player, uint64_t seed);
+
+    /* 推进 dt 秒，到期的轮次写入 simulation；(targetX, targetY) 为自机狙的目标位置，
+     * 角色弹幕面朝目标所在的一侧 */
+    void update(float dt, BulletSimulation& simulation, float targetX, float targetY);
+
+    /* 累计发射的子弹数，激光每条计一次 */
+    int getSpawned() const { return spawned; }
+    /* 子弹与光束登记到的弹幕，默认为空；--churn 以此交还子弹与光束 */
+    void setOwner(StyleLifetime* owner) { this->owner = owner; }
+    /* 已达到 totalDuration 或 cycleTimes，不再发射；已有的光束仍继续推进 */
+    bool isStopped() const { return started && runner.isStopped(); }
+    /* 在场的光束数，上一次 update 时统计 */
+    int getBeamCount() const { return (int)beams.size(); }
+
+    /* VolleyRunner 的回调 */
+    virtual void getOrigin(float& x, float& y) override;
+    virtual void getTarget(float& x, float& y) override;
+    virtual bool isFacingLeft() override;
+    virtual void fireBullet(const Trajectory& trajectory, float life, float scale,
+                            float offset) override;
+    virtual void fireBeam(const LaserBeam& beam) override;
+
+    /* 区域大小，与设计分辨率一致 */
+    static float areaWidth;
+    static float areaHeight;
+
+private:
+    StyleConfig sc;
+    float x;
+    float y;
+    bool player;
+    bool started;
+    float targetX; //本次 update 的目标位置
+    float targetY;
+    BulletTraits traits;
+    DespawnPolicy despawn;
+    int spawned;
+    StyleLifetime* owner;
+
+    VolleyRunner runner;
+    BulletSimulation* simulation; //本次 update 写入的子弹模拟
+    std::vector<SlotHandle> beams; //模拟中的光束
+    FastRandom rng;
+};
+
+#endif // HEADLESS_STYLE_H
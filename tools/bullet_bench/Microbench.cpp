@@ -0,0 +1,769 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "Microbench.h"
+#include "BulletField.h"
+#include "BulletKernels.h"
+#include "BulletSimulation.h"
+#include "DirectionTable.h"
+#include "FastRandom.h"
+#include "HeadlessStyle.h"
+#include "SlotMap.h"
+#include "StyleLifetime.h"
+#include "TargetIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#define BENCH_KERNELS_MAX 8
+// 追踪弹的转向速率，240 度/秒
+#define HOMING_TURN_RATE 4.18879f
+
+// 切换测试中全部子弹到期的最长等待，超过时视为泄漏
+#define CHURN_DRAIN_SECONDS 30.0f
+
+// 累加结果防止被优化掉
+static volatile float sink;
+
+static double
+elapsedNs(std::chrono::steady_clock::time_point since)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - since)
+        .count();
+}
+
+void
+runKernelBench(int count, int repeat)
+{
+    std::minstd_rand rng(1);
+    std::uniform_real_distribution<float> coord(-200.0f, 1480.0f);
+    std::uniform_real_distribution<float> speed(-400.0f, 400.0f);
+
+    std::vector<float> posX(count), posY(count), originX(count), originY(count);
+    std::vector<float> velX(count), velY(count), age(count), rotation(count);
+    std::vector<float> startRotation(count), spin(count), radius(count, 7.5f);
+    std::vector<uint8_t> outside(count);
+    std::vector<int32_t> firstHit(count);
+    for (int i = 0; i < count; i++) {
+        originX[i] = posX[i] = coord(rng);
+        originY[i] = posY[i] = coord(rng) * 0.5f;
+        velX[i] = speed(rng);
+        velY[i] = speed(rng);
+        startRotation[i] = speed(rng);
+        spin[i] = speed(rng);
+    }
+    float boxes[8] = { 300, 300, 330, 340, 900, 200, 940, 240 };
+
+    const BulletKernels* kernels[BENCH_KERNELS_MAX];
+    int n = getAvailableBulletKernels(kernels, BENCH_KERNELS_MAX);
+
+    printf("kernels: %d bullets x %d\n", count, repeat);
+    printf("  %-8s %12s %12s %12s %12s\n", "kernel", "advance", "integrate", "cullOutside",
+           "overlapBoxes");
+    for (int k = 0; k < n; k++) {
+        const BulletKernels& kn = *kernels[k];
+        double perBullet = (double)count * repeat;
+        std::fill(age.begin(), age.end(), 0.0f);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            kn.advance(age.data(), rotation.data(), startRotation.data(), spin.data(), count,
+                       1.0f / 60);
+        }
+        double advanceNs = elapsedNs(start) / perBullet;
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            kn.integrate(posX.data(), posY.data(), originX.data(), originY.data(), velX.data(),
+                         velY.data(), age.data(), count);
+        }
+        double integrateNs = elapsedNs(start) / perBullet;
+
+        int culled = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            culled += kn.cullOutside(posX.data(), posY.data(), count, 0, 0, 1280, 720,
+                                     outside.data());
+        }
+        double cullNs = elapsedNs(start) / perBullet;
+
+        int hit = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            hit += kn.overlapBoxes(posX.data(), posY.data(), radius.data(), count, boxes, 2,
+                                   firstHit.data());
+        }
+        double overlapNs = elapsedNs(start) / perBullet;
+
+        sink = sink + posX[count / 2] + rotation[count / 2] + (float)(culled + hit);
+        printf("  %-8s %9.3f ns %9.3f ns %9.3f ns %9.3f ns\n", kn.name, advanceNs, integrateNs,
+               cullNs, overlapNs);
+    }
+}
+
+void
+runRingBench(int count, int repeat)
+{
+    float turn = 2 * 3.14159265358979323846f;
+    float step = turn / count;
+    float rotate = 0.0872665f; //每圈转 5 度
+    std::vector<float> velX(count), velY(count);
+
+    //原先的写法：每颗子弹各求一次 cos、sin
+    float angle = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        angle = fmodf(angle + rotate, turn);
+        for (int i = 0; i < count; i++) {
+            velX[i] = 300.0f * cosf(angle + i * step);
+            velY[i] = 300.0f * sinf(angle + i * step);
+        }
+        sink = sink + velX[r % count];
+    }
+    double trigNs = elapsedNs(start) / repeat;
+
+    //方向表：每圈整体旋转一次
+    DirectionTable fan, directions;
+    fan.build(count, 0, step);
+    angle = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        angle = fmodf(angle + rotate, turn);
+        fan.rotate(angle, directions);
+        for (int i = 0; i < count; i++) {
+            velX[i] = 300.0f * directions.getX(i);
+            velY[i] = 300.0f * directions.getY(i);
+        }
+        sink = sink + velX[r % count];
+    }
+    double tableNs = elapsedNs(start) / repeat;
+
+    printf("ring %4d: trig %9.1f ns/volley, table %9.1f ns/volley, %.1fx\n", count, trigNs,
+           tableNs, tableNs > 0 ? trigNs / tableNs : 0.0);
+}
+
+/* 代替 cocos2d::Ref 的引用计数 */
+struct BenchRef
+{
+    int refs;
+    SlotHandle slot;
+};
+
+void
+runSlotBench(int count, int repeat)
+{
+    std::vector<BenchRef> objects(count);
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++) {
+        objects[i].refs = 1;
+        order[i] = i;
+    }
+    //子弹因出界、命中、到期而回收，顺序与发射顺序无关
+    std::shuffle(order.begin(), order.end(), std::minstd_rand(1));
+
+    //原先的写法：cocos2d::Vector 的 pushBack 与 eraseObject，查找、移动并增减引用
+    std::vector<BenchRef*> vector;
+    vector.reserve(count);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < count; i++) {
+            objects[i].refs++;
+            vector.push_back(&objects[i]);
+        }
+        for (auto object : vector) {
+            sink = sink + (float)object->refs;
+        }
+        for (int i : order) {
+            auto it = std::find(vector.begin(), vector.end(), &objects[i]);
+            if (it != vector.end()) {
+                (*it)->refs--;
+                vector.erase(it);
+            }
+        }
+    }
+    double vectorNs = elapsedNs(start) / ((double)count * repeat);
+
+    //槽位表：句柄记在对象上，删除时以末尾元素填补
+    SlotMap<BenchRef*> slots;
+    slots.reserve(count);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < count; i++) {
+            objects[i].refs++;
+            objects[i].slot = slots.insert(&objects[i]);
+        }
+        for (auto object : slots) {
+            sink = sink + (float)object->refs;
+        }
+        for (int i : order) {
+            if (slots.erase(objects[i].slot)) {
+                objects[i].refs--;
+            }
+        }
+    }
+    double slotNs = elapsedNs(start) / ((double)count * repeat);
+
+    printf("bullets %5d: vector %9.1f ns/bullet, slot map %9.1f ns/bullet, %.1fx\n", count,
+           vectorNs, slotNs, slotNs > 0 ? vectorNs / slotNs : 0.0);
+}
+
+static void
+fillField(BulletField& field, int count, std::minstd_rand& rng)
+{
+    std::uniform_real_distribution<float> coord(0.0f, 1280.0f);
+    std::uniform_real_distribution<float> speed(-300.0f, 300.0f);
+
+    BulletTraits traits;
+    traits.archetype = 0;
+    traits.ownerMask = 0x2;
+    traits.hitMask = 0x1;
+    traits.radius = 7.5f;
+    traits.damage = 10;
+    traits.despawn = 0;
+    traits.priority = BulletPriority::AIMED;
+    for (int i = 0; i < count; i++) {
+        auto trajectory =
+            Trajectory::linear(coord(rng), coord(rng) * 0.5f, speed(rng), speed(rng));
+        field.spawn(trajectory, 6.0f, traits, nullptr, 0);
+    }
+}
+
+/* 整条回收路径中的弹幕：登记在场子弹，从不停止发射 */
+struct DespawnOwner : public StyleLifetime
+{
+    virtual void releaseStyle() override {}
+};
+
+void
+runDespawnBench(int count, int repeat)
+{
+    //每帧回收约八分之一，下标乱序抽取；两种写法的随机数序列与子弹场的变化完全相同
+    const int frames = 8;
+    const int perFrame = count / frames;
+    std::minstd_rand rng(1);
+    std::vector<BulletField::Released> released;
+
+    //原先的写法：子弹是精灵，发射时 addChild 到子弹层并登记到弹幕的槽位表，子弹场的 view
+    //随条目移动；回收时 removeFromParent 在 _children 中查找并删除，再交还弹幕，各自增减引用
+    std::vector<BenchRef> objects(count);
+    std::vector<BenchRef*> children;
+    std::vector<BenchRef*> views;
+    std::vector<BenchRef*> releasedViews;
+    SlotMap<BenchRef*> styleBullets;
+    children.reserve(count);
+    views.reserve(count);
+    styleBullets.reserve(count);
+    BulletField nodeField;
+    nodeField.reserve(count);
+    double nodeNs = 0;
+    for (int r = 0; r < repeat; r++) {
+        rng.seed(r + 1);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            auto object = &objects[i];
+            object->refs = 1;
+            object->refs++;
+            children.push_back(object);
+            object->refs++;
+            object->slot = styleBullets.insert(object);
+            views.push_back(object);
+            nodeField.spawn(Trajectory::linear(0, 0, 1, 1), 6.0f, BulletTraits(), nullptr, 0);
+        }
+        for (int f = 0; f < frames; f++) {
+            for (int k = 0; k < perFrame && nodeField.size() > 0; k++) {
+                nodeField.kill((int)(rng() % nodeField.size()));
+            }
+            //子弹场的 view 列与其它列一起以末尾填补
+            releasedViews.clear();
+            int n = (int)views.size();
+            for (int i = 0; i < n;) {
+                if (nodeField.isDead(i)) {
+                    releasedViews.push_back(views[i]);
+                    views[i] = views[--n];
+                    views.pop_back();
+                } else {
+                    i++;
+                }
+            }
+            released.clear();
+            nodeField.removeDead(released);
+            for (auto object : releasedViews) {
+                auto it = std::find(children.begin(), children.end(), object);
+                children.erase(it);
+                object->refs--;
+                styleBullets.erase(object->slot);
+                object->refs--;
+            }
+        }
+        nodeNs += elapsedNs(start);
+        released.clear();
+        nodeField.clear(released);
+        children.clear();
+        views.clear();
+        styleBullets.clear();
+    }
+
+    //现在的写法：子弹场记下发射方与句柄，回收时只交还句柄
+    DespawnOwner owner;
+    BulletField field;
+    field.reserve(count);
+    double fieldNs = 0;
+    for (int r = 0; r < repeat; r++) {
+        rng.seed(r + 1);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            field.spawn(Trajectory::linear(0, 0, 1, 1), 6.0f, BulletTraits(), &owner, 0);
+        }
+        for (int f = 0; f < frames; f++) {
+            for (int k = 0; k < perFrame && field.size() > 0; k++) {
+                field.kill((int)(rng() % field.size()));
+            }
+            released.clear();
+            field.removeDead(released);
+            for (auto& entry : released) {
+                entry.owner->releaseBullet(entry.slot);
+            }
+        }
+        fieldNs += elapsedNs(start);
+        released.clear();
+        field.clear(released);
+        for (auto& entry : released) {
+            entry.owner->releaseBullet(entry.slot);
+        }
+    }
+
+    double perBullet = (double)count * repeat;
+    printf("despawn %5d: scene graph %9.1f ns/bullet, field %9.1f ns/bullet, %.1fx\n", count,
+           nodeNs / perBullet, fieldNs / perBullet, fieldNs > 0 ? nodeNs / fieldNs : 0.0);
+}
+
+void
+runCancelBench(int count, int repeat)
+{
+    std::minstd_rand rng(1);
+    std::vector<BulletField::Released> released;
+    BulletField field;
+    field.reserve(count * 2);
+
+    BulletTraits pickup;
+    pickup.archetype = 0;
+    pickup.ownerMask = 0;
+    pickup.hitMask = 0x1;
+    pickup.radius = 12.0f;
+    pickup.damage = 1;
+    pickup.despawn = 0;
+    pickup.priority = BulletPriority::PLAYER;
+
+    //原先的写法：逐颗移除子弹，再在原位置生成拾取物
+    double removeNs = 0;
+    for (int r = 0; r < repeat; r++) {
+        field.clear(released);
+        fillField(field, count, rng);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            float x = field.posX[i];
+            float y = field.posY[i];
+            field.kill(i);
+            field.spawn(Trajectory::integrated(x, y, 0, 120.0f), 8.0f, pickup, nullptr, 0);
+        }
+        field.removeDead(released);
+        removeNs += elapsedNs(start);
+        sink = sink + field.posX[count / 2];
+    }
+
+    //就地改写：下标不变，无需整理数组
+    double respawnNs = 0;
+    for (int r = 0; r < repeat; r++) {
+        field.clear(released);
+        fillField(field, count, rng);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            auto trajectory = Trajectory::integrated(field.posX[i], field.posY[i], 0, 120.0f);
+            field.respawn(i, trajectory, 8.0f, pickup, BulletField::FLAG_PICKUP);
+        }
+        respawnNs += elapsedNs(start);
+        sink = sink + field.posX[count / 2];
+    }
+
+    printf("cancel %5d: remove+spawn %9.1f us, respawn %9.1f us, %.1fx\n", count,
+           removeNs / repeat / 1000, respawnNs / repeat / 1000,
+           respawnNs > 0 ? removeNs / respawnNs : 0.0);
+}
+
+/* 追踪弹基准的一帧：敌人移动、追踪弹转向、推进，到期或出界的子弹从自机位置重发 */
+struct HomingScene
+{
+    BulletField field;
+    std::vector<float> enemyX;
+    std::vector<float> enemyY;
+    std::vector<float> phase;
+    std::minstd_rand rng;
+    TargetIndex index;
+    std::vector<int> nearest;
+
+    HomingScene(int bullets, int enemies)
+        : rng(1)
+    {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int e = 0; e < enemies; e++) {
+            enemyX.push_back(640.0f + 600.0f * unit(rng));
+            enemyY.push_back(40.0f + 640.0f * unit(rng));
+            phase.push_back(6.28f * unit(rng));
+        }
+        index.setBounds(0, 0, 1280, 720, 128);
+
+        field.reserve(bullets);
+        for (int i = 0; i < bullets; i++) {
+            //错开发射时刻，稳定后每帧都有子弹到期重发
+            field.spawn(launch(), 3.0f, traits(), nullptr, 3.0f * i / bullets);
+            field.setHoming(i, HOMING_TURN_RATE);
+        }
+    }
+
+    static BulletTraits traits()
+    {
+        BulletTraits traits;
+        traits.archetype = 0;
+        traits.ownerMask = 0x1;
+        traits.hitMask = 0x2;
+        traits.radius = 7.5f;
+        traits.damage = 5;
+        traits.despawn = 0;
+        traits.priority = BulletPriority::AIMED;
+        return traits;
+    }
+
+    Trajectory launch()
+    {
+        std::uniform_real_distribution<float> spread(-0.6f, 0.6f);
+        float angle = spread(rng);
+        return Trajectory::integrated(100.0f, 360.0f, 700.0f * cosf(angle), 700.0f * sinf(angle));
+    }
+
+    void moveEnemies(float time)
+    {
+        for (int e = 0; e < (int)enemyX.size(); e++) {
+            enemyY[e] += 2.0f * sinf(time + phase[e]);
+        }
+    }
+
+    /* 求出各子弹的最近敌人，存入 nearest */
+    void search(bool useIndex)
+    {
+        nearest.resize(field.size());
+        if (useIndex) {
+            index.clear();
+            for (int e = 0; e < (int)enemyX.size(); e++) {
+                index.add(enemyX[e], enemyY[e], 0x2);
+            }
+            //每颗子弹登记一次查找，编号即子弹下标
+            for (int i = 0; i < field.size(); i++) {
+                index.mark(field.posX[i], field.posY[i], field.hitMask[i]);
+            }
+            index.build();
+            for (int i = 0; i < field.size(); i++) {
+                nearest[i] = index.getNearest(i);
+            }
+            return;
+        }
+
+        //原先的写法：每颗子弹遍历全部敌人
+        for (int i = 0; i < field.size(); i++) {
+            float x = field.posX[i];
+            float y = field.posY[i];
+            int t = -1;
+            float best = 0;
+            for (int e = 0; e < (int)enemyX.size(); e++) {
+                float dx = enemyX[e] - x;
+                float dy = enemyY[e] - y;
+                float d = dx * dx + dy * dy;
+                if (t < 0 || d < best) {
+                    t = e;
+                    best = d;
+                }
+            }
+            nearest[i] = t;
+        }
+    }
+
+    void steer(float dt)
+    {
+        float cosTurn, sinTurn;
+        BulletField::getTurn(HOMING_TURN_RATE, dt, cosTurn, sinTurn);
+        for (int i = 0; i < field.size(); i++) {
+            int t = nearest[i];
+            if (t >= 0) {
+                field.steerToward(i, enemyX[t], enemyY[t], cosTurn, sinTurn);
+            }
+        }
+    }
+
+    void respawnExpired()
+    {
+        //与游戏中的区域回收规则相同，离开区域的子弹也重发
+        for (int i = 0; i < field.size(); i++) {
+            if (field.isDead(i) || field.posX[i] < 0 || field.posX[i] >= 1280 ||
+                field.posY[i] < 0 || field.posY[i] >= 720) {
+                field.respawn(i, launch(), 3.0f, traits(), 0);
+                field.setHoming(i, HOMING_TURN_RATE);
+            }
+        }
+    }
+};
+
+bool
+runHomingBench(int bullets, int enemies, int ticks)
+{
+    float dt = 1.0f / 60;
+    double searchNs[2] = { 0, 0 };
+    double totalNs[2] = { 0, 0 };
+    float checksum[2] = { 0, 0 };
+
+    for (int mode = 0; mode < 2; mode++) {
+        HomingScene scene(bullets, enemies);
+        for (int t = 0; t < ticks; t++) {
+            scene.moveEnemies(t * dt);
+            auto start = std::chrono::steady_clock::now();
+            scene.search(mode == 1);
+            searchNs[mode] += elapsedNs(start);
+            scene.steer(dt);
+            scene.field.update(dt);
+            scene.respawnExpired();
+            totalNs[mode] += elapsedNs(start);
+        }
+        for (int i = 0; i < scene.field.size(); i++) {
+            checksum[mode] += scene.field.posX[i] + scene.field.posY[i];
+        }
+    }
+
+    bool match = checksum[0] == checksum[1];
+    printf("homing %d bullets, %d enemies: scan %8.1f us/tick, index %8.1f us/tick (%.1fx), "
+           "frame %8.1f us -> %8.1f us, %s\n",
+           bullets, enemies, searchNs[0] / ticks / 1000, searchNs[1] / ticks / 1000,
+           searchNs[1] > 0 ? searchNs[0] / searchNs[1] : 0.0, totalNs[0] / ticks / 1000,
+           totalNs[1] / ticks / 1000, match ? "same result" : "RESULT MISMATCH");
+    return match;
+}
+
+bool
+runTrailBench(int count, int trailed, int ticks)
+{
+    float dt = 1.0f / 60;
+    double updateNs[2] = { 0, 0 };
+    bool valid = true;
+
+    for (int mode = 0; mode < 2; mode++) {
+        std::minstd_rand rng(1);
+        BulletField field;
+        field.reserve(count);
+        fillField(field, count, rng);
+        if (mode == 1) {
+            for (int i = 0; i < trailed; i++) {
+                field.setTrail(i * count / trailed);
+            }
+        }
+
+        for (int t = 0; t < ticks; t++) {
+            auto start = std::chrono::steady_clock::now();
+            field.update(dt);
+            updateNs[mode] += elapsedNs(start);
+        }
+        sink = sink + field.posX[count / 2];
+
+        //直线子弹第 k 个历史位置应为 k 帧之前的位置
+        for (int i = 0; mode == 1 && i < count; i++) {
+            for (int k = 0; k < field.getTrailLength(i); k++) {
+                float x, y;
+                field.getTrailPoint(i, k, x, y);
+                float age = (ticks - k) * dt;
+                float ex = field.originX[i] + field.velX[i] * age;
+                float ey = field.originY[i] + field.velY[i] * age;
+                if (fabsf(x - ex) > 0.01f || fabsf(y - ey) > 0.01f) {
+                    valid = false;
+                }
+            }
+        }
+        if (mode == 1 && field.getTrailCount() != trailed) {
+            valid = false;
+        }
+    }
+
+    double extraNs = updateNs[1] - updateNs[0];
+    printf("trails %5d/%5d: update %8.1f us/tick -> %8.1f us/tick (%.1f ns/trail), %s\n",
+           trailed, count, updateNs[0] / ticks / 1000, updateNs[1] / ticks / 1000,
+           trailed > 0 ? extraNs / ticks / trailed : 0.0,
+           valid ? "history ok" : "HISTORY MISMATCH");
+    return valid;
+}
+
+/* 切换测试中的一个弹幕：与 EmitterStyle 相同以 StyleLifetime 为基类，HeadlessStyle 发射的子弹与
+ * 光束登记到这里，由 BulletSimulation 在离场时交还；释放时直接删除，并记下释放时是否确实已停止、
+ * 没有在场的子弹与光束 */
+static int churnReleases = 0;
+static int churnEarlyReleases = 0;
+
+struct ChurnStyle : public StyleLifetime
+{
+    ChurnStyle(const StyleConfig& sc, float x, float y, bool player, uint64_t seed)
+        : style(sc, x, y, player, seed)
+    {
+        style.setOwner(this);
+    }
+
+    virtual void releaseStyle() override
+    {
+        churnReleases++;
+        if (!isRetired() || inFlight() != 0) {
+            churnEarlyReleases++;
+        }
+        delete this;
+    }
+
+    HeadlessStyle style;
+};
+
+static void
+tickChurn(std::vector<ChurnStyle*>& active, BulletSimulation& simulation, float dt)
+{
+    for (auto s : active) {
+        s->style.update(dt, simulation, 640, 200);
+    }
+    simulation.update(dt);
+    simulation.removeDead();
+}
+
+/* 模拟中是否还有子弹或光束登记在 owner 下 */
+static bool
+isOwnerOf(const BulletSimulation& simulation, const StyleLifetime* owner)
+{
+    const BulletField& field = simulation.getField();
+    for (int i = 0; i < field.size(); i++) {
+        if (field.owner[i] == owner) {
+            return true;
+        }
+    }
+    for (auto& b : simulation.getBeams()) {
+        if (b.owner == owner) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+runChurnCheck(int switches, int ticks)
+{
+    const StyleType types[] = { StyleType::ODDEVEN, StyleType::PARABOLA, StyleType::PARALLEL,
+                                StyleType::SCATTER, StyleType::LASER };
+    const int typeCount = sizeof(types) / sizeof(types[0]);
+    const float dt = 1.0f / 60;
+
+    BulletSimulation simulation;
+    simulation.setArea(0, 0, HeadlessStyle::areaWidth, HeadlessStyle::areaHeight);
+    const BulletField& field = simulation.getField();
+    std::vector<ChurnStyle*> active;
+    int start = StyleLifetime::getLiveCount();
+    int peak = 0;
+    int created = 0;
+    int destroyed = 0; //随角色销毁、未经 retire 的弹幕
+    int missed = 0;    //停止时没有在场的子弹与光束却未立即释放，或仍有却被释放
+    int dangling = 0;  //销毁后模拟中仍登记着它的子弹或光束
+    long long spawned = 0;
+    churnReleases = 0;
+    churnEarlyReleases = 0;
+    FastRandom::beginRound(1);
+
+    for (int k = 0; k < switches; k++) {
+        //每 10 次有一次角色被移除，其中一个弹幕不经停止直接随之销毁，两个弹幕轮流
+        if (k % 10 == 9 && !active.empty()) {
+            auto it = active.begin() + (k / 10) % active.size();
+            ChurnStyle* removed = *it;
+            spawned += removed->style.getSpawned();
+            delete removed;
+            if (isOwnerOf(simulation, removed)) {
+                dangling++;
+            }
+            destroyed++;
+            active.erase(it);
+        }
+
+        // Emitter::stopAllStyle
+        for (auto s : active) {
+            spawned += s->style.getSpawned();
+            bool idle = s->inFlight() == 0;
+            int released = churnReleases;
+            s->retire();
+            if (idle != (churnReleases > released)) {
+                missed++;
+            }
+        }
+        active.clear();
+
+        // Emitter::playStyle，每种攻击方式两个弹幕
+        for (int i = 0; i < 2; i++) {
+            StyleType type = types[(k + i) % typeCount];
+            bool player = type == StyleType::PARABOLA;
+            StyleConfig sc = VolleyRunner::defaultConfig(type, player);
+            if (type == StyleType::LASER) {
+                sc.frequency = ticks * dt / 3; //默认 3 秒一轮，缩短到切换之前能射出几条
+            }
+            active.push_back(new ChurnStyle(sc, 640, 500, player, FastRandom::nextStreamSeed()));
+            created++;
+        }
+        for (int t = 0; t < ticks; t++) {
+            tickChurn(active, simulation, dt);
+            peak = std::max(peak, StyleLifetime::getLiveCount() - start);
+        }
+    }
+
+    for (auto s : active) {
+        spawned += s->style.getSpawned();
+        s->retire();
+    }
+    active.clear();
+    int drainTicks = 0;
+    while ((field.size() > 0 || !simulation.getBeams().empty()) &&
+           drainTicks * dt < CHURN_DRAIN_SECONDS) {
+        tickChurn(active, simulation, dt);
+        drainTicks++;
+    }
+
+    int live = StyleLifetime::getLiveCount() - start;
+    printf("churn: %d switches x %d ticks, %lld bullets and beams\n", switches, ticks, spawned);
+    printf("  peak live styles:     %d\n", peak);
+    printf("  released:             %d of %d (%d destroyed with their character)\n",
+           churnReleases, created, destroyed);
+    printf("  live after drain:     %d (%d bullets, %d beams left after %.1f s)\n", live,
+           field.size(), (int)simulation.getBeams().size(), drainTicks * dt);
+    bool ok = true;
+    if (live != 0) {
+        fprintf(stderr, "%d styles still alive after every bullet expired\n", live);
+        ok = false;
+    }
+    if (churnReleases + destroyed != created) {
+        fprintf(stderr, "%d styles released, %d expected\n", churnReleases, created - destroyed);
+        ok = false;
+    }
+    if (churnEarlyReleases != 0) {
+        fprintf(stderr, "%d styles released while running or with bullets in flight\n",
+                churnEarlyReleases);
+        ok = false;
+    }
+    if (missed != 0) {
+        fprintf(stderr, "%d styles released at the wrong time on retire\n", missed);
+        ok = false;
+    }
+    if (dangling != 0) {
+        fprintf(stderr, "%d destroyed styles still own bullets or beams\n", dangling);
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,39 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+/* 子弹场内核与方向表的微基准，结果直接打印 */
+
+/* 逐个测量已编译进来的内核（标量、SSE2、AVX2、NEON），count 为子弹数 */
+void runKernelBench(int count, int repeat);
+
+/* 比较环形弹逐颗求三角函数与旋转方向表的开销，count 为每圈的子弹数 */
+void runRingBench(int count, int repeat);
+
+/* 比较弹幕以 Vector 与槽位表登记子弹的开销：登记 count 颗、遍历一次、按乱序逐颗删除 */
+void runSlotBench(int count, int repeat);
+
+/* 比较子弹离场的整条路径：子弹是子弹层下的精灵时（addChild，回收时在 _children 中查找删除，
+ * 并从弹幕的槽位表删除）与子弹场记下发射方句柄时的开销；count 颗全部发射后分 8 帧乱序回收 */
+void runDespawnBench(int count, int repeat);
+
+/* 比较清屏时逐颗移除再生成拾取物与 BulletField::respawn 就地改写的开销，count 为在场子弹数 */
+void runCancelBench(int count, int repeat);
+
+/* 比较追踪弹逐颗遍历所有敌人与经 TargetIndex 查找最近目标的开销，子弹到期后原地重发，
+ * 保持 bullets 颗在场；返回两种写法的结果是否一致 */
+bool runHomingBench(int bullets, int enemies, int ticks);
+
+/* 比较子弹场不带拖尾与 trailed 颗带拖尾时每帧推进的开销，并检查拖尾记录的位置是否为
+ * 前几帧的位置；返回检查是否通过 */
+bool runTrailBench(int count, int trailed, int ticks);
+
+/* 模拟切换攻击方式 switches 次，每次停止当前的弹幕并新建两个，每种攻击方式（含 LASER）发射
+ * ticks 帧，每 10 次有一个弹幕不经停止直接销毁。子弹与光束经 BulletSimulation 交还，停止的弹幕
+ * 在最后一颗子弹或光束离场时释放。返回释放时机、销毁后的登记与 StyleLifetime 的存活数是否正确 */
+bool runChurnCheck(int switches, int ticks);
+
+#endif // MICROBENCH_H
@@ -0,0 +1,719 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* 无窗口的弹幕压力基准
+ *
+ *  + 每种 StyleType 创建 N 个发射器，以固定步长推进 M 秒；发射几何由 VolleyRunner 求出，
+ *    每步由 BulletLayer 使用的 BulletSimulation 推进子弹场、出界回收、网格 + 内核命中检测、
+ *    移除死亡子弹，与游戏中是同一份代码
+ *  + 不依赖 cocos2d 与 GL，可在 Linux CI 上直接运行；--max-ns 超出时返回非 0
+ *  + 推进、出界与命中查询经由 JobSystem 并行；--scaling 以不同线程数重复同一场模拟，
+ *    比较耗时并校验最终状态一致
+ *  + 用法见 --help
+ */
+
+#include "BulletSimulation.h"
+#include "HeadlessStyle.h"
+#include "JobSystem.h"
+#include "Microbench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/* 统计分配次数：替换全局 operator new、delete
+ *
+ *  + 普通、数组、nothrow 与带大小的各形式一并替换，全部经 countedAlloc、countedFree 落到
+ *    malloc、free，任一形式分配的内存由任一形式释放都一致，不会与标准库的实现混用
+ *  + 只计次数，不记大小 */
+
+static std::atomic<long long> allocations(0);
+
+static void*
+countedAlloc(std::size_t size)
+{
+    allocations++;
+    return malloc(size ? size : 1);
+}
+
+static void
+countedFree(void* p)
+{
+    free(p);
+}
+
+void*
+operator new(std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (nullptr == p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (nullptr == p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    countedFree(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    countedFree(p);
+}
+
+void
+operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    countedFree(p);
+}
+
+void
+operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    countedFree(p);
+}
+
+#if defined(__cpp_sized_deallocation) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    countedFree(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    countedFree(p);
+}
+#endif
+
+/* 进程峰值常驻内存，单位 KB */
+static long
+peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return (long)(pmc.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+struct BenchOptions
+{
+    int emitters;
+    float seconds;
+    float warmup;
+    float dt;
+    float maxNs; //每颗子弹每步的耗时上限，0 为不检查
+    std::vector<StyleType> styles;
+    StyleConfig overrides; //只覆盖下面 has 标记的字段
+    bool hasNumber, hasFrequency, hasBulletDuration, hasCountThenChangePos;
+    bool hasStartAngle, hasEndAngle, hasDeltaAngle, hasHeight, hasDistance;
+    bool kernels;
+    bool rings;
+    bool slots;
+    bool despawn;
+    bool cancel;
+    bool homing;
+    bool trails;
+    bool churn;
+    int threads; //工作线程数，-1 为 JobSystem 的默认值
+    bool scaling;
+    uint64_t seed; //本局种子，与 FastRandom::beginRound 相同
+};
+
+static const char*
+styleName(StyleType style)
+{
+    switch (style) {
+        case StyleType::LASER:
+            return "LASER";
+        case StyleType::ODDEVEN:
+            return "ODDEVEN";
+        case StyleType::PARABOLA:
+            return "PARABOLA";
+        case StyleType::PARALLEL:
+            return "PARALLEL";
+        case StyleType::SCATTER:
+            return "SCATTER";
+    }
+    return "?";
+}
+
+static bool
+parseStyles(const std::string& list, std::vector<StyleType>& styles)
+{
+    const StyleType all[] = { StyleType::LASER, StyleType::ODDEVEN, StyleType::PARABOLA,
+                              StyleType::PARALLEL, StyleType::SCATTER };
+    styles.clear();
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string name = list.substr(begin, end - begin);
+        bool found = false;
+        for (auto style : all) {
+            if (name == styleName(style)) {
+                styles.push_back(style);
+                found = true;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "unknown style %s\n", name.c_str());
+            return false;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+static void
+printUsage()
+{
+    printf("usage: bullet_bench [options]\n"
+           "  --emitters N          emitters per style (4)\n"
+           "  --seconds M           simulated seconds (20)\n"
+           "  --warmup S            seconds excluded from the measurement (2)\n"
+           "  --dt T                fixed step (1/60)\n"
+           "  --styles A,B          LASER,ODDEVEN,PARABOLA,PARALLEL,SCATTER (all)\n"
+           "  --number N  --frequency F  --bullet-duration D  --count-then-change N\n"
+           "  --start-angle A  --end-angle A  --delta-angle A  --height H  --distance D\n"
+           "                        override the StyleConfig defaults of every style\n"
+           "  --max-ns X            exit with 1 when ns/bullet/update exceeds X\n"
+           "  --seed S              round seed, runs with the same seed are identical (1)\n"
+           "  --threads N           job system worker threads, 0 runs on the main thread only\n"
+           "                        (cores - 1)\n"
+           "  --scaling             repeat the run with 0..N worker threads and compare results\n"
+           "  --kernels             run the bullet kernel microbenchmarks\n"
+           "  --rings               run the 64/128-way ring trig vs direction table benchmark\n"
+           "  --slots               run the style bullet Vector vs slot map benchmark\n"
+           "  --despawn             run the scene graph vs field despawn path benchmark\n"
+           "  --cancel              run the screen-clear remove+spawn vs in-place respawn benchmark\n"
+           "  --homing              run the homing nearest-enemy scan vs target index benchmark\n"
+           "  --trails              run the trail history ring buffer benchmark\n"
+           "  --churn               switch attack types 1000 times and check that stopped\n"
+           "                        styles are released once their bullets and beams are gone\n");
+}
+
+static bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    options.emitters = 4;
+    options.seconds = 20;
+    options.warmup = 2;
+    options.dt = 1.0f / 60;
+    options.maxNs = 0;
+    parseStyles("LASER,ODDEVEN,PARABOLA,PARALLEL,SCATTER", options.styles);
+    options.overrides = StyleConfig();
+    options.hasNumber = options.hasFrequency = options.hasBulletDuration = false;
+    options.hasCountThenChangePos = options.hasStartAngle = options.hasEndAngle = false;
+    options.hasDeltaAngle = options.hasHeight = options.hasDistance = false;
+    options.kernels = false;
+    options.rings = false;
+    options.slots = false;
+    options.despawn = false;
+    options.cancel = false;
+    options.homing = false;
+    options.trails = false;
+    options.churn = false;
+    options.threads = -1;
+    options.seed = 1;
+    options.scaling = false;
+
+    StyleConfig& sc = options.overrides;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        } else if (arg == "--kernels") {
+            options.kernels = true;
+            continue;
+        } else if (arg == "--rings") {
+            options.rings = true;
+            continue;
+        } else if (arg == "--slots") {
+            options.slots = true;
+            continue;
+        } else if (arg == "--despawn") {
+            options.despawn = true;
+            continue;
+        } else if (arg == "--cancel") {
+            options.cancel = true;
+            continue;
+        } else if (arg == "--homing") {
+            options.homing = true;
+            continue;
+        } else if (arg == "--trails") {
+            options.trails = true;
+            continue;
+        } else if (arg == "--churn") {
+            options.churn = true;
+            continue;
+        } else if (arg == "--scaling") {
+            options.scaling = true;
+            continue;
+        }
+
+        if (nullptr == value) {
+            fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--emitters") {
+            options.emitters = atoi(value);
+        } else if (arg == "--seconds") {
+            options.seconds = (float)atof(value);
+        } else if (arg == "--warmup") {
+            options.warmup = (float)atof(value);
+        } else if (arg == "--dt") {
+            options.dt = (float)atof(value);
+        } else if (arg == "--max-ns") {
+            options.maxNs = (float)atof(value);
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = atoi(value);
+        } else if (arg == "--styles") {
+            if (!parseStyles(value, options.styles)) {
+                return false;
+            }
+        } else if (arg == "--number") {
+            sc.number = (unsigned int)atoi(value);
+            options.hasNumber = true;
+        } else if (arg == "--frequency") {
+            sc.frequency = (float)atof(value);
+            options.hasFrequency = true;
+        } else if (arg == "--bullet-duration") {
+            sc.bulletDuration = (float)atof(value);
+            options.hasBulletDuration = true;
+        } else if (arg == "--count-then-change") {
+            sc.countThenChangePos = (unsigned int)atoi(value);
+            options.hasCountThenChangePos = true;
+        } else if (arg == "--start-angle") {
+            sc.startAngle = atoi(value);
+            options.hasStartAngle = true;
+        } else if (arg == "--end-angle") {
+            sc.endAngle = atoi(value);
+            options.hasEndAngle = true;
+        } else if (arg == "--delta-angle") {
+            sc.deltaAngle = atoi(value);
+            options.hasDeltaAngle = true;
+        } else if (arg == "--height") {
+            sc.height = atoi(value);
+            options.hasHeight = true;
+        } else if (arg == "--distance") {
+            sc.distance = atoi(value);
+            options.hasDistance = true;
+        } else {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.emitters < 0 || options.dt <= 0 || options.seconds <= options.warmup) {
+        fprintf(stderr, "need emitters >= 0, dt > 0 and seconds > warmup\n");
+        return false;
+    }
+    if (options.threads < -1) {
+        fprintf(stderr, "threads must not be negative\n");
+        return false;
+    }
+    if (options.hasNumber && sc.number == 0) {
+        fprintf(stderr, "number must be positive\n");
+        return false;
+    }
+    if (options.hasBulletDuration && sc.bulletDuration <= 0) {
+        fprintf(stderr, "bullet duration must be positive\n");
+        return false;
+    }
+    return true;
+}
+
+static StyleConfig
+configFor(StyleType style, const BenchOptions& options)
+{
+    StyleConfig sc = VolleyRunner::defaultConfig(style, style == StyleType::PARABOLA);
+    const StyleConfig& o = options.overrides;
+    if (options.hasNumber) {
+        sc.number = o.number;
+    }
+    if (options.hasFrequency) {
+        sc.frequency = o.frequency;
+    }
+    if (options.hasBulletDuration) {
+        sc.bulletDuration = o.bulletDuration;
+    }
+    if (options.hasCountThenChangePos) {
+        sc.countThenChangePos = o.countThenChangePos;
+    }
+    if (options.hasStartAngle) {
+        sc.startAngle = o.startAngle;
+    }
+    if (options.hasEndAngle) {
+        sc.endAngle = o.endAngle;
+    }
+    if (options.hasDeltaAngle) {
+        sc.deltaAngle = o.deltaAngle;
+    }
+    if (options.hasHeight) {
+        sc.height = o.height;
+    }
+    if (options.hasDistance) {
+        sc.distance = o.distance;
+    }
+    return sc;
+}
+
+/* 命中检测的目标，盒子为 minX, minY, maxX, maxY */
+struct BenchTarget
+{
+    unsigned int category;
+    float x;
+    float y;
+    float box[4];
+};
+
+struct BenchResult
+{
+    int styles;
+    float simulated; //秒
+    float measured;  //去掉预热后的秒数
+    int peakLive;
+    long long spawned;
+    long long hits; //子弹与激光的命中
+    long long grazes;
+    double nsPerBullet;
+    double msPerStep;
+    double allocationsPerSecond;
+    uint64_t checksum; //最终子弹场与命中数的摘要，线程数不同时应当一致
+};
+
+static void
+mix(uint64_t& hash, uint64_t value)
+{
+    // FNV-1a
+    hash ^= value;
+    hash *= 1099511628211ULL;
+}
+
+static uint64_t
+checksum(const BulletField& field, long long hits, long long grazes)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < field.size(); i++) {
+        uint32_t x, y;
+        memcpy(&x, &field.posX[i], sizeof(x));
+        memcpy(&y, &field.posY[i], sizeof(y));
+        mix(hash, ((uint64_t)x << 32) | y);
+    }
+    mix(hash, (uint64_t)field.size());
+    mix(hash, (uint64_t)hits);
+    mix(hash, (uint64_t)grazes);
+    return hash;
+}
+
+static BenchResult
+runSimulation(const BenchOptions& options)
+{
+    float width = HeadlessStyle::areaWidth;
+    float height = HeadlessStyle::areaHeight;
+
+    //敌人沿上方排开，PARABOLA 作为角色弹幕从左下方发射
+    std::vector<HeadlessStyle> styles;
+    std::vector<BenchTarget> targets;
+    int perStyle = options.emitters;
+    FastRandom::beginRound(options.seed);
+    for (auto style : options.styles) {
+        for (int i = 0; i < perStyle; i++) {
+            float t = (i + 0.5f) / perStyle;
+            if (style == StyleType::PARABOLA) {
+                styles.push_back(HeadlessStyle(configFor(style, options), 100.0f,
+                                               height * (0.1f + 0.3f * t), true,
+                                               FastRandom::nextStreamSeed()));
+            } else {
+                float x = width * t;
+                float y = height * 0.75f;
+                styles.push_back(HeadlessStyle(configFor(style, options), x, y, false,
+                                               FastRandom::nextStreamSeed()));
+                BenchTarget target;
+                target.category = BENCH_ENEMY_CATEGORY;
+                target.x = x;
+                target.y = y;
+                target.box[0] = x - 20;
+                target.box[1] = y - 20;
+                target.box[2] = x + 20;
+                target.box[3] = y + 20;
+                targets.push_back(target);
+            }
+        }
+    }
+    BenchTarget player;
+    player.category = BENCH_PLAYER_CATEGORY;
+    targets.push_back(player);
+    int playerIndex = (int)targets.size() - 1;
+
+    BulletSimulation simulation;
+    simulation.setArea(0, 0, width, height);
+    simulation.setViewport(0, 0, width, height);
+    simulation.setPlayerCategory(BENCH_PLAYER_CATEGORY);
+    const BulletField& field = simulation.getField();
+
+    int steps = (int)ceilf(options.seconds / options.dt);
+    int warmupSteps = (int)ceilf(options.warmup / options.dt);
+    int peakLive = 0;
+    long long liveSum = 0;
+    long long hits = 0;
+    long long grazes = 0;
+    long long spawnedAtWarmup = 0;
+    long long allocationsAtWarmup = 0;
+    double updateNs = 0;
+
+    for (int s = 0; s < steps; s++) {
+        if (s == warmupSteps) {
+            spawnedAtWarmup = 0;
+            for (auto& style : styles) {
+                spawnedAtWarmup += style.getSpawned();
+            }
+            allocationsAtWarmup = allocations.load();
+        }
+
+        //自机绕场地中心移动，使自机狙的方向逐轮变化
+        float time = s * options.dt;
+        float px = width * (0.5f + 0.3f * cosf(time * 0.7f));
+        float py = height * (0.3f + 0.15f * sinf(time * 1.3f));
+        BenchTarget& player = targets[playerIndex];
+        player.x = px;
+        player.y = py;
+        player.box[0] = px - 10;
+        player.box[1] = py - 16;
+        player.box[2] = px + 10;
+        player.box[3] = py + 16;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (auto& style : styles) {
+            style.update(options.dt, simulation, px, py);
+        }
+
+        // BulletLayer::update
+        simulation.clearTargets();
+        for (auto& target : targets) {
+            simulation.addTarget(target.x, target.y, target.category, target.box, &target);
+        }
+        simulation.update(options.dt);
+        int count = field.size();
+        hits += (long long)simulation.getHits().size();
+        for (auto& graze : simulation.getGrazes()) {
+            grazes += graze.count;
+        }
+
+        simulation.removeDead();
+
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+        peakLive = std::max(peakLive, count);
+        if (s >= warmupSteps) {
+            updateNs += ns;
+            liveSum += count;
+        }
+    }
+
+    long long spawned = 0;
+    for (auto& style : styles) {
+        spawned += style.getSpawned();
+    }
+    float measured = (steps - warmupSteps) * options.dt;
+
+    BenchResult result;
+    result.styles = (int)styles.size();
+    result.simulated = steps * options.dt;
+    result.measured = measured;
+    result.peakLive = peakLive;
+    result.spawned = spawned - spawnedAtWarmup;
+    result.hits = hits;
+    result.grazes = grazes;
+    result.nsPerBullet = liveSum > 0 ? updateNs / liveSum : 0;
+    result.msPerStep = updateNs / (steps - warmupSteps) / 1e6;
+    result.allocationsPerSecond = (allocations.load() - allocationsAtWarmup) / measured;
+    result.checksum = checksum(field, hits, grazes);
+    return result;
+}
+
+/* 以 0..N 个工作线程重复同一场模拟；最终状态不一致时返回非 0 */
+static int
+runScaling(const BenchOptions& options)
+{
+    int maxThreads = options.threads >= 0 ? options.threads : JobSystem::getDefaultThreadCount();
+    printf("  %-8s %16s %12s %10s %18s\n", "threads", "ns/bullet/update", "ms/step", "speedup",
+           "checksum");
+
+    double baseline = 0;
+    uint64_t expected = 0;
+    bool consistent = true;
+    for (int t = 0; t <= maxThreads; t++) {
+        JobSystem::getInstance()->setThreadCount(t);
+        BenchResult result = runSimulation(options);
+        if (t == 0) {
+            baseline = result.msPerStep;
+            expected = result.checksum;
+        }
+        consistent = consistent && result.checksum == expected;
+        printf("  %-8d %16.2f %12.3f %9.2fx %18llx\n", t, result.nsPerBullet, result.msPerStep,
+               result.msPerStep > 0 ? baseline / result.msPerStep : 0.0,
+               (unsigned long long)result.checksum);
+    }
+
+    if (!consistent) {
+        fprintf(stderr, "results differ between thread counts\n");
+        return 1;
+    }
+    return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    if (options.kernels || options.rings || options.slots || options.despawn || options.cancel ||
+        options.homing || options.trails || options.churn) {
+        if (options.kernels) {
+            runKernelBench(16384, 2000);
+        }
+        if (options.rings) {
+            runRingBench(64, 200000);
+            runRingBench(128, 100000);
+        }
+        if (options.slots) {
+            runSlotBench(100, 20000);
+            runSlotBench(500, 4000);
+            runSlotBench(2000, 500);
+        }
+        if (options.despawn) {
+            runDespawnBench(500, 2000);
+            runDespawnBench(2000, 500);
+            runDespawnBench(5000, 100);
+        }
+        if (options.cancel) {
+            runCancelBench(500, 2000);
+            runCancelBench(2000, 500);
+        }
+        if (options.homing) {
+            bool match = runHomingBench(500, 30, 3600);
+            match = runHomingBench(2000, 30, 900) && match;
+            match = runHomingBench(500, 120, 3600) && match;
+            if (!match) {
+                return 1;
+            }
+        }
+        if (options.trails) {
+            bool valid = runTrailBench(5000, 500, 600);
+            valid = runTrailBench(5000, 5000, 600) && valid;
+            if (!valid) {
+                return 1;
+            }
+        }
+        if (options.churn && !runChurnCheck(1000, 30)) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.scaling) {
+        return runScaling(options);
+    }
+    if (options.threads >= 0) {
+        JobSystem::getInstance()->setThreadCount(options.threads);
+    }
+
+    BenchResult result = runSimulation(options);
+
+    printf("kernels:              %s\n", getBulletKernels().name);
+    printf("threads:              main + %d workers\n", JobSystem::getInstance()->getThreadCount());
+    printf("styles:              ");
+    for (auto style : options.styles) {
+        printf(" %s", styleName(style));
+    }
+    printf("\n");
+    printf("emitters:             %d per style, %d total\n", options.emitters, result.styles);
+    printf("simulated:            %.2f s at dt %.5f, %.2f s measured\n", result.simulated,
+           options.dt, result.measured);
+    printf("spawn rate:           %.1f bullets/s\n", result.spawned / result.measured);
+    printf("peak live bullets:    %d\n", result.peakLive);
+    printf("hits:                 %lld\n", result.hits);
+    printf("grazes:               %lld\n", result.grazes);
+    printf("update:               %.2f ns/bullet/update, %.3f ms/step\n", result.nsPerBullet,
+           result.msPerStep);
+    printf("allocations:          %.1f /s\n", result.allocationsPerSecond);
+    printf("checksum:             %llx (seed %llu)\n", (unsigned long long)result.checksum,
+           (unsigned long long)options.seed);
+    printf("peak RSS:             %ld KB\n", peakRssKb());
+
+    if (options.maxNs > 0 && result.nsPerBullet > options.maxNs) {
+        fprintf(stderr, "ns/bullet/update %.2f exceeds %.2f\n", result.nsPerBullet,
+                options.maxNs);
+        return 1;
+    }
+    return 0;
+}
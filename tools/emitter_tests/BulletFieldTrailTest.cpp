@@ -0,0 +1,121 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* BulletField 的拖尾：环形缓冲中第 k 个位置是 k 帧之前的位置，子弹移动下标或被移除、
+ * 改写为拾取物时拖尾随之移动或释放
+ */
+
+#include "BulletField.h"
+#include "TestSupport.h"
+
+#include <vector>
+
+static BulletTraits
+trailTraits()
+{
+    BulletTraits traits = {};
+    traits.priority = BulletPriority::AIMED;
+    return traits;
+}
+
+/* 每帧推进后记下的一颗子弹的位置，最新的在末尾 */
+struct TrailHistory
+{
+    std::vector<float> x;
+    std::vector<float> y;
+
+    void record(const BulletField& field, int index)
+    {
+        x.push_back(field.posX[index]);
+        y.push_back(field.posY[index]);
+    }
+
+    /* 子弹 index 的拖尾与最近几帧记下的位置逐位相同 */
+    bool matches(const BulletField& field, int index) const
+    {
+        int frames = (int)x.size();
+        for (int k = 0; k < field.getTrailLength(index); k++) {
+            float px, py;
+            field.getTrailPoint(index, k, px, py);
+            if (px != x[frames - 1 - k] || py != y[frames - 1 - k]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+TEST_CASE(bulletFieldTrailKeepsRecentPositions)
+{
+    BulletField field;
+    field.spawn(Trajectory::linear(100, 100, 60, -30), 10.0f, trailTraits(), nullptr);
+    field.spawn(Trajectory::linear(300, 200, -45, 90), 10.0f, trailTraits(), nullptr);
+    field.setTrail(1);
+    CHECK(field.getTrailCount() == 1);
+    CHECK(field.getTrailLength(0) == 0);
+    CHECK(field.getTrailLength(1) == 1);
+
+    TrailHistory history;
+    history.record(field, 1);
+    for (int frame = 1; frame <= 3 * BULLET_TRAIL_LENGTH; frame++) {
+        field.update(1.0f / 60);
+        history.record(field, 1);
+        int expected = frame + 1 < BULLET_TRAIL_LENGTH ? frame + 1 : BULLET_TRAIL_LENGTH;
+        CHECK(field.getTrailLength(1) == expected);
+        CHECK(history.matches(field, 1));
+    }
+    CHECK(field.getTrailLength(0) == 0);
+}
+
+TEST_CASE(bulletFieldTrailFollowsMovedBullet)
+{
+    //第 0 颗先到期，removeDead 把末尾带拖尾的子弹移到下标 0，拖尾须随之移动
+    BulletField field;
+    field.spawn(Trajectory::linear(0, 0, 10, 0), 0.05f, trailTraits(), nullptr);
+    field.spawn(Trajectory::linear(50, 50, 0, 10), 10.0f, trailTraits(), nullptr);
+    field.spawn(Trajectory::linear(90, 20, -20, 5), 10.0f, trailTraits(), nullptr);
+    field.setTrail(0);
+    field.setTrail(2);
+    CHECK(field.getTrailCount() == 2);
+
+    TrailHistory history;
+    history.record(field, 2);
+    for (int frame = 0; frame < 5; frame++) {
+        field.update(1.0f / 60);
+        history.record(field, 2);
+    }
+
+    std::vector<BulletField::Released> released;
+    field.removeDead(released);
+    CHECK(field.size() == 2);
+    CHECK(released.empty()); //没有发射方的子弹不需要交还
+    CHECK(field.getTrailCount() == 1);
+    CHECK(field.getTrailLength(0) == 6);
+    CHECK(history.matches(field, 0));
+    CHECK(field.getTrailLength(1) == 0);
+
+    //移动之后继续记录到新的下标
+    for (int frame = 0; frame < 4; frame++) {
+        field.update(1.0f / 60);
+        history.record(field, 0);
+    }
+    CHECK(field.getTrailLength(0) == BULLET_TRAIL_LENGTH);
+    CHECK(history.matches(field, 0));
+
+    //释放的槽位被复用，从当前位置重新记录
+    field.setTrail(1);
+    CHECK(field.getTrailCount() == 2);
+    CHECK(field.getTrailLength(1) == 1);
+    float x, y;
+    field.getTrailPoint(1, 0, x, y);
+    CHECK(x == field.posX[1] && y == field.posY[1]);
+
+    //改写为拾取物时取消拖尾
+    field.respawn(0, Trajectory::linear(0, 0, 0, 0), 1.0f, trailTraits(), 0);
+    CHECK(field.getTrailLength(0) == 0);
+    CHECK(field.getTrailCount() == 1);
+
+    field.clear(released);
+    CHECK(field.getTrailCount() == 0);
+}
@@ -0,0 +1,69 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* BulletGrid 的查询结果与逐颗遍历比较：候选必须包含矩形内的全部子弹，且不重复 */
+
+#include "BulletGrid.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <random>
+
+TEST_CASE(bulletGridQueryCoversBruteForce)
+{
+    std::minstd_rand rng(4);
+    std::uniform_real_distribution<float> coordX(-200.0f, 1480.0f); //含区域外的子弹
+    std::uniform_real_distribution<float> coordY(-200.0f, 920.0f);
+    std::uniform_real_distribution<float> extent(0.0f, 300.0f);
+
+    BulletGrid grid;
+    grid.setBounds(0, 0, 1280, 720, 64);
+
+    for (int round = 0; round < 20; round++) {
+        int count = 50 + round * 100;
+        std::vector<float> xs(count);
+        std::vector<float> ys(count);
+        for (int i = 0; i < count; i++) {
+            xs[i] = coordX(rng);
+            ys[i] = coordY(rng);
+        }
+        grid.build(xs.data(), ys.data(), count);
+
+        //覆盖整个范围时每颗子弹恰好出现一次
+        std::vector<int> all;
+        grid.query(-1e6f, -1e6f, 1e6f, 1e6f, all);
+        std::sort(all.begin(), all.end());
+        CHECK((int)all.size() == count);
+        for (int i = 0; i < (int)all.size(); i++) {
+            CHECK(all[i] == i);
+        }
+
+        for (int q = 0; q < 50; q++) {
+            float minX = coordX(rng);
+            float minY = coordY(rng);
+            float maxX = minX + extent(rng);
+            float maxY = minY + extent(rng);
+            std::vector<int> candidates;
+            grid.query(minX, minY, maxX, maxY, candidates);
+            std::sort(candidates.begin(), candidates.end());
+            CHECK(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+
+            for (int i = 0; i < count; i++) {
+                if (xs[i] >= minX && xs[i] <= maxX && ys[i] >= minY && ys[i] <= maxY) {
+                    CHECK(std::binary_search(candidates.begin(), candidates.end(), i));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(bulletGridEmptyBuild)
+{
+    BulletGrid grid;
+    grid.setBounds(0, 0, 1280, 720, 32);
+    grid.build(nullptr, nullptr, 0);
+    std::vector<int> out;
+    grid.query(0, 0, 1280, 720, out);
+    CHECK(out.empty());
+}
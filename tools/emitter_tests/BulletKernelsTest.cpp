@@ -0,0 +1,178 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* 各 SIMD 内核与标量内核逐位比较（memcmp），以及 BulletField::evaluate 与内核逐位一致
+ *
+ *  + 子弹数取 1 到 40 与较大的非整倍数，覆盖各实现的向量主循环与尾部
+ *  + 数组从偏移 1 开始，覆盖不对齐的输入
+ */
+
+#include "BulletField.h"
+#include "BulletKernels.h"
+#include "TestSupport.h"
+
+#include <cstring>
+#include <random>
+
+#define KERNELS_TEST_MAX 8
+
+struct KernelInputs
+{
+    std::vector<float> a, b, c, d, e, f, g;
+};
+
+static void
+fillRandom(std::vector<float>& v, int n, std::minstd_rand& rng, float lo, float hi)
+{
+    std::uniform_real_distribution<float> dist(lo, hi);
+    v.resize(n + 1);
+    for (auto& x : v) {
+        x = dist(rng);
+    }
+}
+
+TEST_CASE(bulletKernelsMatchScalarBitForBit)
+{
+    const BulletKernels* kernels[KERNELS_TEST_MAX];
+    int kernelCount = getAvailableBulletKernels(kernels, KERNELS_TEST_MAX);
+    const BulletKernels& scalar = getScalarBulletKernels();
+    CHECK(kernelCount >= 1);
+
+    std::minstd_rand rng(5);
+    std::vector<int> counts;
+    for (int n = 1; n <= 40; n++) {
+        counts.push_back(n);
+    }
+    counts.push_back(1021);
+    counts.push_back(4099);
+
+    for (int k = 0; k < kernelCount; k++) {
+        const BulletKernels& kernel = *kernels[k];
+        int mismatches = 0;
+        for (int n : counts) {
+            KernelInputs in;
+            fillRandom(in.a, n, rng, 0.0f, 8.0f);        // age
+            fillRandom(in.b, n, rng, -360.0f, 360.0f);   // startRotation
+            fillRandom(in.c, n, rng, -720.0f, 720.0f);   // spin
+            fillRandom(in.d, n, rng, -200.0f, 1480.0f);  // originX / posX
+            fillRandom(in.e, n, rng, -200.0f, 920.0f);   // originY / posY
+            fillRandom(in.f, n, rng, -900.0f, 900.0f);   // velX
+            fillRandom(in.g, n, rng, -900.0f, 900.0f);   // velY
+            float dt = 1.0f / 60;
+
+            // advance
+            std::vector<float> age1 = in.a, age2 = in.a;
+            std::vector<float> rot1(n + 1), rot2(n + 1);
+            scalar.advance(age1.data() + 1, rot1.data() + 1, in.b.data() + 1, in.c.data() + 1, n,
+                           dt);
+            kernel.advance(age2.data() + 1, rot2.data() + 1, in.b.data() + 1, in.c.data() + 1, n,
+                           dt);
+            mismatches += memcmp(age1.data(), age2.data(), (n + 1) * sizeof(float)) != 0;
+            mismatches += memcmp(rot1.data(), rot2.data(), (n + 1) * sizeof(float)) != 0;
+
+            // integrate
+            std::vector<float> x1(n + 1), y1(n + 1), x2(n + 1), y2(n + 1);
+            scalar.integrate(x1.data() + 1, y1.data() + 1, in.d.data() + 1, in.e.data() + 1,
+                             in.f.data() + 1, in.g.data() + 1, in.a.data() + 1, n);
+            kernel.integrate(x2.data() + 1, y2.data() + 1, in.d.data() + 1, in.e.data() + 1,
+                             in.f.data() + 1, in.g.data() + 1, in.a.data() + 1, n);
+            mismatches += memcmp(x1.data(), x2.data(), (n + 1) * sizeof(float)) != 0;
+            mismatches += memcmp(y1.data(), y2.data(), (n + 1) * sizeof(float)) != 0;
+
+            // cullOutside，边界上的点也要覆盖
+            in.d[1] = 0.0f;
+            in.e[n] = 720.0f;
+            std::vector<uint8_t> out1(n + 1, 7), out2(n + 1, 7);
+            int c1 = scalar.cullOutside(in.d.data() + 1, in.e.data() + 1, n, 0, 0, 1280, 720,
+                                        out1.data() + 1);
+            int c2 = kernel.cullOutside(in.d.data() + 1, in.e.data() + 1, n, 0, 0, 1280, 720,
+                                        out2.data() + 1);
+            mismatches += c1 != c2;
+            mismatches += memcmp(out1.data(), out2.data(), n + 1) != 0;
+
+            // overlapBoxes
+            int targets = 1 + n % 5;
+            std::vector<float> radius;
+            fillRandom(radius, n, rng, 1.0f, 40.0f);
+            std::vector<float> boxes;
+            for (int t = 0; t < targets; t++) {
+                std::vector<float> corner;
+                fillRandom(corner, 2, rng, 0.0f, 1000.0f);
+                boxes.push_back(corner[0]);
+                boxes.push_back(corner[1]);
+                boxes.push_back(corner[0] + 200.0f);
+                boxes.push_back(corner[1] + 150.0f);
+            }
+            std::vector<int32_t> hit1(n + 1, 7), hit2(n + 1, 7);
+            int h1 = scalar.overlapBoxes(in.d.data() + 1, in.e.data() + 1, radius.data() + 1, n,
+                                         boxes.data(), targets, hit1.data() + 1);
+            int h2 = kernel.overlapBoxes(in.d.data() + 1, in.e.data() + 1, radius.data() + 1, n,
+                                         boxes.data(), targets, hit2.data() + 1);
+            mismatches += h1 != h2;
+            mismatches += memcmp(hit1.data(), hit2.data(), (n + 1) * sizeof(int32_t)) != 0;
+
+            // nearestTargets，部分种别不可命中；每两个目标放在同一点，覆盖距离相同的情形
+            std::vector<uint32_t> masks(n + 1), categories(targets);
+            std::vector<float> tx(targets), ty(targets);
+            std::vector<int32_t> ids(targets);
+            for (int i = 0; i <= n; i++) {
+                masks[i] = 1u << (i % 3);
+            }
+            for (int t = 0; t < targets; t++) {
+                categories[t] = t % 4 < 2 ? 0x1 : 0x6;
+                tx[t] = boxes[(t / 2) * 4];
+                ty[t] = boxes[(t / 2) * 4 + 1];
+                ids[t] = 100 + t;
+            }
+            std::vector<float> best1(n + 1, 7), best2(n + 1, 7);
+            std::vector<int32_t> near1(n + 1, 7), near2(n + 1, 7);
+            scalar.nearestTargets(in.d.data() + 1, in.e.data() + 1, masks.data() + 1, n,
+                                  tx.data(), ty.data(), categories.data(), ids.data(), targets,
+                                  best1.data() + 1, near1.data() + 1);
+            kernel.nearestTargets(in.d.data() + 1, in.e.data() + 1, masks.data() + 1, n,
+                                  tx.data(), ty.data(), categories.data(), ids.data(), targets,
+                                  best2.data() + 1, near2.data() + 1);
+            mismatches += memcmp(best1.data(), best2.data(), (n + 1) * sizeof(float)) != 0;
+            mismatches += memcmp(near1.data(), near2.data(), (n + 1) * sizeof(int32_t)) != 0;
+        }
+        if (mismatches > 0) {
+            printf("  kernel %s: %d mismatching outputs\n", kernel.name, mismatches);
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+TEST_CASE(bulletFieldEvaluateMatchesKernels)
+{
+    //补发的子弹（age > 0）经 evaluate 求值，须与内核按同一 age 推进的结果逐位一致
+    std::minstd_rand rng(6);
+    std::uniform_real_distribution<float> coord(0.0f, 1280.0f);
+    std::uniform_real_distribution<float> speed(-600.0f, 600.0f);
+    std::uniform_real_distribution<float> ages(0.001f, 3.0f);
+
+    BulletTraits traits = {};
+    traits.priority = BulletPriority::AIMED;
+    BulletField field;
+    const int count = 257;
+    std::vector<float> startAge(count);
+    for (int i = 0; i < count; i++) {
+        auto trajectory = Trajectory::linear(coord(rng), coord(rng), speed(rng), speed(rng));
+        trajectory.rotation = coord(rng);
+        trajectory.spin = speed(rng);
+        startAge[i] = ages(rng);
+        field.spawn(trajectory, 10.0f, traits, nullptr, startAge[i]);
+    }
+
+    std::vector<float> x(count), y(count), rotation(count);
+    const BulletKernels& kernels = field.getKernels();
+    kernels.integrate(x.data(), y.data(), field.originX.data(), field.originY.data(),
+                      field.velX.data(), field.velY.data(), field.age.data(), count);
+    std::vector<float> age = field.age;
+    kernels.advance(age.data(), rotation.data(), field.startRotation.data(), field.spin.data(),
+                    count, 0.0f);
+
+    CHECK(memcmp(x.data(), field.posX.data(), count * sizeof(float)) == 0);
+    CHECK(memcmp(y.data(), field.posY.data(), count * sizeof(float)) == 0);
+    CHECK(memcmp(rotation.data(), field.rotation.data(), count * sizeof(float)) == 0);
+}
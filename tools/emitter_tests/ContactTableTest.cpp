@@ -0,0 +1,83 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* ContactTable：ContactDispatcher 的种别对分派表
+ *
+ *  + 只有单独一位的种别掩码有下标，未设置种别时的 0xFFFFFFFF 等查不到
+ *  + 按 (A, B) 登记后，查 (B, A) 得到同一处理函数并标记对调，调用者据此把双方排成登记顺序
+ */
+
+#include "GameplayScene/ContactTable.h"
+#include "TestSupport.h"
+
+#include <string>
+
+// 与 common.h 中的掩码相同
+#define TEST_PLAYER_CATEGORY (0x1 << 2)
+#define TEST_BULLET_CATEGORY (0x1 << 3)
+#define TEST_ENEMY_CATEGORY (0x1 << 4)
+#define TEST_ELEVATOR_CATEGORY (0x1 << 7)
+
+TEST_CASE(contactTableCategoryIndex)
+{
+    for (int i = 0; i < CONTACT_CATEGORY_COUNT; i++) {
+        CHECK(ContactTable<int>::categoryIndex(1 << i) == i);
+    }
+    CHECK(ContactTable<int>::categoryIndex(0) == -1);
+    CHECK(ContactTable<int>::categoryIndex((int)0xFFFFFFFF) == -1);
+    CHECK(ContactTable<int>::categoryIndex(0x3) == -1);
+    CHECK(ContactTable<int>::categoryIndex(0x18) == -1);
+    CHECK(ContactTable<int>::categoryIndex(1 << CONTACT_CATEGORY_COUNT) == -1);
+    CHECK(ContactTable<int>::categoryIndex(1 << 30) == -1);
+}
+
+TEST_CASE(contactTableSwapsPair)
+{
+    ContactTable<std::string> table;
+    CHECK(table.put(TEST_BULLET_CATEGORY, TEST_ENEMY_CATEGORY, "bullet-enemy"));
+    CHECK(table.put(TEST_PLAYER_CATEGORY, TEST_PLAYER_CATEGORY, "player-player"));
+
+    //登记的顺序：不对调
+    bool swapped = true;
+    const std::string* found = table.find(TEST_BULLET_CATEGORY, TEST_ENEMY_CATEGORY, swapped);
+    CHECK(found != nullptr && *found == "bullet-enemy");
+    CHECK(!swapped);
+
+    //物理引擎给出的顺序相反：同一处理函数，需对调
+    swapped = false;
+    found = table.find(TEST_ENEMY_CATEGORY, TEST_BULLET_CATEGORY, swapped);
+    CHECK(found != nullptr && *found == "bullet-enemy");
+    CHECK(swapped);
+
+    //同种别只有一格，不对调
+    swapped = true;
+    found = table.find(TEST_PLAYER_CATEGORY, TEST_PLAYER_CATEGORY, swapped);
+    CHECK(found != nullptr && *found == "player-player");
+    CHECK(!swapped);
+
+    //未登记的对与不是单独一位的种别查不到
+    CHECK(table.find(TEST_PLAYER_CATEGORY, TEST_ENEMY_CATEGORY, swapped) == nullptr);
+    CHECK(table.find((int)0xFFFFFFFF, TEST_ENEMY_CATEGORY, swapped) == nullptr);
+    CHECK(!table.put(TEST_BULLET_CATEGORY | TEST_PLAYER_CATEGORY, TEST_ENEMY_CATEGORY, "x"));
+    CHECK(!table.put(0, TEST_ENEMY_CATEGORY, "x"));
+}
+
+TEST_CASE(contactTableOverwriteAndClear)
+{
+    ContactTable<std::string> table;
+    table.put(TEST_ENEMY_CATEGORY, TEST_BULLET_CATEGORY, "enemy-bullet");
+
+    //反向重新登记后，两格都指向新的处理函数，对调标记随之翻转
+    table.put(TEST_BULLET_CATEGORY, TEST_ENEMY_CATEGORY, "bullet-enemy");
+    bool swapped = true;
+    const std::string* found = table.find(TEST_BULLET_CATEGORY, TEST_ENEMY_CATEGORY, swapped);
+    CHECK(found != nullptr && *found == "bullet-enemy" && !swapped);
+    found = table.find(TEST_ENEMY_CATEGORY, TEST_BULLET_CATEGORY, swapped);
+    CHECK(found != nullptr && *found == "bullet-enemy" && swapped);
+
+    table.put(TEST_PLAYER_CATEGORY, TEST_ELEVATOR_CATEGORY, "player-elevator");
+    table.clear();
+    CHECK(table.find(TEST_BULLET_CATEGORY, TEST_ENEMY_CATEGORY, swapped) == nullptr);
+    CHECK(table.find(TEST_ELEVATOR_CATEGORY, TEST_PLAYER_CATEGORY, swapped) == nullptr);
+}
@@ -0,0 +1,66 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* DirectionTable：建表与旋转的结果与逐颗计算三角函数一致，反复旋转不累积误差 */
+
+#include "DirectionTable.h"
+#include "TestSupport.h"
+
+#include <random>
+
+#define TEST_PI 3.14159265358979323846
+
+TEST_CASE(directionTableMatchesTrig)
+{
+    std::minstd_rand rng(10);
+    std::uniform_real_distribution<float> angle(-10.0f, 10.0f);
+    std::uniform_int_distribution<int> count(1, 64);
+
+    for (int round = 0; round < 200; round++) {
+        int n = count(rng);
+        float start = angle(rng);
+        float step = angle(rng) / n;
+        float turn = angle(rng);
+
+        DirectionTable table;
+        table.build(n, start, step);
+        DirectionTable rotated;
+        table.rotate(turn, rotated);
+        CHECK(table.size() == n);
+        CHECK(rotated.size() == n);
+
+        for (int i = 0; i < n; i++) {
+            double radians = (double)start + i * (double)step;
+            CHECK_NEAR(table.getX(i), cos(radians), 1e-5);
+            CHECK_NEAR(table.getY(i), sin(radians), 1e-5);
+            CHECK_NEAR(rotated.getX(i), cos(radians + turn), 1e-5);
+            CHECK_NEAR(rotated.getY(i), sin(radians + turn), 1e-5);
+        }
+    }
+}
+
+TEST_CASE(directionTableRotationDoesNotDrift)
+{
+    //模拟 Scatter 每一轮按累计角度从原表旋转：一万轮后仍是单位向量且方向正确
+    DirectionTable table;
+    table.build(36, 0, (float)(TEST_PI / 18));
+    DirectionTable rotated;
+    double total = 0;
+    for (int volley = 0; volley < 10000; volley++) {
+        total += 0.37;
+        table.rotate((float)fmod(total, 2 * TEST_PI), rotated);
+    }
+    for (int i = 0; i < rotated.size(); i++) {
+        double x = rotated.getX(i);
+        double y = rotated.getY(i);
+        CHECK_NEAR(x * x + y * y, 1, 1e-5);
+        CHECK_NEAR(x, cos(total + i * TEST_PI / 18), 1e-4);
+        CHECK_NEAR(y, sin(total + i * TEST_PI / 18), 1e-4);
+    }
+
+    //重建时尺寸随之改变
+    table.build(3, 0, 1);
+    table.rotate(0, rotated);
+    CHECK(rotated.size() == 3);
+}
@@ -0,0 +1,77 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* FastRandom：相同种子的序列相同，fill 与逐个 nextFloat 一致，取值落在约定的区间内 */
+
+#include "FastRandom.h"
+#include "TestSupport.h"
+
+#include <vector>
+
+TEST_CASE(fastRandomIsDeterministic)
+{
+    FastRandom a(42);
+    FastRandom b(42);
+    FastRandom c(43);
+    bool same = true;
+    bool differs = false;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t x = a.next();
+        same = same && x == b.next();
+        differs = differs || x != c.next();
+    }
+    CHECK(same);
+    CHECK(differs);
+
+    //重新播种后从头开始
+    a.seed(42);
+    FastRandom fresh(42);
+    CHECK(a.next() == fresh.next());
+
+    //本局的子序列种子只由本局种子与创建顺序决定
+    std::vector<uint64_t> first;
+    FastRandom::beginRound(7);
+    CHECK(FastRandom::getRoundSeed() == 7);
+    for (int i = 0; i < 16; i++) {
+        first.push_back(FastRandom::nextStreamSeed());
+    }
+    FastRandom::beginRound(7);
+    bool replay = true;
+    for (int i = 0; i < 16; i++) {
+        replay = replay && FastRandom::nextStreamSeed() == first[i];
+    }
+    CHECK(replay);
+    FastRandom::beginRound(8);
+    CHECK(FastRandom::nextStreamSeed() != first[0]);
+}
+
+TEST_CASE(fastRandomRanges)
+{
+    FastRandom rng(1);
+    std::vector<float> filled(4099);
+    rng.fill(filled.data(), (int)filled.size());
+
+    //fill 与逐个 nextFloat 取到的序列相同
+    FastRandom sequential(1);
+    bool match = true;
+    double sum = 0;
+    for (float u : filled) {
+        match = match && u == sequential.nextFloat();
+        CHECK(u >= 0.0f && u < 1.0f);
+        sum += u;
+    }
+    CHECK(match);
+    CHECK_NEAR(sum / filled.size(), 0.5, 0.02);
+
+    //range 两端都能取到，与 cocos2d::random(min, max) 相同
+    int counts[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3000; i++) {
+        int v = rng.range(-1, 1);
+        CHECK(v >= -1 && v <= 1);
+        if (v >= -1 && v <= 1) {
+            counts[v + 1]++;
+        }
+    }
+    CHECK(counts[0] > 800 && counts[1] > 800 && counts[2] > 800);
+}
@@ -0,0 +1,38 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* JobSystem：各线程数下 parallelFor 恰好覆盖每个下标一次，返回时所有块都已完成 */
+
+#include "JobSystem.h"
+#include "TestSupport.h"
+
+#include <vector>
+
+TEST_CASE(jobSystemCoversEveryIndexOnce)
+{
+    JobSystem* jobs = JobSystem::getInstance();
+    int saved = jobs->getThreadCount();
+
+    for (int threads = 0; threads <= 4; threads++) {
+        jobs->setThreadCount(threads);
+        //大量小批次，主线程反复在最后一块完成前进入等待
+        for (int round = 0; round < 2000; round++) {
+            int count = 1 + round % 97;
+            int grain = 1 + round % 7;
+            std::vector<int> visits(count, 0);
+            jobs->parallelFor(count, grain, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            });
+            bool once = true;
+            for (int i = 0; i < count; i++) {
+                once = once && visits[i] == 1;
+            }
+            CHECK(once);
+        }
+    }
+
+    jobs->setThreadCount(saved);
+}
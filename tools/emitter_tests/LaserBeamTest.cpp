@@ -0,0 +1,120 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* LaserBeam：线段与盒子的求交与沿线段逐点采样一致，阶段、扫动与显示宽度符合时长设置 */
+
+#include "LaserBeam.h"
+#include "TestSupport.h"
+
+#include <random>
+
+// 沿光束的采样点数
+#define TEST_LASER_SAMPLES 2000
+
+// 沿线段采样，是否有点落在外扩 pad 后的盒子内
+static bool
+sampledOverlap(const LaserBeam& beam, float minX, float minY, float maxX, float maxY, float pad)
+{
+    float endX, endY;
+    beam.getEnd(endX, endY);
+    for (int i = 0; i <= TEST_LASER_SAMPLES; i++) {
+        float t = (float)i / TEST_LASER_SAMPLES;
+        float x = beam.originX + (endX - beam.originX) * t;
+        float y = beam.originY + (endY - beam.originY) * t;
+        if (x >= minX - pad && x <= maxX + pad && y >= minY - pad && y <= maxY + pad) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE(laserBeamOverlapMatchesSampling)
+{
+    std::minstd_rand rng(13);
+    std::uniform_real_distribution<float> coord(0.0f, 1280.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> size(5.0f, 80.0f);
+
+    int hits = 0;
+    for (int round = 0; round < 5000; round++) {
+        LaserBeam beam;
+        beam.originX = coord(rng);
+        beam.originY = coord(rng) * 0.6f;
+        beam.angle = round % 8 == 0 ? (float)(round / 8 % 4 * 90) : angle(rng); //含轴向的光束
+        beam.length = 200 + coord(rng);
+        beam.width = size(rng) * 0.5f;
+
+        float minX = coord(rng);
+        float minY = coord(rng) * 0.6f;
+        float maxX = minX + size(rng);
+        float maxY = minY + size(rng);
+        float half = beam.width / 2;
+
+        bool overlap = beam.overlapsBox(minX, minY, maxX, maxY);
+        //采样落在外扩盒子内时必定相交；判定相交时线段离外扩盒子不超过采样间距
+        if (sampledOverlap(beam, minX, minY, maxX, maxY, half)) {
+            CHECK(overlap);
+        }
+        if (overlap) {
+            float spacing = (beam.length + 1) / TEST_LASER_SAMPLES;
+            CHECK(sampledOverlap(beam, minX, minY, maxX, maxY, half + spacing));
+            hits++;
+        }
+    }
+    CHECK(hits > 100); //随机场景中确有相交的情形
+}
+
+TEST_CASE(laserBeamPhases)
+{
+    LaserBeam beam;
+    beam.angle = 10;
+    beam.sweep = 30;
+    beam.width = 20;
+    beam.warmup = 0.5f;
+    beam.active = 1.0f;
+    beam.fade = 0.25f;
+
+    const float dt = 1.0f / 64; //二进制精确的步长，阶段边界落在整步上
+    CHECK(beam.getPhase() == LaserBeam::WARMUP);
+    CHECK(!beam.isLethal());
+    CHECK(beam.getVisibleWidth() > 0 && beam.getVisibleWidth() < beam.width);
+
+    //预警阶段不扫动
+    for (int i = 0; i < 32; i++) {
+        beam.advance(dt);
+    }
+    CHECK_NEAR(beam.angle, 10, 1e-6);
+    CHECK(beam.getPhase() == LaserBeam::ACTIVE);
+    CHECK(beam.isLethal());
+    CHECK_NEAR(beam.getVisibleWidth(), 20, 1e-6);
+
+    //照射一秒扫过 sweep 度
+    for (int i = 0; i < 64; i++) {
+        beam.advance(dt);
+    }
+    CHECK_NEAR(beam.angle, 40, 1e-4);
+    CHECK(beam.getPhase() == LaserBeam::FADE);
+
+    //消散阶段线性变细，不再扫动
+    for (int i = 0; i < 8; i++) {
+        beam.advance(dt);
+    }
+    CHECK_NEAR(beam.angle, 40, 1e-4);
+    CHECK_NEAR(beam.getVisibleWidth(), 10, 1e-4);
+    for (int i = 0; i < 8; i++) {
+        beam.advance(dt);
+    }
+    CHECK(beam.getPhase() == LaserBeam::DONE);
+    CHECK(beam.getVisibleWidth() == 0);
+
+    //终点
+    beam.originX = 100;
+    beam.originY = 50;
+    beam.angle = 90;
+    beam.length = 300;
+    float x, y;
+    beam.getEnd(x, y);
+    CHECK_NEAR(x, 100, 1e-3);
+    CHECK_NEAR(y, 350, 1e-3);
+}
@@ -0,0 +1,185 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* PatternCompiler：游戏数据全部编译通过，小程序的字节码符合预期，错误程序给出对应的原因 */
+
+#include "PatternCompiler.h"
+#include "TestSupport.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using json = nlohmann::json;
+
+static json
+readGameData(const std::string& name)
+{
+    std::ifstream in((std::string(TESTS_GAMEDATA_DIR) + "/" + name).c_str());
+    std::stringstream content;
+    content << in.rdbuf();
+    return json::parse(content.str());
+}
+
+static PatternCompileOptions
+testOptions()
+{
+    PatternCompileOptions options;
+    options.bulletCategory = 1;
+    options.playerCategory = 2;
+    options.enemyCategory = 4;
+    return options;
+}
+
+// 编译 program，返回错误信息，成功时为空
+static std::string
+compileError(const char* text)
+{
+    Pattern pattern;
+    std::string error;
+    if (compilePattern("test", json::parse(text), testOptions(), pattern, error)) {
+        return std::string();
+    }
+    return error.empty() ? std::string("?") : error;
+}
+
+static bool
+startsWith(const std::string& s, const char* prefix)
+{
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+TEST_CASE(patternCompilerCompilesGameData)
+{
+    json patterns = readGameData("patterns.json");
+    json spellCards = readGameData("spell_cards.json");
+    CHECK(patterns.is_array() && !patterns.empty());
+
+    std::map<std::string, Pattern> out;
+    std::vector<std::string> errors;
+    int failed = compileGameData(patterns, spellCards, testOptions(), out, errors);
+    for (auto& error : errors) {
+        printf("  %s\n", error.c_str());
+    }
+    CHECK(failed == 0);
+
+    int expected = (int)patterns.size();
+    for (auto& card : spellCards) {
+        expected += card.count("pattern") ? 1 : 0;
+    }
+    CHECK((int)out.size() == expected);
+
+    for (auto& p : out) {
+        const Pattern& pattern = p.second;
+        CHECK(pattern.tag == p.first);
+        CHECK(!pattern.code.empty() && pattern.code.back().op == PatternOp::END);
+        for (auto& ins : pattern.code) {
+            if (ins.op == PatternOp::SPAWN_RING) {
+                CHECK(ins.jump < pattern.rings.size());
+                CHECK(pattern.rings[ins.jump].size() == ins.index);
+            } else if (ins.op == PatternOp::REPEAT) {
+                CHECK(ins.jump < pattern.code.size());
+            } else if (ins.op == PatternOp::ARCHETYPE) {
+                CHECK(ins.index < pattern.archetypes.size());
+            } else if (ins.op == PatternOp::PLAY_STYLE) {
+                CHECK(ins.index < pattern.styles.size());
+            }
+        }
+    }
+}
+
+TEST_CASE(patternCompilerBytecode)
+{
+    Pattern pattern;
+    std::string error;
+    bool ok = compilePattern("test",
+                             json::parse(R"({
+        "mana": 3,
+        "bullets": {"b": {"name": "b.png", "hits": "player", "homing": 90}},
+        "program": [
+            {"op": "repeat", "times": 3, "body": [
+                {"op": "ring", "count": 4, "speed": 100, "life": 2},
+                {"op": "ring", "count": 3, "spread": 60, "speed": 50, "life": 1},
+                {"op": "rotate", "angle": 15},
+                {"op": "wait", "time": 0.5}
+            ]},
+            {"op": "aim"}
+        ]
+    })"),
+                             testOptions(), pattern, error);
+    CHECK(ok);
+    CHECK(pattern.manaCost == 3);
+    CHECK(pattern.code.size() == 7);
+    CHECK(pattern.rings.size() == 2);
+    CHECK(pattern.archetypes.size() == 1);
+    if (!ok || pattern.code.size() != 7 || pattern.rings.size() != 2) {
+        return;
+    }
+
+    const BulletConfig& bc = pattern.archetypes[0];
+    CHECK(bc._categoryBitmask == 1);
+    CHECK(bc._contactTestBitmask == 2);
+    CHECK(bc.homing == 90);
+
+    //整圈：首尾不重合
+    const PatternInstruction& full = pattern.code[0];
+    CHECK(full.op == PatternOp::SPAWN_RING && full.index == 4 && full.jump == 0);
+    CHECK_NEAR(full.a, 90, 1e-6);
+    CHECK_NEAR(full.b, 0, 1e-6);
+    CHECK_NEAR(pattern.rings[0].getX(1), 0, 1e-6);
+    CHECK_NEAR(pattern.rings[0].getY(1), 1, 1e-6);
+
+    //扇形：首尾落在 ±spread/2
+    const PatternInstruction& fan = pattern.code[1];
+    CHECK(fan.op == PatternOp::SPAWN_RING && fan.index == 3 && fan.jump == 1);
+    CHECK_NEAR(fan.a, 30, 1e-6);
+    CHECK_NEAR(fan.b, -30, 1e-6);
+    CHECK_NEAR(fan.c, 50, 1e-6);
+    CHECK_NEAR(fan.d, 1, 1e-6);
+
+    CHECK(pattern.code[2].op == PatternOp::ROTATE);
+    CHECK(pattern.code[3].op == PatternOp::WAIT);
+    CHECK(pattern.code[4].op == PatternOp::REPEAT);
+    CHECK(pattern.code[4].index == 3 && pattern.code[4].jump == 0);
+    CHECK(pattern.code[5].op == PatternOp::AIM);
+    CHECK(pattern.code[6].op == PatternOp::END);
+}
+
+TEST_CASE(patternCompilerRejectsBadPrograms)
+{
+    CHECK(compileError(R"({"program": []})").empty());
+    CHECK(startsWith(compileError(R"({"program": [{"op": "jump"}]})"), "unknown op"));
+    CHECK(startsWith(compileError(R"({"bullets": {"b": {"name": "b.png"}},
+        "program": [{"op": "bullet", "name": "c"}]})"),
+                     "unknown bullet"));
+    CHECK(startsWith(compileError(R"({"bullets": {"b": {"name": "b.png", "homing": -1}},
+        "program": []})"),
+                     "negative homing"));
+    CHECK(startsWith(compileError(R"({"bullets": {"b": {"name": "b.png", "hits": "all"}},
+        "program": []})"),
+                     "unknown hits"));
+    CHECK(startsWith(compileError(R"({"program": [
+        {"op": "ring", "count": 4, "speed": 1, "life": 1}]})"),
+                     "ring without bullets"));
+    CHECK(startsWith(compileError(R"({"bullets": {"b": {"name": "b.png"}}, "program": [
+        {"op": "ring", "count": 0, "speed": 1, "life": 1}]})"),
+                     "ring count out of range"));
+    CHECK(startsWith(compileError(R"({"bullets": {"b": {"name": "b.png"}}, "program": [
+        {"op": "repeat", "body": [{"op": "ring", "count": 4, "speed": 1, "life": 1}]}]})"),
+                     "endless repeat without wait"));
+    CHECK(startsWith(compileError(R"({"program": [{"op": "wait", "time": 0}]})"),
+                     "wait time must be positive"));
+    CHECK(startsWith(compileError(R"({"program": [{"op": "repeat", "times": 2, "body": []}]})"),
+                     "empty repeat body"));
+
+    //纹理帧校验由调用者提供
+    PatternCompileOptions options = testOptions();
+    options.frameExists = [](const std::string& name) { return name == "b.png"; };
+    Pattern pattern;
+    std::string error;
+    CHECK(!compilePattern("test",
+                          json::parse(R"({"bullets": {"b": {"name": "x.png"}}, "program": []})"),
+                          options, pattern, error));
+    CHECK(startsWith(error, "unknown sprite frame"));
+}
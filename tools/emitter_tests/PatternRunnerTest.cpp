@@ -0,0 +1,206 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* PatternRunner：指令的执行时刻、帧内偏移、补帧上限与各回调的顺序
+ *
+ *  + 以 PatternCompiler 编译小程序，记录 PatternHost 收到的回调
+ */
+
+#include "PatternCompiler.h"
+#include "PatternRunner.h"
+#include "TestSupport.h"
+
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+/* 记录回调，aim 返回固定角度 */
+class RecordingHost : public PatternHost
+{
+public:
+    RecordingHost()
+        : time(0)
+        , archetype(0)
+    {
+    }
+
+    struct Ring
+    {
+        float time; //发射时刻：本次 step 结束时刻减去帧内偏移
+        float angle;
+        unsigned int archetype;
+        unsigned int count;
+    };
+
+    virtual void spawnRing(const PatternInstruction& ring, float angle, float offset) override
+    {
+        Ring r = { time - offset, angle, archetype, ring.index };
+        rings.push_back(r);
+    }
+
+    virtual float aimAngle() override
+    {
+        events.push_back("aim");
+        return 42.0f;
+    }
+
+    virtual void setArchetype(unsigned int index) override
+    {
+        events.push_back("bullet");
+        archetype = index;
+    }
+
+    virtual void playStyle(const StyleConfig& sc) override
+    {
+        events.push_back(sc.style == StyleType::SCATTER ? "scatter" : "style");
+    }
+
+    void step(PatternRunner& runner, float dt)
+    {
+        time += dt;
+        runner.step(dt, *this);
+    }
+
+    float time;
+    unsigned int archetype;
+    std::vector<Ring> rings;
+    std::vector<std::string> events;
+};
+
+static bool
+compileTest(const char* text, Pattern& pattern)
+{
+    PatternCompileOptions options;
+    options.bulletCategory = 1;
+    options.playerCategory = 2;
+    options.enemyCategory = 4;
+    std::string error;
+    bool ok = compilePattern("test", json::parse(text), options, pattern, error);
+    if (!ok) {
+        printf("  %s\n", error.c_str());
+    }
+    return ok;
+}
+
+TEST_CASE(patternRunnerTimingAndRepeat)
+{
+    Pattern pattern;
+    bool ok = compileTest(R"({
+        "bullets": {"a": {"name": "a.png"}, "b": {"name": "b.png"}},
+        "program": [
+            {"op": "repeat", "times": 3, "body": [
+                {"op": "ring", "count": 4, "speed": 100, "life": 2},
+                {"op": "rotate", "angle": 10},
+                {"op": "wait", "time": 0.5}
+            ]},
+            {"op": "aim"},
+            {"op": "bullet", "name": "b"},
+            {"op": "rotate", "angle": 15},
+            {"op": "ring", "count": 2, "speed": 100, "life": 2}
+        ]
+    })",
+                          pattern);
+    CHECK(ok);
+    if (!ok) {
+        return;
+    }
+
+    PatternRunner runner(&pattern);
+    RecordingHost host;
+    //0.2 秒一步：第 2、3 圈分别落在 0.6、1.2 秒的一步内，偏移为超出等待的部分
+    for (int i = 0; i < 10 && !runner.isFinished(); i++) {
+        host.step(runner, 0.2f);
+    }
+    CHECK(runner.isFinished());
+    CHECK(host.rings.size() == 4);
+    if (host.rings.size() != 4) {
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        CHECK_NEAR(host.rings[i].time, 0.5f * i, 1e-5);
+        CHECK_NEAR(host.rings[i].angle, 10.0f * i, 1e-5);
+        CHECK(host.rings[i].archetype == 0);
+        CHECK(host.rings[i].count == 4);
+    }
+    //循环结束后在 1.5 秒执行 aim，角度改为目标方向再转 15 度
+    CHECK_NEAR(host.rings[3].time, 1.5f, 1e-5);
+    CHECK_NEAR(host.rings[3].angle, 57.0f, 1e-5);
+    CHECK(host.rings[3].archetype == 1);
+    CHECK(host.rings[3].count == 2);
+    CHECK(host.events.size() == 2 && host.events[0] == "aim" && host.events[1] == "bullet");
+
+    //结束后不再执行
+    host.step(runner, 1.0f);
+    CHECK(host.rings.size() == 4);
+}
+
+TEST_CASE(patternRunnerClampsLag)
+{
+    Pattern pattern;
+    bool ok = compileTest(R"({
+        "bullets": {"a": {"name": "a.png"}},
+        "program": [
+            {"op": "repeat", "body": [
+                {"op": "ring", "count": 1, "speed": 100, "life": 2},
+                {"op": "wait", "time": 0.1}
+            ]}
+        ]
+    })",
+                          pattern);
+    CHECK(ok);
+    if (!ok) {
+        return;
+    }
+
+    PatternRunner runner(&pattern);
+    RecordingHost host;
+    host.step(runner, 0.0f);
+    CHECK(host.rings.size() == 1);
+
+    //卡顿 2 秒只补最近 0.25 秒内的 3 圈，而不是 20 圈
+    host.rings.clear();
+    host.step(runner, 2.0f);
+    CHECK(host.rings.size() == 3);
+    for (auto& ring : host.rings) {
+        CHECK(ring.time >= 2.0f - 0.25f - 1e-5f && ring.time <= 2.0f);
+    }
+    CHECK(!runner.isFinished());
+
+    //之后恢复正常节拍
+    host.rings.clear();
+    for (int i = 0; i < 10; i++) {
+        host.step(runner, 0.1f);
+    }
+    CHECK(host.rings.size() == 10);
+}
+
+TEST_CASE(patternRunnerPlaysStyles)
+{
+    Pattern pattern;
+    bool ok = compileTest(R"({
+        "bullets": {"a": {"name": "a.png"}},
+        "program": [
+            {"op": "style", "type": "SCATTER", "bulletDuration": 2, "number": 5, "bullet": "a"},
+            {"op": "wait", "time": 1},
+            {"op": "style", "type": "PARALLEL", "bulletDuration": 2, "number": 3, "bullet": "a"}
+        ]
+    })",
+                          pattern);
+    CHECK(ok);
+    if (!ok) {
+        return;
+    }
+
+    PatternRunner runner(&pattern);
+    RecordingHost host;
+    host.step(runner, 0.25f);
+    CHECK(host.events.size() == 1 && host.events[0] == "scatter");
+    CHECK(!runner.isFinished());
+    host.step(runner, 0.5f);
+    CHECK(host.events.size() == 1);
+    host.step(runner, 0.25f);
+    CHECK(host.events.size() == 2 && host.events[1] == "style");
+    CHECK(runner.isFinished());
+}
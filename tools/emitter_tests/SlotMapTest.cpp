@@ -0,0 +1,83 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* SlotMap：随机插入、删除后与 std::map 的内容一致，已删除元素的句柄不再有效 */
+
+#include "SlotMap.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+TEST_CASE(slotMapMatchesReferenceMap)
+{
+    std::minstd_rand rng(15);
+    SlotMap<int> slots;
+    std::map<int, SlotHandle> live; //值 -> 句柄，值各不相同
+    std::vector<SlotHandle> stale;
+    int next = 0;
+
+    for (int op = 0; op < 20000; op++) {
+        //前半段插入居多，后半段删除居多，槽位反复复用
+        bool grow = op < 10000 ? rng() % 3 != 0 : rng() % 3 == 0;
+        if (grow || live.empty()) {
+            SlotHandle handle = slots.insert(next);
+            CHECK(handle.isValid());
+            live[next++] = handle;
+        } else {
+            auto it = live.begin();
+            std::advance(it, rng() % live.size());
+            CHECK(slots.erase(it->second));
+            CHECK(!slots.erase(it->second)); //重复删除失败
+            stale.push_back(it->second);
+            live.erase(it);
+        }
+
+        if (op % 500 == 0) {
+            CHECK(slots.size() == (int)live.size());
+            for (auto& entry : live) {
+                const int* value = slots.get(entry.second);
+                CHECK(value && *value == entry.first);
+            }
+            //密集数组与 live 的内容相同
+            std::vector<int> values(slots.begin(), slots.end());
+            std::sort(values.begin(), values.end());
+            std::vector<int> expected;
+            for (auto& entry : live) {
+                expected.push_back(entry.first);
+            }
+            CHECK(values == expected);
+            //旧句柄即使槽位已被复用也不指向新元素
+            for (auto& handle : stale) {
+                CHECK(!slots.contains(handle));
+                CHECK(slots.get(handle) == nullptr);
+            }
+        }
+    }
+}
+
+TEST_CASE(slotMapClearInvalidatesHandles)
+{
+    SlotMap<int> slots;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 100; i++) {
+        handles.push_back(slots.insert(i));
+    }
+    slots.clear();
+    CHECK(slots.empty());
+    for (auto& handle : handles) {
+        CHECK(!slots.contains(handle));
+    }
+
+    //清空后复用槽位，新句柄有效、旧句柄仍无效
+    SlotHandle reused = slots.insert(7);
+    CHECK(slots.contains(reused));
+    CHECK(*slots.get(reused) == 7);
+    for (auto& handle : handles) {
+        CHECK(!slots.contains(handle));
+    }
+    CHECK(!slots.contains(SlotHandle()));
+}
@@ -0,0 +1,239 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* StyleLifetime 与 BulletSimulation：停止发射的弹幕在最后一颗子弹或激光离场（到期、命中、出界、
+ * 消弹、激光消散）时才释放；弹幕先于子弹销毁、子弹模拟先于弹幕销毁时互相断开，不再通知
+ */
+
+#include "BulletSimulation.h"
+#include "StyleLifetime.h"
+#include "TestSupport.h"
+
+#define TEST_PLAYER_CATEGORY 0x1
+#define TEST_ENEMY_CATEGORY 0x2
+
+/* 释放时只计数，由测试自己销毁 */
+struct TestStyle : public StyleLifetime
+{
+    TestStyle()
+        : released(0)
+    {
+    }
+
+    virtual void releaseStyle() override { released++; }
+
+    int released;
+};
+
+static BulletTraits
+enemyTraits()
+{
+    BulletTraits traits = {};
+    traits.ownerMask = TEST_ENEMY_CATEGORY;
+    traits.hitMask = TEST_PLAYER_CATEGORY;
+    traits.radius = 4;
+    traits.damage = 1;
+    traits.priority = BulletPriority::AIMED;
+    return traits;
+}
+
+/* 从 (100, 100) 向右、长 400 的激光，预警 0.1 秒、照射 0.2 秒、消散 0.1 秒 */
+static LaserBeam
+testBeam()
+{
+    LaserBeam beam;
+    beam.originX = 100;
+    beam.originY = 100;
+    beam.length = 400;
+    beam.width = 10;
+    beam.warmup = 0.1f;
+    beam.active = 0.2f;
+    beam.fade = 0.1f;
+    return beam;
+}
+
+static void
+setupSimulation(BulletSimulation& simulation)
+{
+    simulation.setArea(0, 0, 1280, 720);
+    simulation.setViewport(0, 0, 1280, 720);
+    simulation.setPlayerCategory(TEST_PLAYER_CATEGORY);
+}
+
+/* 与 BulletLayer::update 相同推进一帧 */
+static void
+step(BulletSimulation& simulation, float dt)
+{
+    simulation.update(dt);
+    simulation.removeDead();
+}
+
+TEST_CASE(styleLifetimeRetireWhenIdle)
+{
+    int start = StyleLifetime::getLiveCount();
+    {
+        TestStyle style;
+        CHECK(StyleLifetime::getLiveCount() == start + 1);
+        CHECK(!style.isRetired());
+        style.retire();
+        CHECK(style.isRetired());
+        CHECK(style.released == 1);
+    }
+    CHECK(StyleLifetime::getLiveCount() == start);
+}
+
+TEST_CASE(styleLifetimeReleasedWhenBulletsExpire)
+{
+    BulletSimulation simulation;
+    setupSimulation(simulation);
+    TestStyle style;
+    simulation.addBullet(Trajectory::linear(200, 200, 0, 0), 0.1f, enemyTraits(), DespawnPolicy(),
+                         0, false, &style);
+    simulation.addBullet(Trajectory::linear(300, 200, 0, 0), 0.3f, enemyTraits(), DespawnPolicy(),
+                         0, false, &style);
+    CHECK(style.inFlight() == 2);
+
+    //仍有子弹在场，停止后不释放
+    style.retire();
+    CHECK(style.released == 0);
+
+    const float dt = 1.0f / 60;
+    for (int t = 0; t < 12; t++) {
+        step(simulation, dt);
+    }
+    CHECK(style.inFlight() == 1);
+    CHECK(style.released == 0);
+
+    for (int t = 0; t < 12; t++) {
+        step(simulation, dt);
+    }
+    CHECK(style.inFlight() == 0);
+    CHECK(style.released == 1);
+    CHECK(simulation.getField().size() == 0);
+}
+
+TEST_CASE(styleLifetimeReleasedOnHitDespawnAndCancel)
+{
+    BulletSimulation simulation;
+    setupSimulation(simulation);
+    TestStyle style;
+    DespawnPolicy area = DespawnPolicy::area(0);
+    simulation.addBullet(Trajectory::linear(200, 200, 0, 0), 10.0f, enemyTraits(), area, 0,
+                         false, &style);
+    simulation.addBullet(Trajectory::linear(1270, 400, 600, 0), 10.0f, enemyTraits(), area, 0,
+                         false, &style);
+    simulation.addBullet(Trajectory::linear(600, 400, 0, 0), 10.0f, enemyTraits(), area, 0, false,
+                         &style);
+    style.retire();
+
+    //命中自机的子弹在 update 中交还
+    int key = 0;
+    float box[4] = { 190, 190, 210, 210 };
+    simulation.clearTargets();
+    simulation.addTarget(200, 200, TEST_PLAYER_CATEGORY, box, &key);
+    simulation.update(1.0f / 60);
+    CHECK(simulation.getHits().size() == 1);
+    CHECK(style.inFlight() == 2);
+    simulation.removeDead();
+
+    //飞出区域的子弹在 removeDead 时交还
+    simulation.clearTargets();
+    step(simulation, 1.0f / 60);
+    CHECK(style.inFlight() == 1);
+    CHECK(style.released == 0);
+
+    //消弹时立即交还，最后一颗子弹离场后释放
+    CHECK(simulation.cancelBullets(TEST_ENEMY_CATEGORY, 0, 0, 1280, 720) == 1);
+    CHECK(style.inFlight() == 0);
+    CHECK(style.released == 1);
+}
+
+TEST_CASE(styleLifetimeReleasedWhenBeamsFade)
+{
+    BulletSimulation simulation;
+    setupSimulation(simulation);
+    TestStyle style;
+    SlotHandle handle = simulation.addBeam(testBeam(), enemyTraits(), &style);
+    CHECK(simulation.getBeam(handle) != nullptr);
+    CHECK(style.inFlight() == 1);
+    style.retire();
+    CHECK(style.released == 0);
+
+    //照射期间自机一直在光束上，只命中一次
+    int key = 0;
+    float box[4] = { 290, 90, 310, 110 };
+    int hits = 0;
+    const float dt = 1.0f / 60;
+    for (int t = 0; t < 30 && style.released == 0; t++) {
+        simulation.clearTargets();
+        simulation.addTarget(300, 100, TEST_PLAYER_CATEGORY, box, &key);
+        simulation.update(dt);
+        hits += (int)simulation.getHits().size();
+        simulation.removeDead();
+    }
+    CHECK(hits == 1);
+    CHECK(style.released == 1);
+    CHECK(style.inFlight() == 0);
+    CHECK(simulation.getBeam(handle) == nullptr);
+    CHECK(simulation.getBeams().size() == 0);
+}
+
+TEST_CASE(styleLifetimeDestroyedBeforeBullets)
+{
+    BulletSimulation simulation;
+    setupSimulation(simulation);
+    int start = StyleLifetime::getLiveCount();
+    TestStyle* style = new TestStyle();
+    simulation.addBullet(Trajectory::linear(200, 200, 0, 0), 0.1f, enemyTraits(), DespawnPolicy(),
+                         0, false, style);
+    simulation.addBeam(testBeam(), enemyTraits(), style);
+    delete style;
+    CHECK(StyleLifetime::getLiveCount() == start);
+
+    //子弹与激光继续到结束，不再通知已销毁的弹幕
+    CHECK(simulation.getField().owner[0] == nullptr);
+    for (auto& b : simulation.getBeams()) {
+        CHECK(b.owner == nullptr);
+    }
+    for (int t = 0; t < 30; t++) {
+        step(simulation, 1.0f / 60);
+    }
+    CHECK(simulation.getField().size() == 0);
+    CHECK(simulation.getBeams().size() == 0);
+}
+
+TEST_CASE(styleLifetimeOutlivesSimulation)
+{
+    TestStyle style;
+    {
+        BulletSimulation simulation;
+        setupSimulation(simulation);
+        simulation.addBullet(Trajectory::linear(200, 200, 0, 0), 1.0f, enemyTraits(),
+                             DespawnPolicy(), 0, false, &style);
+        simulation.addBeam(testBeam(), enemyTraits(), &style);
+        CHECK(style.inFlight() == 2);
+    }
+
+    //模拟销毁时只删除登记，不释放；之后停止发射时立即释放
+    CHECK(style.inFlight() == 0);
+    CHECK(style.released == 0);
+    style.retire();
+    CHECK(style.released == 1);
+}
+
+TEST_CASE(styleLifetimeReleasedOnClear)
+{
+    BulletSimulation simulation;
+    setupSimulation(simulation);
+    TestStyle style;
+    simulation.addBullet(Trajectory::linear(200, 200, 0, 0), 1.0f, enemyTraits(), DespawnPolicy(),
+                         0, false, &style);
+    style.retire();
+    CHECK(style.released == 0);
+
+    //移除全部子弹时交还，激光不受影响
+    simulation.clearBullets();
+    CHECK(style.inFlight() == 0);
+    CHECK(style.released == 1);
+}
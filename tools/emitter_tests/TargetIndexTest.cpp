@@ -0,0 +1,119 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* TargetIndex：整批查找与逐个遍历全部目标的结果相同
+ *
+ *  + 目标数跨过建表的门槛，两种比较方式都会用到
+ *  + 种别混有多位的目标与不可命中的种别，查找点有一部分落在覆盖范围外
+ *  + 目标成对放在同一点，距离相同时须取先加入的目标
+ */
+
+#include "TargetIndex.h"
+#include "TestSupport.h"
+
+#include <random>
+#include <vector>
+
+struct TestTarget
+{
+    float x;
+    float y;
+    uint32_t category;
+};
+
+static int
+bruteNearest(const std::vector<TestTarget>& targets, float x, float y, uint32_t mask)
+{
+    int found = -1;
+    float best = 0;
+    for (int t = 0; t < (int)targets.size(); t++) {
+        if ((targets[t].category & mask) == 0) {
+            continue;
+        }
+        float dx = targets[t].x - x;
+        float dy = targets[t].y - y;
+        float d = dx * dx + dy * dy;
+        if (found < 0 || d < best) {
+            found = t;
+            best = d;
+        }
+    }
+    return found;
+}
+
+TEST_CASE(targetIndexMatchesBruteForce)
+{
+    std::minstd_rand rng(19);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const uint32_t categories[] = { 0x1, 0x2, 0x4, 0x3 };
+    const uint32_t masks[] = { 0x1, 0x2, 0x4, 0x6, 0x8 };
+
+    TargetIndex index;
+    index.setBounds(0, 0, 1280, 720, 128);
+    int mismatches = 0;
+    int queries = 0;
+    for (int targetCount : { 0, 1, 4, 30, 60, 200 }) {
+        for (int queryCount : { 1, 7, 500, 2000 }) {
+            std::vector<TestTarget> targets;
+            for (int t = 0; t < targetCount; t++) {
+                if (t % 5 == 4) {
+                    targets.push_back(targets.back());
+                    continue;
+                }
+                TestTarget target = { 1280 * unit(rng), 720 * unit(rng),
+                                      categories[(t / 3) % 4] };
+                targets.push_back(target);
+            }
+
+            index.clear();
+            for (auto& target : targets) {
+                index.add(target.x, target.y, target.category);
+            }
+            std::vector<float> xs, ys;
+            std::vector<uint32_t> ms;
+            for (int q = 0; q < queryCount; q++) {
+                xs.push_back(-100 + 1480 * unit(rng));
+                ys.push_back(-100 + 920 * unit(rng));
+                ms.push_back(masks[q % 5]);
+                CHECK(index.mark(xs[q], ys[q], ms[q]) == q);
+            }
+            index.build();
+            CHECK(index.getQueryCount() == queryCount);
+
+            for (int q = 0; q < queryCount; q++) {
+                int expected = bruteNearest(targets, xs[q], ys[q], ms[q]);
+                mismatches += index.getNearest(q) != expected;
+                mismatches += index.findNearest(xs[q], ys[q], ms[q]) != expected;
+                queries++;
+            }
+        }
+    }
+    if (mismatches > 0) {
+        printf("  %d of %d queries differ\n", mismatches, queries);
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE(targetIndexQueryAfterClear)
+{
+    //上一帧登记过查找的格子在 clear 后重置，新的一帧只与新加入的目标比较
+    TargetIndex index;
+    index.setBounds(0, 0, 1280, 720, 128);
+    for (int t = 0; t < 100; t++) {
+        index.add(10.0f * t, 700, 0x2);
+    }
+    index.mark(500, 100, 0x2);
+    index.build();
+    CHECK(index.getNearest(0) == 50);
+
+    index.clear();
+    index.add(1200, 20, 0x2);
+    CHECK(index.mark(500, 100, 0x2) == 0);
+    CHECK(index.mark(500, 100, 0x1) == 1);
+    index.build();
+    CHECK(index.getQueryCount() == 2);
+    CHECK(index.getNearest(0) == 0);
+    CHECK(index.getNearest(1) == -1);
+    CHECK(index.findNearest(0, 0, 0x2) == 0);
+}
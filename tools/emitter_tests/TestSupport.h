@@ -0,0 +1,58 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/* 极简的测试登记
+ *
+ *  + TEST_CASE 定义的测试在静态初始化时登记，由 main 按登记顺序逐个运行
+ *  + CHECK 失败时打印位置并计数，不中断当前测试，便于一次看到全部不一致
+ */
+
+struct TestCase
+{
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& testCases();
+
+/* 当前测试中失败的检查数 */
+extern int testFailures;
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, void (*run)()) { testCases().push_back(TestCase{ name, run }); }
+};
+
+#define TEST_CASE(__NAME__)                                                                        \
+    static void __NAME__();                                                                        \
+    static TestRegistrar __NAME__##Registrar(#__NAME__, __NAME__);                                 \
+    static void __NAME__()
+
+#define CHECK(__COND__)                                                                            \
+    do {                                                                                           \
+        if (!(__COND__)) {                                                                         \
+            printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #__COND__);                 \
+            testFailures++;                                                                        \
+        }                                                                                          \
+    } while (0)
+
+#define CHECK_NEAR(__A__, __B__, __TOLERANCE__)                                                    \
+    do {                                                                                           \
+        double __a = (__A__);                                                                      \
+        double __b = (__B__);                                                                      \
+        if (!(fabs(__a - __b) <= (__TOLERANCE__))) {                                               \
+            printf("  %s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, #__A__,  \
+                   #__B__, __a, __b);                                                              \
+            testFailures++;                                                                        \
+        }                                                                                          \
+    } while (0)
+
+#endif // TEST_SUPPORT_H
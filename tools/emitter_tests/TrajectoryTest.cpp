@@ -0,0 +1,156 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* Trajectory 的解析求值与 cocos2d 动作逐帧推进的结果比较
+ *
+ *  + 参照实现按 cocos2d-x 3.x 的 ActionInterval::step、MoveBy、BezierBy、EaseIn/Out/InOut
+ *    与 tweenfunc 照抄，不依赖引擎
+ *  + 动作以 1/60 秒步长累加 elapsed，轨迹以同一 elapsed 求值，误差须在 TRAJECTORY_TOLERANCE 以内
+ */
+
+#include "TestSupport.h"
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <cfloat>
+
+// 允许的误差（像素）
+#define TRAJECTORY_TOLERANCE 1e-3f
+#define TRAJECTORY_DT (1.0f / 60)
+
+// tweenfunc::easeIn / easeOut / easeInOut
+static float
+cocosEase(EasingType easing, float time, float rate)
+{
+    switch (easing) {
+        case EasingType::IN:
+            return powf(time, rate);
+        case EasingType::OUT:
+            return powf(time, 1 / rate);
+        case EasingType::IN_OUT:
+            time *= 2;
+            if (time < 1) {
+                return 0.5f * powf(time, rate);
+            } else {
+                return (1.0f - 0.5f * powf(2 - time, rate));
+            }
+        default:
+            return time;
+    }
+}
+
+// BezierBy 中的 bezierat
+static float
+bezierat(float a, float b, float c, float d, float t)
+{
+    return (powf(1 - t, 3) * a + 3 * t * (powf(1 - t, 2)) * b + 3 * powf(t, 2) * (1 - t) * c +
+            powf(t, 3) * d);
+}
+
+/* ActionInterval::step：累加 elapsed，以 elapsed / duration 截断到 [0, 1] 调用 update */
+static float
+actionProgress(float elapsed, float duration)
+{
+    return std::max(0.0f, std::min(1.0f, elapsed / std::max(duration, FLT_EPSILON)));
+}
+
+static void
+checkEased(EasingType easing, float rate, float dx, float dy, float duration)
+{
+    auto trajectory = Trajectory::eased(100, 200, dx, dy, duration, easing, rate);
+    float elapsed = 0;
+    float worst = 0;
+    while (elapsed < duration + 0.5f) {
+        elapsed += TRAJECTORY_DT;
+        // EaseXxx::update(t) -> MoveBy::update(tween(t))
+        float t = cocosEase(easing, actionProgress(elapsed, duration), rate);
+        float ex = 100 + dx * t;
+        float ey = 200 + dy * t;
+
+        float x, y;
+        trajectory.evaluate(elapsed, x, y);
+        worst = std::max(worst, std::max(fabsf(x - ex), fabsf(y - ey)));
+    }
+    CHECK(worst <= TRAJECTORY_TOLERANCE);
+    if (worst > TRAJECTORY_TOLERANCE) {
+        printf("  eased %d rate %g: error %g px\n", (int)easing, rate, worst);
+    }
+}
+
+TEST_CASE(trajectoryEasedMatchesCocosEase)
+{
+    const EasingType easings[] = { EasingType::NONE, EasingType::IN, EasingType::OUT,
+                                   EasingType::IN_OUT };
+    const float rates[] = { 0.5f, 1.0f, 2.0f, 3.0f };
+    for (auto easing : easings) {
+        for (auto rate : rates) {
+            checkEased(easing, rate, 640.0f, -360.0f, 1.5f);
+            checkEased(easing, rate, -37.5f, 812.0f, 4.0f);
+        }
+    }
+}
+
+TEST_CASE(trajectoryBezierMatchesBezierTo)
+{
+    //与 Parabola 相同的取法：起点、两个控制点与终点均为绝对坐标
+    const float cases[][9] = {
+        { 100, 300, 225, 420, 350, 395, 600, 280, 1.5f },
+        { 900, 100, 700, 600, 300, 650, 80, 90, 3.0f },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0.5f },
+    };
+    for (auto& c : cases) {
+        auto trajectory = Trajectory::bezier(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8]);
+        float elapsed = 0;
+        float worst = 0;
+        while (elapsed < c[8] + 0.5f) {
+            elapsed += TRAJECTORY_DT;
+            // BezierTo::startWithTarget 把绝对坐标换算为相对起点，BezierBy::update 以 bezierat 求值
+            float t = actionProgress(elapsed, c[8]);
+            float ex = c[0] + bezierat(0, c[2] - c[0], c[4] - c[0], c[6] - c[0], t);
+            float ey = c[1] + bezierat(0, c[3] - c[1], c[5] - c[1], c[7] - c[1], t);
+
+            float x, y;
+            trajectory.evaluate(elapsed, x, y);
+            worst = std::max(worst, std::max(fabsf(x - ex), fabsf(y - ey)));
+        }
+        CHECK(worst <= TRAJECTORY_TOLERANCE);
+    }
+}
+
+TEST_CASE(trajectoryLinearAndIntegrated)
+{
+    //原先的 EaseInOut(MoveBy, 1.0) 即匀速
+    auto linear = Trajectory::linear(10, 20, 300, -150);
+    auto integrated = Trajectory::integrated(10, 20, 300, -150);
+    float elapsed = 0;
+    for (int i = 0; i < 240; i++) {
+        elapsed += TRAJECTORY_DT;
+        float t = cocosEase(EasingType::IN_OUT, actionProgress(elapsed, 4.0f), 1.0f);
+        float x, y;
+        linear.evaluate(elapsed, x, y);
+        CHECK_NEAR(x, 10 + 1200 * t, TRAJECTORY_TOLERANCE * 4);
+        CHECK_NEAR(y, 20 - 600 * t, TRAJECTORY_TOLERANCE * 4);
+
+        float ix, iy;
+        integrated.evaluate(elapsed, ix, iy);
+        CHECK(ix == x && iy == y);
+    }
+
+    auto spinning = Trajectory::linear(0, 0, 0, 0);
+    spinning.rotation = 30;
+    spinning.spin = 90;
+    CHECK_NEAR(spinning.rotationAt(2.0f), 210.0f, 1e-4);
+}
+
+TEST_CASE(trajectoryCurveStopsAtEnd)
+{
+    auto trajectory = Trajectory::bezier(0, 0, 10, 50, 40, 50, 60, 0, 1.0f);
+    float x, y;
+    trajectory.evaluate(1.0f, x, y);
+    CHECK_NEAR(x, 60, 1e-4);
+    CHECK_NEAR(y, 0, 1e-4);
+    trajectory.evaluate(5.0f, x, y);
+    CHECK_NEAR(x, 60, 1e-4);
+    CHECK_NEAR(y, 0, 1e-4);
+}
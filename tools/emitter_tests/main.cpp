@@ -0,0 +1,44 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* Emitters 中不依赖 cocos2d 部分的单元测试
+ *
+ *  + 无参数时运行全部测试，否则只运行名字中含有参数的测试
+ *  + 有失败的检查时返回 1，供 ctest 判定
+ */
+
+#include "TestSupport.h"
+
+#include <cstring>
+
+int testFailures = 0;
+
+std::vector<TestCase>&
+testCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int failed = 0;
+    int run = 0;
+    for (auto& test : testCases()) {
+        if (filter && nullptr == strstr(test.name, filter)) {
+            continue;
+        }
+        testFailures = 0;
+        test.run();
+        run++;
+        printf("%s %s\n", testFailures == 0 ? "[  OK  ]" : "[ FAIL ]", test.name);
+        if (testFailures > 0) {
+            failed++;
+        }
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#include "HeadlessPattern.h"
+
+#include <cmath>
+
+#define SIM_PI 3.14159265358979323846f
+#define SIM_RADIANS(__DEGREES__) ((__DEGREES__)*SIM_PI / 180.0f)
+#define SIM_DEGREES(__RADIANS__) ((__RADIANS__)*180.0f / SIM_PI)
+
+HeadlessPattern::HeadlessPattern(const Pattern* pattern, float x, float y, bool player,
+                                 uint64_t seed)
+    : pattern(pattern)
+    , x(x)
+    , y(y)
+    , player(player)
+    , runner(pattern)
+    , simulation(nullptr)
+    , targetX(0)
+    , targetY(0)
+    , archetype(0)
+    , spawned(0)
+    , rng(seed)
+{
+}
+
+void
+HeadlessPattern::update(float dt, BulletSimulation& simulation, float targetX, float targetY)
+{
+    //与 EmitterSystem 相同：本弹幕先于它启动的弹幕推进，本帧新启动的弹幕下一帧开始
+    int count = (int)styles.size();
+    this->simulation = &simulation;
+    this->targetX = targetX;
+    this->targetY = targetY;
+    runner.step(dt, *this);
+    for (int i = 0; i < count; i++) {
+        styles[i].update(dt, simulation, targetX, targetY);
+    }
+}
+
+bool
+HeadlessPattern::isFinished() const
+{
+    if (!runner.isFinished()) {
+        return false;
+    }
+    for (auto& style : styles) {
+        if (!style.isStopped() || style.getBeamCount() > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int
+HeadlessPattern::getSpawned() const
+{
+    int total = spawned;
+    for (auto& style : styles) {
+        total += style.getSpawned();
+    }
+    return total;
+}
+
+// PatternStyle::spawnBullet
+void
+HeadlessPattern::spawnRing(const PatternInstruction& ring, float angle, float offset)
+{
+    const BulletConfig& bc = pattern->archetypes[archetype];
+    pattern->rings[ring.jump].rotate(SIM_RADIANS(angle), directions);
+
+    BulletTraits traits;
+    traits.archetype = (uint16_t)archetype;
+    traits.ownerMask = player ? BENCH_PLAYER_CATEGORY : BENCH_ENEMY_CATEGORY;
+    traits.hitMask = bc._contactTestBitmask;
+    traits.radius = (bc.length + bc.width) / 4.0f;
+    traits.damage = bc.harm;
+    traits.despawn = 0;
+    traits.priority = player ? BulletPriority::PLAYER : BulletPriority::AIMED;
+    auto despawn = DespawnPolicy::area(STYLE_DESPAWN_MARGIN);
+
+    for (int i = 0; i < ring.index; i++) {
+        auto trajectory = PatternRunner::ringBullet(ring, directions, i, angle, x, y);
+        if (simulation->addBullet(trajectory, ring.d, traits, despawn, bc.homing, bc.trail,
+                                  nullptr, offset) >= 0) {
+            spawned++;
+        }
+    }
+}
+
+// PatternStyle::aimAngle，角色朝向目标所在的一侧
+float
+HeadlessPattern::aimAngle()
+{
+    if (player) {
+        return targetX < x ? 180.0f : 0.0f;
+    }
+    return SIM_DEGREES(atan2f(targetY - y, targetX - x));
+}
+
+void
+HeadlessPattern::setArchetype(unsigned int index)
+{
+    archetype = index;
+}
+
+// Emitter::playStyle
+void
+HeadlessPattern::playStyle(const StyleConfig& sc)
+{
+    if ((player && sc.style == StyleType::ODDEVEN) ||
+        (!player && sc.style == StyleType::PARABOLA)) {
+        return;
+    }
+    styles.push_back(HeadlessStyle(sc, x, y, player, rng.nextSeed()));
+}
@@ -0,0 +1,66 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+#ifndef HEADLESS_PATTERN_H
+#define HEADLESS_PATTERN_H
+
+#include "BulletSimulation.h"
+#include "DirectionTable.h"
+#include "FastRandom.h"
+#include "HeadlessStyle.h"
+#include "Pattern.h"
+#include "PatternRunner.h"
+
+#include <vector>
+
+/* 无窗口环境下的字节码弹幕：与 PatternStyle 共用 PatternRunner 解释执行编译好的模式
+ *
+ *  + 环形弹由 PatternRunner::ringBullet 求出，与 PatternStyle 相同，直接写入子弹模拟
+ *  + style 指令按 Emitter::playStyle 启动 bullet_bench 的 HeadlessStyle：角色不能使用 ODDEVEN，
+ *    敌人不能使用 PARABOLA；与 EmitterSystem 相同，新启动的弹幕从下一帧开始推进
+ *  + 角色的 aim 朝向目标所在的一侧，对应游戏中角色面朝敌人
+ */
+
+class HeadlessPattern : public PatternHost
+{
+public:
+    /* 以 (x, y) 为发射者位置，player 为角色弹幕；seed 用于 style 指令启动的弹幕 */
+    HeadlessPattern(const Pattern* pattern, float x, float y, bool player, uint64_t seed);
+
+    /* 推进 dt 秒，发射的子弹写入 simulation；(targetX, targetY) 为 aim 的目标位置 */
+    void update(float dt, BulletSimulation& simulation, float targetX, float targetY);
+
+    /* 执行到 END 且 style 指令启动的弹幕都已停止 */
+    bool isFinished() const;
+
+    /* 累计发射的子弹数（含 style 指令启动的弹幕），激光每条计一次 */
+    int getSpawned() const;
+
+    const std::vector<HeadlessStyle>& getStyles() const { return styles; }
+
+    /* PatternRunner 的回调 */
+    virtual void spawnRing(const PatternInstruction& ring, float angle, float offset) override;
+    virtual float aimAngle() override;
+    virtual void setArchetype(unsigned int index) override;
+    virtual void playStyle(const StyleConfig& sc) override;
+
+private:
+    const Pattern* pattern;
+    float x;
+    float y;
+    bool player;
+
+    PatternRunner runner;
+    BulletSimulation* simulation; //本次 update 写入的子弹模拟
+    float targetX;             //本次 update 的 aim 目标
+    float targetY;
+    unsigned int archetype;    //当前子弹种类，archetypes 下标
+    DirectionTable directions; //转到当前角度后的方向表
+    int spawned;
+
+    std::vector<HeadlessStyle> styles;
+    FastRandom rng;
+};
+
+#endif // HEADLESS_PATTERN_H
@@ -0,0 +1,422 @@
+﻿#ifdef WIN32
+#pragma execution_character_set("utf-8")
+#endif
+
+/* 离线弹幕模式模拟器
+ *
+ *  + 读取 patterns.json 与 spell_cards.json，以游戏中的 PatternCompiler 编译指定模式，
+ *    由 HeadlessPattern 以固定步长解释执行 M 秒，不依赖 cocos2d 与 GL
+ *  + 每步由 BulletLayer 使用的 BulletSimulation 推进子弹场、出界回收、对目标的命中检测、
+ *    移除死亡子弹，与游戏中是同一份代码
+ *  + 输出峰值在场子弹数、单帧峰值发射数与每帧耗时；--csv 写出子弹密度热图，
+ *    每格为模拟期间该格平均每帧的子弹数，首行为画面顶部
+ *  + 用法见 --help
+ */
+
+#include "BulletSimulation.h"
+#include "HeadlessPattern.h"
+#include "JobSystem.h"
+#include "PatternCompiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+// 目标的判定盒子，自机与 bullet_bench 相同，敌人取 40x40
+#define SIM_PLAYER_HALF_WIDTH 10.0f
+#define SIM_PLAYER_HALF_HEIGHT 16.0f
+#define SIM_ENEMY_HALF_SIZE 20.0f
+
+struct SimOptions
+{
+    std::string tag;
+    std::string patternsFile;
+    std::string spellCardsFile;
+    std::string csvFile;
+    float seconds;
+    float dt;
+    float cell; //热图格子边长
+    bool player;
+    bool list;
+    float x, y;             //发射者位置
+    float targetX, targetY; // aim 的目标，也是命中检测的目标
+    bool hasAt, hasTarget;
+    int budget; //同屏子弹预算，0 为不检查
+    int threads;
+    uint64_t seed;
+};
+
+struct SimResult
+{
+    float simulated;
+    float finishedAt; //模式与其启动的弹幕全部停止、子弹全部回收的时刻，未结束为负
+    int frames;
+    long long spawned;
+    int peakLive;
+    float peakLiveAt;
+    int peakSpawns;
+    float peakSpawnsAt;
+    int peakBeams;
+    long long hits;
+    int overBudget; //在场子弹数超出预算的帧数
+    double avgUs;
+    double peakUs;
+    double nsPerBullet;
+    int columns;
+    int rows;
+    std::vector<double> heat; //各格累计的子弹数，按行从下到上
+};
+
+static void
+printUsage()
+{
+    printf("usage: pattern_sim --tag TAG [options]\n"
+           "  --tag TAG             pattern tag in patterns.json, or spell card tag\n"
+           "  --list                list the pattern tags and exit\n"
+           "  --patterns FILE       (Resources/gamedata/patterns.json)\n"
+           "  --spell-cards FILE    (Resources/gamedata/spell_cards.json)\n"
+           "  --seconds M           simulated seconds (20)\n"
+           "  --dt T                fixed step (1/60)\n"
+           "  --player              run as a player pattern (enemy)\n"
+           "  --at X,Y              emitter position (enemy 960,360; player 320,144)\n"
+           "  --target X,Y          aim target and hit test box (the other one of the two)\n"
+           "  --csv FILE            write the density heatmap as CSV\n"
+           "  --cell N              heatmap cell size in pixels (32)\n"
+           "  --budget N            count frames with more than N live bullets\n"
+           "  --seed S              round seed for styles started by the pattern (1)\n"
+           "  --threads N           job system worker threads (cores - 1)\n");
+}
+
+static bool
+parsePoint(const char* value, float& x, float& y)
+{
+    return sscanf(value, "%f,%f", &x, &y) == 2;
+}
+
+static bool
+parseOptions(int argc, char** argv, SimOptions& options)
+{
+    options.patternsFile = "Resources/gamedata/patterns.json";
+    options.spellCardsFile = "Resources/gamedata/spell_cards.json";
+    options.seconds = 20;
+    options.dt = 1.0f / 60;
+    options.cell = 32;
+    options.player = false;
+    options.list = false;
+    options.hasAt = options.hasTarget = false;
+    options.budget = 0;
+    options.threads = -1;
+    options.seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        } else if (arg == "--player") {
+            options.player = true;
+            continue;
+        } else if (arg == "--list") {
+            options.list = true;
+            continue;
+        }
+
+        if (nullptr == value) {
+            fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--tag") {
+            options.tag = value;
+        } else if (arg == "--patterns") {
+            options.patternsFile = value;
+        } else if (arg == "--spell-cards") {
+            options.spellCardsFile = value;
+        } else if (arg == "--csv") {
+            options.csvFile = value;
+        } else if (arg == "--seconds") {
+            options.seconds = (float)atof(value);
+        } else if (arg == "--dt") {
+            options.dt = (float)atof(value);
+        } else if (arg == "--cell") {
+            options.cell = (float)atof(value);
+        } else if (arg == "--budget") {
+            options.budget = atoi(value);
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = atoi(value);
+        } else if (arg == "--at") {
+            if (!parsePoint(value, options.x, options.y)) {
+                fprintf(stderr, "--at expects X,Y\n");
+                return false;
+            }
+            options.hasAt = true;
+        } else if (arg == "--target") {
+            if (!parsePoint(value, options.targetX, options.targetY)) {
+                fprintf(stderr, "--target expects X,Y\n");
+                return false;
+            }
+            options.hasTarget = true;
+        } else {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.tag.empty() && !options.list) {
+        fprintf(stderr, "--tag is required\n");
+        return false;
+    }
+    if (options.dt <= 0 || options.seconds <= 0 || options.cell < 1) {
+        fprintf(stderr, "need dt > 0, seconds > 0 and cell >= 1\n");
+        return false;
+    }
+    if (options.threads < -1) {
+        fprintf(stderr, "threads must not be negative\n");
+        return false;
+    }
+
+    //敌人在右侧半空，角色在左下方，两者互为目标
+    float width = HeadlessStyle::areaWidth;
+    float height = HeadlessStyle::areaHeight;
+    float enemyX = width * 0.75f, enemyY = height * 0.5f;
+    float playerX = width * 0.25f, playerY = height * 0.2f;
+    if (!options.hasAt) {
+        options.x = options.player ? playerX : enemyX;
+        options.y = options.player ? playerY : enemyY;
+    }
+    if (!options.hasTarget) {
+        options.targetX = options.player ? enemyX : playerX;
+        options.targetY = options.player ? enemyY : playerY;
+    }
+    return true;
+}
+
+static bool
+readJson(const std::string& file, json& out)
+{
+    std::ifstream in(file.c_str());
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", file.c_str());
+        return false;
+    }
+    std::stringstream content;
+    content << in.rdbuf();
+    try {
+        out = json::parse(content.str());
+    } catch (std::exception& e) {
+        fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+
+static SimResult
+runSimulation(const Pattern& pattern, const SimOptions& options)
+{
+    float width = HeadlessStyle::areaWidth;
+    float height = HeadlessStyle::areaHeight;
+    HeadlessPattern emitter(&pattern, options.x, options.y, options.player, options.seed);
+    BulletSimulation simulation;
+    simulation.setArea(0, 0, width, height);
+    simulation.setViewport(0, 0, width, height);
+    simulation.setPlayerCategory(BENCH_PLAYER_CATEGORY);
+    const BulletField& field = simulation.getField();
+
+    //命中检测只对目标一方，子弹命中后移除，与游戏中相同
+    float box[4];
+    if (options.player) {
+        box[0] = options.targetX - SIM_ENEMY_HALF_SIZE;
+        box[1] = options.targetY - SIM_ENEMY_HALF_SIZE;
+        box[2] = options.targetX + SIM_ENEMY_HALF_SIZE;
+        box[3] = options.targetY + SIM_ENEMY_HALF_SIZE;
+    } else {
+        box[0] = options.targetX - SIM_PLAYER_HALF_WIDTH;
+        box[1] = options.targetY - SIM_PLAYER_HALF_HEIGHT;
+        box[2] = options.targetX + SIM_PLAYER_HALF_WIDTH;
+        box[3] = options.targetY + SIM_PLAYER_HALF_HEIGHT;
+    }
+    uint32_t category = options.player ? BENCH_ENEMY_CATEGORY : BENCH_PLAYER_CATEGORY;
+
+    SimResult result = SimResult();
+    result.finishedAt = -1;
+    result.columns = (int)ceilf(width / options.cell);
+    result.rows = (int)ceilf(height / options.cell);
+    result.heat.assign(result.columns * result.rows, 0);
+
+    int steps = (int)ceilf(options.seconds / options.dt);
+    double totalNs = 0;
+    long long liveSum = 0;
+    int lastSpawned = 0;
+
+    for (int s = 0; s < steps; s++) {
+        float time = s * options.dt;
+        auto start = std::chrono::steady_clock::now();
+
+        emitter.update(options.dt, simulation, options.targetX, options.targetY);
+        simulation.clearTargets();
+        simulation.addTarget(options.targetX, options.targetY, category, box, box);
+        simulation.update(options.dt);
+        result.hits += (long long)simulation.getHits().size();
+        simulation.removeDead();
+
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        totalNs += ns;
+        result.peakUs = std::max(result.peakUs, ns / 1000);
+
+        //统计与热图不计入耗时
+        int live = field.size();
+        liveSum += live;
+        if (live > result.peakLive) {
+            result.peakLive = live;
+            result.peakLiveAt = time;
+        }
+        int spawned = emitter.getSpawned();
+        if (spawned - lastSpawned > result.peakSpawns) {
+            result.peakSpawns = spawned - lastSpawned;
+            result.peakSpawnsAt = time;
+        }
+        lastSpawned = spawned;
+        result.peakBeams = std::max(result.peakBeams, (int)simulation.getBeams().size());
+        if (options.budget > 0 && live > options.budget) {
+            result.overBudget++;
+        }
+        for (int i = 0; i < live; i++) {
+            int column = (int)floorf(field.posX[i] / options.cell);
+            int row = (int)floorf(field.posY[i] / options.cell);
+            if (column >= 0 && column < result.columns && row >= 0 && row < result.rows) {
+                result.heat[row * result.columns + column] += 1;
+            }
+        }
+
+        result.frames = s + 1;
+        if (emitter.isFinished() && live == 0) {
+            result.finishedAt = time + options.dt;
+            break;
+        }
+    }
+
+    result.simulated = result.frames * options.dt;
+    result.spawned = emitter.getSpawned();
+    result.avgUs = totalNs / result.frames / 1000;
+    result.nsPerBullet = liveSum > 0 ? totalNs / liveSum : 0;
+    return result;
+}
+
+/* 每格为平均每帧的子弹数，首行为画面顶部 */
+static bool
+writeHeatmap(const SimResult& result, const std::string& file)
+{
+    FILE* out = fopen(file.c_str(), "w");
+    if (nullptr == out) {
+        fprintf(stderr, "cannot write %s\n", file.c_str());
+        return false;
+    }
+    for (int row = result.rows - 1; row >= 0; row--) {
+        for (int column = 0; column < result.columns; column++) {
+            double value = result.heat[row * result.columns + column] / result.frames;
+            fprintf(out, column == 0 ? "%.3f" : ",%.3f", value);
+        }
+        fprintf(out, "\n");
+    }
+    fclose(out);
+    return true;
+}
+
+int
+main(int argc, char** argv)
+{
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    json patternsJson;
+    json spellCardsJson;
+    if (!readJson(options.patternsFile, patternsJson) ||
+        !readJson(options.spellCardsFile, spellCardsJson)) {
+        return 2;
+    }
+
+    //纹理帧不在工具中校验；掩码取基准的种别，只用于区分命中的一方
+    PatternCompileOptions compileOptions;
+    compileOptions.bulletCategory = 0;
+    compileOptions.playerCategory = BENCH_PLAYER_CATEGORY;
+    compileOptions.enemyCategory = BENCH_ENEMY_CATEGORY;
+    std::map<std::string, Pattern> patterns;
+    std::vector<std::string> errors;
+    compileGameData(patternsJson, spellCardsJson, compileOptions, patterns, errors);
+    for (auto& error : errors) {
+        fprintf(stderr, "%s\n", error.c_str());
+    }
+
+    if (options.list) {
+        for (auto& p : patterns) {
+            printf("%s\n", p.first.c_str());
+        }
+        return errors.empty() ? 0 : 1;
+    }
+
+    auto it = patterns.find(options.tag);
+    if (it == patterns.end()) {
+        fprintf(stderr, "unknown or invalid pattern %s\n", options.tag.c_str());
+        return 1;
+    }
+    if (options.threads >= 0) {
+        JobSystem::getInstance()->setThreadCount(options.threads);
+    }
+
+    SimResult result = runSimulation(it->second, options);
+
+    printf("pattern:              %s (%s)\n", options.tag.c_str(),
+           options.player ? "player" : "enemy");
+    printf("emitter:              %.0f,%.0f -> target %.0f,%.0f\n", options.x, options.y,
+           options.targetX, options.targetY);
+    if (result.finishedAt >= 0) {
+        printf("simulated:            %.2f s at dt %.5f, finished at %.2f s\n", result.simulated,
+               options.dt, result.finishedAt);
+    } else {
+        printf("simulated:            %.2f s at dt %.5f, still running\n", result.simulated,
+               options.dt);
+    }
+    printf("spawned:              %lld bullets, %.1f /s\n", result.spawned,
+           result.spawned / result.simulated);
+    printf("peak live bullets:    %d at %.2f s\n", result.peakLive, result.peakLiveAt);
+    printf("peak spawns/frame:    %d at %.2f s\n", result.peakSpawns, result.peakSpawnsAt);
+    printf("peak laser beams:     %d\n", result.peakBeams);
+    printf("hits on target:       %lld\n", result.hits);
+    printf("frame cost:           %.1f us avg, %.1f us peak, %.2f ns/bullet\n", result.avgUs,
+           result.peakUs, result.nsPerBullet);
+    if (options.budget > 0) {
+        printf("over budget:          %d of %d frames (budget %d)\n", result.overBudget,
+               result.frames, options.budget);
+    }
+
+    if (!options.csvFile.empty()) {
+        if (!writeHeatmap(result, options.csvFile)) {
+            return 2;
+        }
+        int hottest = (int)(std::max_element(result.heat.begin(), result.heat.end()) -
+                            result.heat.begin());
+        printf("heatmap:              %s, %dx%d cells of %.0f px, densest cell %d,%d "
+               "(%.2f bullets/frame)\n",
+               options.csvFile.c_str(), result.columns, result.rows, options.cell,
+               hottest % result.columns, result.rows - 1 - hottest / result.columns,
+               result.heat[hottest] / result.frames);
+    }
+    return 0;
+}